@@ -10,7 +10,9 @@ Purpose:	Contains the main scene and applications classes for the Actias
 #define ACTIASFW_ACTIASFW_H
 
 #include "Audio.h"
+#include "Capture.h"
 #include "Logging.h"
+#include "Particles.h"
 #include "UIComponents.h"
 #include "Windowing.h"
 
@@ -126,6 +128,16 @@ namespace ActiasFW {
 				unsigned int targetUpdatesPerSecond = 60;
 				// The maximum number of logic updates per frame of the window
 				unsigned int maximumUpdatesPerFrame = 10;
+				// Whether to draw to an offscreen framebuffer with a
+				// surfaceless context instead of opening a visible window, so
+				// the application runs without a display
+				bool headless = false;
+				// The number of frames drawn before the application closes (0
+				// to run until the window is closed)
+				unsigned int frameLimit = 0;
+				// The directory each drawn frame is saved to as a PNG image
+				// (empty to disable)
+				std::string frameDumpDirectory = "";
 			} window;
 			// The audio configuration structure for ActiasFW applications
 			struct Audio {
@@ -138,6 +150,21 @@ namespace ActiasFW {
 			struct Graphics {
 				// The background color of the window
 				glm::vec3 backgroundColor = glm::vec3(0.0f, 0.0f, 0.0f);
+				// The size in bytes of the buffer sprite vertices are streamed
+				// to OpenGL through each frame
+				size_t streamBufferSize = 16 * 1024 * 1024;
+				// The width and height in pixels of the texture atlas pages
+				// small textures are packed into (0 to disable the atlas)
+				int atlasPageSize = 2048;
+				// The number of bytes of decoded texture data uploaded to
+				// OpenGL each frame while textures load in the background
+				size_t textureUploadBudget = 4 * 1024 * 1024;
+				// The directory linked shader program binaries are saved to
+				// for faster startups (empty to disable)
+				std::string shaderCacheDirectory = "";
+				// The number of text layouts kept so text submitted unchanged
+				// in later frames is not laid out again
+				size_t textCacheSize = 256;
 			} graphics;
 			// The initial scene to set in the application
 			Scene& initialScene;
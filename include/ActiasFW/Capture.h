@@ -0,0 +1,574 @@
+/*
+File:		Capture.h
+Author:		Keegan MacDonald (keeganm742@gmail.com)
+Created:	2026.10.17@17:20
+Purpose:	Contains a binary trace of the work submitted to the graphics
+			manager in a run of frames, so the frames can be drawn again
+			outside the application that submitted them
+*/
+
+#ifndef ACTIASFW_CAPTURE_H
+#define ACTIASFW_CAPTURE_H
+
+#include "Graphics.h"
+
+#include <cstdint>
+#include <fstream>
+#include <map>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+namespace ActiasFW {
+	// The sprites, text, meshes, static batches, shaders, and cameras
+	// submitted to the graphics manager in a run of frames, recorded as they
+	// reach GraphicsManager::end and saved to a compact binary file in which
+	// every string is stored once, work submitted into render targets is not
+	// recorded
+	class FrameTrace {
+	public:
+		// The version of the trace file format written and read by this build
+		static const unsigned int Version = 2;
+		// The index of a string not in the trace
+		static const unsigned int NoString = 0xFFFFFFFF;
+
+		// The shaders built in to the graphics manager, which are not
+		// compiled again from the trace when replayed
+		enum BuiltInShader {
+			BUILT_IN_NONE,
+			BUILT_IN_DEFAULT,
+			BUILT_IN_DEFAULT_INSTANCED,
+		};
+
+		// A shader drawn with in the trace
+		struct ShaderRecord {
+			// Which built in shader this is, if any
+			BuiltInShader builtIn = BUILT_IN_NONE;
+			// The string index of the vertex shader source code
+			unsigned int vertexShaderSource = NoString;
+			// The string index of the fragment shader source code
+			unsigned int fragmentShaderSource = NoString;
+			// The layout of the vertices drawn by the shader
+			VertexLayout vertexLayout;
+			// Whether the shader draws sprites as instances
+			bool instanced = false;
+			// The number of texture units the shader selects between
+			unsigned int textureUnitCount = 1;
+			// The string index of the texture sampler array uniform name
+			unsigned int textureSamplerUniformName = NoString;
+			// The string index of the camera matrix uniform name
+			unsigned int cameraUniformName = NoString;
+			// The index of the shader's camera in the trace
+			unsigned int camera = 0;
+		};
+		// A font drawn in the trace and how its glyphs were rasterized
+		struct FontRecord {
+			// The string index of the font's file name
+			unsigned int fileName = NoString;
+			// How the font's glyphs were rasterized
+			Font::Rendering rendering = Font::RENDERING_BITMAP;
+		};
+		// A camera drawn through in the trace
+		struct CameraRecord {
+			// Whether the camera is the graphics manager's default camera
+			bool defaultCamera = false;
+		};
+		// The state of a camera in one frame of the trace
+		struct CameraState {
+			// The index of the camera in the trace
+			unsigned int camera = 0;
+			// The position of the camera
+			glm::vec3 position = glm::vec3();
+			// The scale of the camera
+			float scale = 1.0f;
+		};
+		// A sprite submitted in the trace
+		struct SpriteRecord {
+			// The index of the shader the sprite was submitted with
+			unsigned int shader = 0;
+			// The string index of the sprite's texture file name
+			unsigned int texture = NoString;
+			// The position and depth of the sprite
+			glm::vec3 position = glm::vec3();
+			// The width and height of the sprite
+			glm::vec2 dimensions = glm::vec2();
+			// The rotation of the sprite in degrees
+			float rotation = 0.0f;
+			// The texture coordinates of the sprite (x, y, width, height)
+			glm::vec4 textureBox = glm::vec4();
+			// The RGBA color of the sprite
+			glm::vec4 color = glm::vec4();
+			// The mode the fragment shader draws the sprite in
+			float mode = 0.0f;
+			// Whether the sprite's image is reflected horizontally
+			bool reflectedHorizontally = false;
+			// Whether the sprite's image is reflected vertically
+			bool reflectedVertically = false;
+		};
+		// Text submitted by string or as a text mesh in the trace
+		struct TextRecord {
+			// The index of the shader the text was submitted with
+			unsigned int shader = 0;
+			// The string index of the text
+			unsigned int text = NoString;
+			// The string index of the font's file name
+			unsigned int font = NoString;
+			// The position and depth of the text
+			glm::vec3 position = glm::vec3();
+			// The bounding box of the text (x, y, width, height)
+			glm::vec4 box = glm::vec4();
+			// The scale of the text
+			float scale = 1.0f;
+			// The color of the text (RGBA)
+			glm::vec4 color = glm::vec4();
+			// The horizontal alignment of the text inside its box
+			Alignment horizontalAlignment = NO_ALIGNMENT;
+			// The vertical alignment of the text inside its box
+			Alignment verticalAlignment = NO_ALIGNMENT;
+		};
+		// A mesh of custom vertices submitted in the trace
+		struct MeshRecord {
+			// The index of the shader the mesh was submitted with
+			unsigned int shader = 0;
+			// The string index of the mesh's texture file name
+			unsigned int texture = NoString;
+			// The depth of the mesh
+			float depth = 0.0f;
+			// The bytes of the mesh's vertices
+			std::vector<unsigned char> vertices;
+			// The indices of the mesh's triangles
+			std::vector<unsigned int> indices;
+		};
+		// The sprites of a static batch as they were when it was baked, a batch
+		// baked again in a later frame is recorded again, tile maps are
+		// recorded as batches of one sprite per tile
+		struct BatchRecord {
+			// The index of the shader the batch is drawn with
+			unsigned int shader = 0;
+			// The sprites of the batch
+			std::vector<SpriteRecord> sprites;
+		};
+		// The work submitted in one frame of the trace
+		struct Frame {
+			// The state of every camera drawn through in the frame
+			std::vector<CameraState> cameras;
+			// The sprites submitted in the frame
+			std::vector<SpriteRecord> sprites;
+			// The text submitted by string in the frame
+			std::vector<TextRecord> text;
+			// The indices of the text meshes submitted in the frame
+			std::vector<unsigned int> textMeshes;
+			// The indices of the static batches submitted in the frame
+			std::vector<unsigned int> batches;
+			// The meshes submitted in the frame
+			std::vector<MeshRecord> meshes;
+		};
+
+		/*
+		Clear this trace and record the work submitted in a number of frames
+		from the next frame drawn, saving it to a file after the last
+		Parameter: const std::string& fileName - The file to save the trace to
+		Parameter: unsigned int frameCount - The number of frames to record
+		*/
+		void start(const std::string&, unsigned int);
+		/*
+		Test whether this trace is recording frames
+		Returns: bool - Whether frames remain to be recorded
+		*/
+		bool isRecording() const;
+		/*
+		Start recording a frame, recording the window's dimensions with the
+		first
+		*/
+		void beginFrame();
+		/*
+		Record a sprite submitted this frame
+		Parameter: const Sprite& sprite - The sprite
+		Parameter: GLSLShader& shader - The shader it was submitted with
+		*/
+		void recordSprite(const Sprite&, GLSLShader&);
+		/*
+		Record text submitted by string this frame
+		Parameter: const std::string& text - The text
+		Parameter: const glm::vec3& position - The position and depth of the
+		text
+		Parameter: const glm::vec4& box - The bounding box of the text
+		Parameter: float scale - The scale of the text
+		Parameter: const glm::vec4& color - The color of the text (RGBA)
+		Parameter: const std::string& fontFileName - The font of the text
+		Parameter: Alignment horizontalAlignment - The horizontal alignment
+		Parameter: Alignment verticalAlignment - The vertical alignment
+		Parameter: GLSLShader& shader - The shader it was submitted with
+		*/
+		void recordText(const std::string&, const glm::vec3&, const glm::vec4&,
+			float, const glm::vec4&, const std::string&, Alignment, Alignment,
+			GLSLShader&);
+		/*
+		Record a text mesh submitted this frame, recording its text again if it
+		changed since it was last recorded
+		Parameter: const TextMesh& mesh - The text mesh
+		Parameter: GLSLShader& shader - The shader it was submitted with
+		*/
+		void recordTextMesh(const TextMesh&, GLSLShader&);
+		/*
+		Record a static batch submitted this frame, recording its sprites again
+		if it will be baked again
+		Parameter: StaticBatch& batch - The static batch
+		*/
+		void recordBatch(StaticBatch&);
+		/*
+		Record a tile map submitted this frame as a static batch of one sprite
+		per tile, recording its tiles again if they changed since it was last
+		recorded
+		Parameter: TileMap& map - The tile map
+		*/
+		void recordTileMap(TileMap&);
+		/*
+		Record the live particles of a particle system submitted this frame as
+		one sprite each, particles simulated on the GPU are never read back so
+		none are recorded
+		Parameter: ParticleSystem& particles - The particle system
+		*/
+		void recordParticles(ParticleSystem&);
+		/*
+		Record a mesh of custom vertices submitted this frame
+		Parameter: const unsigned char* vertices - The bytes of the vertices
+		Parameter: size_t vertexBytes - The number of bytes of vertices
+		Parameter: const unsigned int* indices - The indices of the triangles
+		Parameter: size_t indexCount - The number of indices
+		Parameter: float depth - The depth of the mesh
+		Parameter: const std::string& textureFileName - The mesh's texture
+		Parameter: GLSLShader& shader - The shader it was submitted with
+		*/
+		void recordMesh(const unsigned char*, size_t, const unsigned int*,
+			size_t, float, const std::string&, GLSLShader&);
+		/*
+		Finish recording a frame, saving this trace and stopping recording if
+		it was the last
+		*/
+		void endFrame();
+		/*
+		Write this trace to a binary file
+		Parameter: const std::string& fileName - The file to write
+		Returns: bool - Whether the file was written
+		*/
+		bool save(const std::string&) const;
+		/*
+		Replace this trace with one read from a binary file
+		Parameter: const std::string& fileName - The file to read
+		Returns: bool - Whether the file was a complete trace of this version
+		*/
+		bool load(const std::string&);
+		/*
+		Free this trace's memory and stop recording
+		*/
+		void clear();
+		/*
+		Get the dimensions of the window the trace was recorded in
+		Returns: const glm::ivec2& - The window's dimensions in pixels
+		*/
+		const glm::ivec2& getWindowDimensions() const;
+		/*
+		Get a string stored in this trace
+		Parameter: unsigned int index - The string's index
+		Returns: const std::string& - The string, or an empty string for
+		NoString
+		*/
+		const std::string& getString(unsigned int) const;
+		/*
+		Get the shaders drawn with in this trace
+		Returns: const std::vector<ShaderRecord>& - The shaders by index
+		*/
+		const std::vector<ShaderRecord>& getShaders() const;
+		/*
+		Get the fonts drawn in this trace
+		Returns: const std::vector<FontRecord>& - The fonts
+		*/
+		const std::vector<FontRecord>& getFonts() const;
+		/*
+		Get the cameras drawn through in this trace
+		Returns: const std::vector<CameraRecord>& - The cameras by index
+		*/
+		const std::vector<CameraRecord>& getCameras() const;
+		/*
+		Get the text meshes drawn in this trace, one per layout
+		Returns: const std::vector<TextRecord>& - The text meshes by index
+		*/
+		const std::vector<TextRecord>& getTextMeshes() const;
+		/*
+		Get the static batches drawn in this trace, one per bake
+		Returns: const std::vector<BatchRecord>& - The static batches by index
+		*/
+		const std::vector<BatchRecord>& getBatches() const;
+		/*
+		Get the frames of this trace
+		Returns: const std::vector<Frame>& - The frames in the order drawn
+		*/
+		const std::vector<Frame>& getFrames() const;
+
+	private:
+		// The number of bytes a font record is written in, every record is
+		// written field by field so no padding is saved
+		static const size_t FontRecordBytes = 8;
+		// The number of bytes a camera state is written in
+		static const size_t CameraStateBytes = 20;
+		// The number of bytes a sprite record is written in
+		static const size_t SpriteRecordBytes = 70;
+		// The number of bytes a text record is written in
+		static const size_t TextRecordBytes = 68;
+		// The number of bytes a vertex attribute is written in
+		static const size_t VertexAttributeBytes = 13;
+		// The fewest bytes a string is written in
+		static const size_t StringBytes = 4;
+		// The number of bytes a camera record is written in
+		static const size_t CameraRecordBytes = 1;
+		// The fewest bytes a shader record is written in
+		static const size_t ShaderRecordBytes = 37;
+		// The fewest bytes a static batch record is written in
+		static const size_t BatchRecordBytes = 8;
+		// The fewest bytes a frame is written in
+		static const size_t FrameBytes = 24;
+		// The fewest bytes a mesh record is written in
+		static const size_t MeshRecordBytes = 20;
+
+		// The dimensions of the window the trace was recorded in
+		glm::ivec2 m_windowDimensions = glm::ivec2();
+		// The strings of the trace, each stored once
+		std::vector<std::string> m_strings;
+		// The shaders of the trace
+		std::vector<ShaderRecord> m_shaders;
+		// The fonts of the trace
+		std::vector<FontRecord> m_fonts;
+		// The cameras of the trace
+		std::vector<CameraRecord> m_cameras;
+		// The text meshes of the trace
+		std::vector<TextRecord> m_textMeshes;
+		// The static batches of the trace
+		std::vector<BatchRecord> m_batches;
+		// The frames of the trace
+		std::vector<Frame> m_frames;
+		// The file the trace is saved to once recorded
+		std::string m_fileName = "";
+		// The number of frames left to record
+		unsigned int m_remainingFrames = 0;
+		// The indices of the recorded strings by value
+		std::map<std::string, unsigned int> m_stringIndices;
+		// The indices of the recorded shaders by address
+		std::map<const GLSLShader*, unsigned int> m_shaderIndices;
+		// The indices of the recorded cameras by address
+		std::map<const Camera*, unsigned int> m_cameraIndices;
+		// The indices of the last recorded layout of each text mesh
+		std::map<const TextMesh*, unsigned int> m_textMeshIndices;
+		// The indices of the last recorded bake of each static batch
+		std::map<const StaticBatch*, unsigned int> m_batchIndices;
+		// The batch indices and revisions of the last recorded tiles of each
+		// tile map
+		std::map<const TileMap*, std::pair<unsigned int, unsigned int>>
+			m_tileMapIndices;
+
+		/*
+		Get the index of a string, storing it if it is not stored yet
+		Parameter: const std::string& value - The string
+		Returns: unsigned int - The string's index
+		*/
+		unsigned int recordString(const std::string&);
+		/*
+		Get the string index of a font's file name, recording how the font is
+		rasterized if it has not been recorded
+		Parameter: const std::string& fileName - The font's file name
+		Returns: unsigned int - The string index of the file name
+		*/
+		unsigned int recordFont(const std::string&);
+		/*
+		Get the index of a shader, recording it if it has not been, and record
+		its camera's state in the current frame if it has not been
+		Parameter: GLSLShader& shader - The shader
+		Returns: unsigned int - The shader's index
+		*/
+		unsigned int recordShader(GLSLShader&);
+		/*
+		Build the record of a sprite
+		Parameter: const Sprite& sprite - The sprite
+		Parameter: unsigned int shader - The index of its shader
+		Returns: SpriteRecord - The sprite's record
+		*/
+		SpriteRecord makeSpriteRecord(const Sprite&, unsigned int);
+		/*
+		Test whether every index stored in this trace refers to a string,
+		shader, camera, text mesh, or static batch in it
+		Returns: bool - Whether this trace's indices are valid
+		*/
+		bool validate() const;
+		/*
+		Write a value's bytes to a stream
+		Parameter: std::ostream& stream - The stream to write to
+		Parameter: const T& value - The value to write, a number or a vector of
+		numbers
+		*/
+		template <typename T>
+		static void Write(std::ostream& stream, const T& value) {
+			static_assert(std::is_trivially_copyable<T>::value);
+			stream.write((const char*)&value, sizeof(T));
+		}
+		/*
+		Write the size of an array of numbers then their bytes to a stream
+		Parameter: std::ostream& stream - The stream to write to
+		Parameter: const std::vector<T>& values - The numbers to write
+		*/
+		template <typename T>
+		static void WriteArray(std::ostream& stream,
+			const std::vector<T>& values) {
+			static_assert(std::is_arithmetic<T>::value);
+			Write(stream, (std::uint32_t)values.size());
+			stream.write((const char*)values.data(), values.size() * sizeof(T));
+		}
+		/*
+		Write the size of an array of records then each record field by field
+		to a stream
+		Parameter: std::ostream& stream - The stream to write to
+		Parameter: const std::vector<T>& records - The records to write
+		*/
+		template <typename T>
+		static void WriteRecords(std::ostream& stream,
+			const std::vector<T>& records) {
+			Write(stream, (std::uint32_t)records.size());
+			for (const T& record : records) {
+				WriteRecord(stream, record);
+			}
+		}
+		/*
+		Write a record to a stream field by field
+		Parameter: std::ostream& stream - The stream to write to
+		Parameter: const FontRecord& record - The record to write
+		*/
+		static void WriteRecord(std::ostream&, const FontRecord&);
+		/*
+		Write a record to a stream field by field
+		Parameter: std::ostream& stream - The stream to write to
+		Parameter: const CameraState& record - The record to write
+		*/
+		static void WriteRecord(std::ostream&, const CameraState&);
+		/*
+		Write a record to a stream field by field
+		Parameter: std::ostream& stream - The stream to write to
+		Parameter: const SpriteRecord& record - The record to write
+		*/
+		static void WriteRecord(std::ostream&, const SpriteRecord&);
+		/*
+		Write a record to a stream field by field
+		Parameter: std::ostream& stream - The stream to write to
+		Parameter: const TextRecord& record - The record to write
+		*/
+		static void WriteRecord(std::ostream&, const TextRecord&);
+		/*
+		Write a vertex attribute to a stream field by field
+		Parameter: std::ostream& stream - The stream to write to
+		Parameter: const VertexAttribute& record - The attribute to write
+		*/
+		static void WriteRecord(std::ostream&, const VertexAttribute&);
+		/*
+		Read a value's bytes from a stream
+		Parameter: std::istream& stream - The stream to read from
+		Parameter: T& value - The value to read into, a number or a vector of
+		numbers
+		Returns: bool - Whether the value was read
+		*/
+		template <typename T>
+		static bool Read(std::istream& stream, T& value) {
+			static_assert(std::is_trivially_copyable<T>::value);
+			return (bool)stream.read((char*)&value, sizeof(T));
+		}
+		/*
+		Read the size of an array from a stream, testing whether that many
+		elements fit in the rest of the stream
+		Parameter: std::istream& stream - The stream to read from
+		Parameter: std::streamoff end - The offset of the end of the stream
+		Parameter: size_t elementBytes - The fewest bytes each element is
+		written in
+		Parameter: std::uint32_t& count - The size to read into
+		Returns: bool - Whether the size was read and fits in the stream
+		*/
+		static bool ReadCount(std::istream&, std::streamoff, size_t,
+			std::uint32_t&);
+		/*
+		Read an array of numbers written by WriteArray from a stream
+		Parameter: std::istream& stream - The stream to read from
+		Parameter: std::streamoff end - The offset of the end of the stream
+		Parameter: std::vector<T>& values - The array to read into
+		Returns: bool - Whether the array was read
+		*/
+		template <typename T>
+		static bool ReadArray(std::istream& stream, std::streamoff end,
+			std::vector<T>& values) {
+			static_assert(std::is_arithmetic<T>::value);
+			std::uint32_t size = 0;
+			if (!ReadCount(stream, end, sizeof(T), size)) {
+				return false;
+			}
+			values.resize(size);
+			return (bool)stream.read((char*)values.data(),
+				values.size() * sizeof(T));
+		}
+		/*
+		Read an array of records written by WriteRecords from a stream
+		Parameter: std::istream& stream - The stream to read from
+		Parameter: std::streamoff end - The offset of the end of the stream
+		Parameter: size_t recordBytes - The number of bytes each record is
+		written in
+		Parameter: std::vector<T>& records - The array to read into
+		Returns: bool - Whether the array was read and every record was valid
+		*/
+		template <typename T>
+		static bool ReadRecords(std::istream& stream, std::streamoff end,
+			size_t recordBytes, std::vector<T>& records) {
+			std::uint32_t size = 0;
+			if (!ReadCount(stream, end, recordBytes, size)) {
+				return false;
+			}
+			records.resize(size);
+			for (T& record : records) {
+				if (!ReadRecord(stream, record)) {
+					return false;
+				}
+			}
+			return true;
+		}
+		/*
+		Read a record written by WriteRecord from a stream
+		Parameter: std::istream& stream - The stream to read from
+		Parameter: FontRecord& record - The record to read into
+		Returns: bool - Whether the record was read and is valid
+		*/
+		static bool ReadRecord(std::istream&, FontRecord&);
+		/*
+		Read a record written by WriteRecord from a stream
+		Parameter: std::istream& stream - The stream to read from
+		Parameter: CameraState& record - The record to read into
+		Returns: bool - Whether the record was read
+		*/
+		static bool ReadRecord(std::istream&, CameraState&);
+		/*
+		Read a record written by WriteRecord from a stream
+		Parameter: std::istream& stream - The stream to read from
+		Parameter: SpriteRecord& record - The record to read into
+		Returns: bool - Whether the record was read
+		*/
+		static bool ReadRecord(std::istream&, SpriteRecord&);
+		/*
+		Read a record written by WriteRecord from a stream
+		Parameter: std::istream& stream - The stream to read from
+		Parameter: TextRecord& record - The record to read into
+		Returns: bool - Whether the record was read and is valid
+		*/
+		static bool ReadRecord(std::istream&, TextRecord&);
+		/*
+		Read a vertex attribute written by WriteRecord from a stream
+		Parameter: std::istream& stream - The stream to read from
+		Parameter: VertexAttribute& record - The attribute to read into
+		Returns: bool - Whether the attribute was read
+		*/
+		static bool ReadRecord(std::istream&, VertexAttribute&);
+	};
+}
+
+#endif
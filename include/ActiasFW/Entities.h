@@ -9,8 +9,11 @@ Purpose:	Contains classes representing abstract, static, and animated
 #ifndef ACTIASFW_ENTITIES_H
 #define ACTIASFW_ENTITIES_H
 
+#include "QuadKernel.h"
+
 #include <glm/glm.hpp>
 
+#include <map>
 #include <string>
 #include <vector>
 
@@ -67,6 +70,10 @@ namespace ActiasFW {
 	// An abstract 2D sprite with a position, velocity, depth, and texture
 	class Sprite : public Entity {
 	public:
+		// The number of floats in each vertex populated by a sprite (position,
+		// texture coordinates, color, and mode)
+		static const unsigned int VertexSize = 10;
+
 		/*
 		Initialize this sprite's memory
 		Parameter: const glm::vec3& position - The position and depth of this
@@ -192,6 +199,7 @@ namespace ActiasFW {
 
 	protected:
 		friend class GraphicsManager;
+		friend class FrameTrace;
 		// The width and height of this sprite
 		glm::vec2 m_dimensions = glm::vec2();
 		// The current rotation angle of this sprite in degrees
@@ -218,20 +226,13 @@ namespace ActiasFW {
 		texture, rotation, reflections, and color
 		*/
 		virtual void draw();
-
-	private:
-		/*
-		Rotate a point about this sprite's center
-		Parameter: const glm::vec3& p - The point to rotate
-		Returns: glm::vec3 - The rotated point
-		*/
-		glm::vec3 rotate(const glm::vec3&) const;
 		/*
-		Swap two indices of this sprite's vertex data
-		Parameter: size_t a - The first index to swap
-		Parameter: size_t b - The second index to swap
+		Get the mode the fragment shader draws this sprite in (0 for textured,
+		1 for colored, 2 for text, 3 for signed distance field text, 4 for
+		render targets)
+		Returns: float - This sprite's draw mode
 		*/
-		void transposeVertices(size_t, size_t);
+		virtual float getDrawMode() const;
 	};
 
 	// An abstract animated 2D sprite
@@ -253,6 +254,23 @@ namespace ActiasFW {
 		void initialize(const glm::vec3&, const glm::vec2&, const std::string&,
 			const glm::ivec2&, float);
 		/*
+		Initialize this animation's memory with frames of arbitrary size and
+		position in its texture
+		Parameter: const glm::vec3& position - The position and depth of this
+		animation
+		Parameter: const glm::vec2& dimensions - The width and height of this
+		animation
+		Parameter: const std::string& textureFileName - The file name of this
+		animation's texture
+		Parameter: const std::vector<glm::vec4>& frames - The texture
+		coordinates of each frame of this animation in order (x, y, width,
+		height)
+		Parameter: float frameTime - The number of updates to play each frame
+		of this animation for
+		*/
+		void initialize(const glm::vec3&, const glm::vec2&, const std::string&,
+			const std::vector<glm::vec4>&, float);
+		/*
 		Update this sprite's position by its velocity, its rotation, and the
 		animation frame
 		Parameter: float timeStep - The number of frames elapsed since the last
@@ -303,8 +321,9 @@ namespace ActiasFW {
 		virtual bool isPlaying() const;
 
 	protected:
-		// The texture coordinates of the frames of this animation
-		std::vector<glm::vec2> m_frameCoordinates;
+		// The texture coordinates of the frames of this animation (x, y, width,
+		// height)
+		std::vector<glm::vec4> m_frameCoordinates;
 		// The current frame of this animation
 		unsigned int m_currentFrame = 0;
 		// The number of frames to play each frame of this animation for
@@ -356,27 +375,113 @@ namespace ActiasFW {
 		glm::ivec2 m_bearing = glm::ivec2();
 		// This glyph's horizontal offset
 		unsigned int m_offset = 0;
+		// The mode the fragment shader draws this glyph in, which depends on
+		// how its font was rasterized
+		float m_drawMode = 2.0f;
 
 		/*
-		Populate this glyph's indices and vertices for OpenGL to draw
+		Get the mode the fragment shader draws this glyph in
+		Returns: float - The text draw mode of this glyph's font
 		*/
-		void draw() override;
+		float getDrawMode() const override;
 	};
 
-	// A set of glyphs associated with text characters
+	// The metrics and texture coordinates of a single text character in a
+	// font, stored by value so that text can be laid out without allocating
+	struct GlyphMetrics {
+		// The width and height of the glyph's image
+		glm::vec2 dimensions = glm::vec2();
+		// The glyph's horizontal and vertical bearings
+		glm::ivec2 bearing = glm::ivec2();
+		// The horizontal distance to the next glyph
+		unsigned int offset = 0;
+		// The position in pixels of the glyph's image in its font's texture
+		glm::ivec2 imagePosition = glm::ivec2();
+		// The width and height in pixels of the glyph's image
+		glm::ivec2 imageDimensions = glm::ivec2();
+		// The page of its font's texture holding the glyph's image, or -1 if
+		// the image has not been rasterized or was cleared
+		int page = -1;
+		// Whether the glyph has been added to its font
+		bool loaded = false;
+	};
+
+	// A set of glyph metrics indexed by Unicode codepoint, added as each
+	// codepoint is first drawn, and the texture their images are drawn from
 	class Font {
 	public:
+		// The ways a font's glyphs can be rasterized into its texture
+		enum Rendering {
+			// Coverage bitmaps at the size text is laid out at, which blur
+			// when scaled up
+			RENDERING_BITMAP,
+			// Signed distance fields at a smaller size, which stay sharp at
+			// any scale
+			RENDERING_SDF,
+		};
+
+		// The number of codepoints a font has a dense table entry for, higher
+		// codepoints are looked up by tree
+		static const unsigned int CharacterCount = 256;
+
+		/*
+		Get the metrics of a codepoint's glyph in this font
+		Parameter: char32_t codepoint - The codepoint to get
+		Returns: const GlyphMetrics& - The glyph's metrics, which are empty and
+		not loaded if the glyph has not been added
+		*/
+		const GlyphMetrics& getGlyph(char32_t) const;
+		/*
+		Test whether a codepoint's glyph has been added to this font
+		Parameter: char32_t codepoint - The codepoint to test
+		Returns: bool - Whether the glyph has been added
+		*/
+		bool hasGlyph(char32_t) const;
+		/*
+		Add a glyph to this font by its codepoint, ASCII glyphs also set this
+		font's vertical bearings so that later glyphs do not move laid out
+		text
+		Parameter: char32_t codepoint - The codepoint to add
+		Parameter: const GlyphMetrics& glyph - The metrics of the glyph to add
+		*/
+		void addGlyph(char32_t, const GlyphMetrics&);
+		/*
+		Get the name of the texture this font's glyphs are drawn from
+		Returns: const std::string& - The name of this font's texture
+		*/
+		const std::string& getTextureFileName() const;
+		/*
+		Set the name of the texture this font's glyphs are drawn from
+		Parameter: const std::string& textureFileName - The name of the texture
+		*/
+		void setTextureFileName(const std::string&);
+		/*
+		Get how this font's glyphs were rasterized
+		Returns: Rendering - This font's rendering
+		*/
+		Rendering getRendering() const;
 		/*
-		Get the set of glyphs in this font
-		Returns: const std::map<char, Glyph>& - The glyphs in this font
+		Set how this font's glyphs were rasterized
+		Parameter: Rendering rendering - This font's rendering
 		*/
-		const std::map<char, Glyph>& getGlyphs() const;
+		void setRendering(Rendering);
 		/*
-		Add a glyph to this font by its text character
-		Parameter: char character - The text character to add
-		Parameter: const Glyph& glyph - The glyph to add
+		Get the distance each glyph's image extends past its dimensions on
+		every side, holding the outside of its distance field
+		Returns: float - This font's padding
 		*/
-		void addGlyph(char, const Glyph&);
+		float getPadding() const;
+		/*
+		Set the distance each glyph's image extends past its dimensions on
+		every side
+		Parameter: float padding - This font's new padding
+		*/
+		void setPadding(float);
+		/*
+		Get the mode the fragment shader draws this font's glyphs in
+		Returns: float - The text draw mode for this font's rendering
+		*/
+		float getDrawMode() const;
 		/*
 		Get the minimum vertical bearing of the glyphs in this font
 		Returns: float - This font's minimum bearing
@@ -393,12 +498,36 @@ namespace ActiasFW {
 		void destroy();
 
 	private:
-		// The set of glyphs in this font
-		std::map<char, Glyph> m_glyphs;
+		// Allow the GraphicsManager class access to private memory
+		friend class GraphicsManager;
+
+		// The metrics returned for glyphs which have not been added
+		static const GlyphMetrics MissingGlyph;
+
+		// The metrics of this font's glyphs below CharacterCount indexed by
+		// codepoint
+		std::vector<GlyphMetrics> m_glyphs
+			= std::vector<GlyphMetrics>(CharacterCount);
+		// The metrics of this font's other glyphs by codepoint
+		std::map<char32_t, GlyphMetrics> m_extendedGlyphs;
+		// The name of the texture this font's glyphs are drawn from
+		std::string m_textureFileName = "";
+		// How this font's glyphs were rasterized
+		Rendering m_rendering = RENDERING_BITMAP;
+		// The distance each glyph's image extends past its dimensions
+		float m_padding = 0.0f;
 		// The minimum vertical bearing of the glyphs in this font
 		float m_minimumBearing = 0.0f;
 		// The maximum vertical bearing of the glyphs in this font
 		float m_maximumBearing = 0.0f;
+
+		/*
+		Find the metrics of a codepoint's glyph in this font to update them
+		Parameter: char32_t codepoint - The codepoint to find
+		Returns: GlyphMetrics* - The glyph's metrics, or 0 if the glyph has not
+		been added
+		*/
+		GlyphMetrics* findGlyph(char32_t);
 	};
 }
 
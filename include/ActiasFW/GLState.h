@@ -0,0 +1,160 @@
+/*
+File:		GLState.h
+Author:		Keegan MacDonald (keeganm742@gmail.com)
+Created:	2026.10.17@14:05
+Purpose:	Contains a cache of the OpenGL state bound by ActiasFW which skips
+			calls that would not change it
+*/
+
+#ifndef ACTIASFW_GL_STATE_H
+#define ACTIASFW_GL_STATE_H
+
+#include "OpenGL.h"
+
+namespace ActiasFW {
+	// The program, vertex array, buffers, textures, and blend state last set
+	// through this cache, so that binding what is already bound issues no
+	// OpenGL call, OpenGL calls made around this cache must be followed by
+	// invalidate()
+	class GLStateCache {
+	public:
+		// The value of a binding this cache does not know
+		static const GLuint Unknown = 0xFFFFFFFF;
+		// The number of texture units whose bindings are tracked, bindings to
+		// higher units are always issued
+		static const unsigned int TrackedTextureUnits = 16;
+
+		/*
+		Use a shader program if it is not already in use
+		Parameter: GLuint programID - The OpenGL ID of the program, or 0
+		*/
+		void useProgram(GLuint);
+		/*
+		Bind a vertex array object if it is not already bound, forgetting the
+		element array buffer bound since it is part of the vertex array
+		Parameter: GLuint vertexArrayID - The OpenGL ID of the vertex array, or
+		0
+		*/
+		void bindVertexArray(GLuint);
+		/*
+		Bind a buffer to a target if it is not already bound there
+		Parameter: GLenum target - The target to bind the buffer to
+		Parameter: GLuint bufferID - The OpenGL ID of the buffer, or 0
+		*/
+		void bindBuffer(GLenum, GLuint);
+		/*
+		Bind a range of a buffer to an indexed binding point, which also binds
+		the buffer to the target
+		Parameter: GLenum target - The indexed target to bind the buffer to
+		Parameter: GLuint index - The binding point to bind the range to
+		Parameter: GLuint bufferID - The OpenGL ID of the buffer
+		Parameter: GLintptr offset - The offset in bytes of the range
+		Parameter: GLsizeiptr size - The size in bytes of the range
+		*/
+		void bindBufferRange(GLenum, GLuint, GLuint, GLintptr, GLsizeiptr);
+		/*
+		Bind a 2D texture to a texture unit if it is not already bound there,
+		and make the unit active either way so the texture can be edited
+		Parameter: unsigned int unit - The texture unit to bind the texture to
+		Parameter: GLuint textureID - The OpenGL ID of the texture, or 0
+		*/
+		void bindTexture(unsigned int, GLuint);
+		/*
+		Set whether blending is enabled and its source and destination factors
+		if they are not already set
+		Parameter: bool enabled - Whether blending is enabled
+		Parameter: GLenum source - The factor of the source color
+		Parameter: GLenum destination - The factor of the destination color
+		*/
+		void setBlending(bool, GLenum, GLenum);
+		/*
+		Set whether blending is enabled and separate source and destination
+		factors for the color and alpha channels if they are not already set
+		Parameter: bool enabled - Whether blending is enabled
+		Parameter: GLenum source - The factor of the source color
+		Parameter: GLenum destination - The factor of the destination color
+		Parameter: GLenum alphaSource - The factor of the source alpha
+		Parameter: GLenum alphaDestination - The factor of the destination
+		alpha
+		*/
+		void setBlending(bool, GLenum, GLenum, GLenum, GLenum);
+		/*
+		Get the shader program last used through this cache
+		Returns: GLuint - The OpenGL ID of the program, or Unknown
+		*/
+		GLuint getProgram() const;
+		/*
+		Get the vertex array object last bound through this cache
+		Returns: GLuint - The OpenGL ID of the vertex array, or Unknown
+		*/
+		GLuint getVertexArray() const;
+		/*
+		Forget every binding so the next call for each is issued, after OpenGL
+		state is changed or objects are deleted without this cache
+		*/
+		void invalidate();
+		/*
+		Get the number of OpenGL calls issued since the counts were reset
+		Returns: unsigned int - The number of calls issued
+		*/
+		unsigned int getIssuedCalls() const;
+		/*
+		Get the number of OpenGL calls skipped since the counts were reset
+		because they would not have changed any state
+		Returns: unsigned int - The number of calls skipped
+		*/
+		unsigned int getSkippedCalls() const;
+		/*
+		Reset the numbers of issued and skipped calls to 0
+		*/
+		void resetCounts();
+
+	private:
+		// The buffer targets whose bindings are tracked
+		enum BufferTarget {
+			TARGET_ARRAY,
+			TARGET_ELEMENT_ARRAY,
+			TARGET_UNIFORM,
+			TARGET_PIXEL_UNPACK,
+			TARGET_DRAW_INDIRECT,
+			TARGET_COPY_READ,
+			TARGET_COPY_WRITE,
+			TARGET_COUNT,
+		};
+
+		// The program in use
+		GLuint m_program = Unknown;
+		// The vertex array bound
+		GLuint m_vertexArray = Unknown;
+		// The buffer bound to each tracked target
+		GLuint m_buffers[TARGET_COUNT] = { Unknown, Unknown, Unknown, Unknown,
+			Unknown, Unknown, Unknown };
+		// The texture bound to each tracked texture unit
+		GLuint m_textures[TrackedTextureUnits] = {};
+		// The active texture unit
+		GLuint m_activeTextureUnit = Unknown;
+		// Whether blending is enabled, or Unknown
+		GLuint m_blending = Unknown;
+		// The source blend factor
+		GLenum m_blendSource = Unknown;
+		// The destination blend factor
+		GLenum m_blendDestination = Unknown;
+		// The source blend factor of the alpha channel
+		GLenum m_blendAlphaSource = Unknown;
+		// The destination blend factor of the alpha channel
+		GLenum m_blendAlphaDestination = Unknown;
+		// The number of calls issued since the counts were reset
+		unsigned int m_issuedCalls = 0;
+		// The number of calls skipped since the counts were reset
+		unsigned int m_skippedCalls = 0;
+
+		/*
+		Get the index of a buffer target in this cache's buffer bindings
+		Parameter: GLenum target - The OpenGL buffer target
+		Returns: int - The index of the target, or -1 if it is not tracked
+		*/
+		static int GetTargetIndex(GLenum);
+	};
+}
+
+#endif
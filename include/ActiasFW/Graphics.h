@@ -10,12 +10,26 @@ Purpose:	Contains texture and font loading and OpenGL rendering utilities for
 #define ACTIASFW_GRAPHICS_H
 
 #include "Entities.h"
+#include "GLState.h"
+#include "OpenGL.h"
+#include "Threading.h"
 
-#include <GL/glew.h>
 #include <ft2build.h>
 #include <freetype/freetype.h>
+#include <glm/gtc/type_precision.hpp>
+
+#include <cstddef>
+#include <cstdint>
+#include <list>
+#include <map>
+#include <mutex>
+#include <set>
+#include <type_traits>
 
 namespace ActiasFW {
+	class FrameTrace;
+	class ParticleSystem;
+
 	// A 2D camera with position, velocity, and scale used to generate
 	// projection matrices for OpenGL
 	class Camera : public Entity {
@@ -59,6 +73,13 @@ namespace ActiasFW {
 		Returns: const glm::mat4& - This camera's projection matrix
 		*/
 		const glm::mat4& getMatrix() const;
+		/*
+		Get the rectangle of the world visible through this camera's current
+		projection matrix
+		Returns: const glm::vec4& - This camera's visible rectangle (x, y,
+		width, height)
+		*/
+		const glm::vec4& getVisibleBox() const;
 
 	private:
 		// The current scale of this camera
@@ -67,6 +88,8 @@ namespace ActiasFW {
 		float m_scaleVelocity = 0.0f;
 		// This camera's projection matrix
 		glm::mat4 m_matrix = glm::mat4();
+		// The rectangle of the world visible through the projection matrix
+		glm::vec4 m_visibleBox = glm::vec4();
 		// The position of this camera in the last update
 		glm::vec3 m_lastPosition = glm::vec3();
 		// The scale of this camera in the last update
@@ -81,11 +104,194 @@ namespace ActiasFW {
 		void updateMatrix();
 	};
 
+	// The compact per-instance record uploaded for each sprite drawn by an
+	// instanced shader, which expands it into a quad in its vertex shader
+	struct SpriteInstance {
+		// The position and depth of the sprite
+		float position[3];
+		// The width and height of the sprite
+		float dimensions[2];
+		// The rotation of the sprite in degrees about its center
+		float rotation;
+		// The texture coordinates of the sprite, with negative dimensions for
+		// reflected sprites (x, y, width, height)
+		float textureBox[4];
+		// The RGBA color of the sprite normalized to bytes
+		unsigned char color[4];
+		// The mode the fragment shader draws the sprite in
+		float mode;
+	};
+
+	// The number, OpenGL type, and normalization of the components of a C++
+	// type used as a vertex attribute, specialized for each supported type
+	template <typename T>
+	struct VertexAttributeTraits;
+	template <>
+	struct VertexAttributeTraits<float> {
+		static constexpr GLint Size = 1;
+		static constexpr GLenum Type = GL_FLOAT;
+		static constexpr GLboolean Normalized = GL_FALSE;
+	};
+	template <>
+	struct VertexAttributeTraits<glm::vec2> {
+		static constexpr GLint Size = 2;
+		static constexpr GLenum Type = GL_FLOAT;
+		static constexpr GLboolean Normalized = GL_FALSE;
+	};
+	template <>
+	struct VertexAttributeTraits<glm::vec3> {
+		static constexpr GLint Size = 3;
+		static constexpr GLenum Type = GL_FLOAT;
+		static constexpr GLboolean Normalized = GL_FALSE;
+	};
+	template <>
+	struct VertexAttributeTraits<glm::vec4> {
+		static constexpr GLint Size = 4;
+		static constexpr GLenum Type = GL_FLOAT;
+		static constexpr GLboolean Normalized = GL_FALSE;
+	};
+	template <>
+	struct VertexAttributeTraits<glm::u8vec4> {
+		static constexpr GLint Size = 4;
+		static constexpr GLenum Type = GL_UNSIGNED_BYTE;
+		static constexpr GLboolean Normalized = GL_TRUE;
+	};
+	template <>
+	struct VertexAttributeTraits<glm::u16vec2> {
+		static constexpr GLint Size = 2;
+		static constexpr GLenum Type = GL_UNSIGNED_SHORT;
+		static constexpr GLboolean Normalized = GL_TRUE;
+	};
+	template <>
+	struct VertexAttributeTraits<glm::i16vec2> {
+		static constexpr GLint Size = 2;
+		static constexpr GLenum Type = GL_SHORT;
+		static constexpr GLboolean Normalized = GL_TRUE;
+	};
+
+	// One attribute of a vertex layout
+	struct VertexAttribute {
+		// The number of components in the attribute
+		GLint size = 0;
+		// The OpenGL type of each component
+		GLenum type = GL_FLOAT;
+		// Whether integer components are normalized to [0, 1] or [-1, 1]
+		GLboolean normalized = GL_FALSE;
+		// The offset in bytes of the attribute in its vertex
+		GLuint offset = 0;
+
+		/*
+		Describe an attribute by the C++ type of its member in a vertex struct
+		Parameter: std::size_t offset - The offset in bytes of the member
+		Returns: VertexAttribute - The attribute
+		*/
+		template <typename T>
+		static constexpr VertexAttribute Of(std::size_t offset) {
+			return VertexAttribute{ VertexAttributeTraits<T>::Size,
+				VertexAttributeTraits<T>::Type,
+				VertexAttributeTraits<T>::Normalized, (GLuint)offset };
+		}
+	};
+
+// Describe a member of a vertex struct as a vertex attribute at compile time
+#define ACTIASFW_VERTEX_ATTRIBUTE(VERTEX, MEMBER) \
+	ActiasFW::VertexAttribute::Of<decltype(VERTEX::MEMBER)>( \
+		offsetof(VERTEX, MEMBER))
+
+	// The attributes and stride of a vertex type, compared by value so that
+	// every shader drawing the same layout shares one vertex array object
+	class VertexLayout {
+	public:
+		/*
+		Build the layout of a vertex struct from its attributes, in attribute
+		location order
+		Parameter: const VertexAttribute (&attributes)[N] - The attributes of
+		the struct, built with ACTIASFW_VERTEX_ATTRIBUTE
+		Returns: VertexLayout - The layout, with a stride of sizeof(V)
+		*/
+		template <typename V, std::size_t N>
+		static VertexLayout Of(const VertexAttribute (&attributes)[N]) {
+			VertexLayout layout;
+			layout.m_stride = (GLsizei)sizeof(V);
+			layout.m_attributes.assign(attributes, attributes + N);
+			return layout;
+		}
+		/*
+		Build the layout of tightly packed float attributes
+		Parameter: const std::vector<unsigned int>& sizes - The number of floats
+		in each attribute
+		Returns: VertexLayout - The layout
+		*/
+		static VertexLayout OfFloats(const std::vector<unsigned int>&);
+		/*
+		Build a layout from attributes known only at runtime, such as those of
+		a layout read from a frame trace
+		Parameter: const std::vector<VertexAttribute>& attributes - The
+		attributes in location order
+		Parameter: GLsizei stride - The size in bytes of one vertex
+		Returns: VertexLayout - The layout
+		*/
+		static VertexLayout Of(const std::vector<VertexAttribute>&, GLsizei);
+		/*
+		Point the vertex attributes of the bound vertex array object at the
+		bound vertex buffer with this layout and enable them
+		*/
+		void bind() const;
+		/*
+		Get the size in bytes of one vertex of this layout
+		Returns: GLsizei - This layout's stride
+		*/
+		GLsizei getStride() const;
+		/*
+		Get the attributes of this layout in location order
+		Returns: const std::vector<VertexAttribute>& - This layout's attributes
+		*/
+		const std::vector<VertexAttribute>& getAttributes() const;
+		/*
+		Order this layout against another so layouts can key a map
+		Parameter: const VertexLayout& layout - The layout to compare to
+		Returns: bool - Whether this layout orders before the other
+		*/
+		bool operator < (const VertexLayout&) const;
+
+	private:
+		// The size in bytes of one vertex
+		GLsizei m_stride = 0;
+		// The attributes of a vertex in location order
+		std::vector<VertexAttribute> m_attributes;
+	};
+
+	// A handle to a uniform variable of a shader, located once and uploaded
+	// to by the type of its value
+	template <typename T>
+	struct Uniform {
+		// The location of the uniform variable, or -1 if it was not found
+		GLint location = -1;
+
+		/*
+		Test whether this handle refers to a uniform variable
+		Returns: bool - Whether the uniform variable was found
+		*/
+		bool isValid() const {
+			return location >= 0;
+		}
+	};
+
 	// Wrapper class for an OpenGL GLSL shader program
 	class GLSLShader {
 	public:
 		/*
-		Copy another shader's memory into this shader
+		Create a shader with no program, to be initialized before use
+		*/
+		GLSLShader();
+		/*
+		Create a copy of another shader, sharing its program
+		Parameter: const GLSLShader& shader - The shader to copy
+		*/
+		GLSLShader(const GLSLShader&);
+		/*
+		Copy another shader's memory into this shader, releasing this shader's
+		program and sharing the other shader's
 		Parameter: const GLSLShader& shader - The shader to copy
 		*/
 		void operator = (const GLSLShader&);
@@ -106,10 +312,81 @@ namespace ActiasFW {
 		bool initialize(const std::string&, const std::string&,
 			const std::vector<unsigned int>&, Camera&, const std::string&);
 		/*
-		Set OpenGL to use this shader and enable its vertex attributes
+		Set OpenGL to use this shader and bind the vertex array object of its
+		vertex layout, binding its camera's slot of the camera uniform buffer
+		if the camera matrix is in a uniform block and uploading the matrix
+		otherwise
 		*/
 		void begin();
 		/*
+		Point this instanced shader's attributes at sprite instance records in
+		the bound vertex buffer
+		Parameter: GLintptr offset - The offset in bytes of the first instance
+		record in the bound vertex buffer
+		*/
+		void bindInstanceAttributes(GLintptr);
+		/*
+		Point this shader's vertex attributes at the bound vertex buffer in the
+		bound vertex array object
+		*/
+		void bindVertexAttributes();
+		/*
+		Get a handle to a uniform variable in this shader from the locations
+		cached when it was compiled
+		Parameter: const std::string& uniformName - The uniform variable to
+		locate
+		Returns: Uniform<T> - The handle, which is invalid if the uniform
+		variable was not found
+		*/
+		template <typename T>
+		Uniform<T> getUniform(const std::string& uniformName) const {
+			Uniform<T> uniform;
+			getUniformLocation(uniformName, uniform.location);
+			return uniform;
+		}
+		/*
+		Upload an integer to a uniform variable in this shader, which must be
+		in use
+		Parameter: const Uniform<int>& uniform - The uniform variable
+		Parameter: int value - The value to upload
+		*/
+		void upload(const Uniform<int>&, int);
+		/*
+		Upload a float to a uniform variable in this shader, which must be in
+		use
+		Parameter: const Uniform<float>& uniform - The uniform variable
+		Parameter: float value - The value to upload
+		*/
+		void upload(const Uniform<float>&, float);
+		/*
+		Upload a 2D vector to a uniform variable in this shader, which must be
+		in use
+		Parameter: const Uniform<glm::vec2>& uniform - The uniform variable
+		Parameter: const glm::vec2& value - The value to upload
+		*/
+		void upload(const Uniform<glm::vec2>&, const glm::vec2&);
+		/*
+		Upload a 3D vector to a uniform variable in this shader, which must be
+		in use
+		Parameter: const Uniform<glm::vec3>& uniform - The uniform variable
+		Parameter: const glm::vec3& value - The value to upload
+		*/
+		void upload(const Uniform<glm::vec3>&, const glm::vec3&);
+		/*
+		Upload a 4D vector to a uniform variable in this shader, which must be
+		in use
+		Parameter: const Uniform<glm::vec4>& uniform - The uniform variable
+		Parameter: const glm::vec4& value - The value to upload
+		*/
+		void upload(const Uniform<glm::vec4>&, const glm::vec4&);
+		/*
+		Upload a 4x4 matrix to a uniform variable in this shader, which must be
+		in use
+		Parameter: const Uniform<glm::mat4>& uniform - The uniform variable
+		Parameter: const glm::mat4& value - The value to upload
+		*/
+		void upload(const Uniform<glm::mat4>&, const glm::mat4&);
+		/*
 		Upload an integer to a uniform variable in this shader
 		Parameter: const std::string& uniformName - The uniform variable to
 		upload to
@@ -158,7 +435,8 @@ namespace ActiasFW {
 		*/
 		bool upload4x4Matrix(const std::string&, const glm::mat4&);
 		/*
-		Set OpenGL to stop using this shader and disable its vertex attributes
+		Finish drawing with this shader, resetting its instance attributes, its
+		program stays bound until another program is used
 		*/
 		void end();
 		/*
@@ -206,6 +484,60 @@ namespace ActiasFW {
 		*/
 		void setVertexAttributeSizes(const std::vector<unsigned int>&);
 		/*
+		Get the size in bytes of one vertex drawn by this shader
+		Returns: unsigned int - This shader's vertex attribute stride
+		*/
+		unsigned int getVertexAttributeStride() const;
+		/*
+		Get the layout of the vertices drawn by this shader
+		Returns: const VertexLayout& - This shader's vertex layout
+		*/
+		const VertexLayout& getVertexLayout() const;
+		/*
+		Set the layout of the vertices to be drawn by this shader, replacing
+		its vertex attribute sizes, so it can draw custom vertex types
+		Parameter: const VertexLayout& vertexLayout - This shader's new vertex
+		layout
+		*/
+		void setVertexLayout(const VertexLayout&);
+		/*
+		Test whether this shader draws sprites as instances expanded into quads
+		in its vertex shader rather than from vertices built on the CPU
+		Returns: bool - Whether this shader is instanced
+		*/
+		bool isInstanced() const;
+		/*
+		Set whether this shader draws sprites as instances, in which case its
+		vertex shader must take the fields of SpriteInstance as attributes 0 to
+		5 and its vertex attribute sizes are ignored
+		Parameter: bool instanced - Whether this shader is instanced
+		*/
+		void setInstanced(bool);
+		/*
+		Get the number of texture units this shader selects between by the
+		mode of each vertex
+		Returns: unsigned int - This shader's texture unit count
+		*/
+		unsigned int getTextureUnitCount() const;
+		/*
+		Get the name of the sampler array uniform variable this shader selects
+		texture units from
+		Returns: const std::string& - The sampler array uniform variable name
+		*/
+		const std::string& getTextureSamplerUniformName() const;
+		/*
+		Set the number of texture units this shader selects between, in which
+		case its last vertex attribute must be the default layout's mode and
+		its fragment shader must take the texture unit as the mode divided by
+		GraphicsManager::ModesPerTextureUnit, must be called before the shader
+		is compiled
+		Parameter: unsigned int textureUnitCount - The number of texture units
+		to select between, 1 to draw with a single texture
+		Parameter: const std::string& textureSamplerUniformName - The name of
+		the sampler array uniform variable to bind the texture units to
+		*/
+		void setTextureUnits(unsigned int, const std::string&);
+		/*
 		Get the camera whose projection matrix is used in this shader
 		Returns: Camera& - This shader's camera
 		*/
@@ -217,7 +549,8 @@ namespace ActiasFW {
 		void setCamera(Camera&);
 		/*
 		Get the name of the uniform variable to upload this shader's camera
-		matrix to
+		matrix to, either a plain uniform or the first member of a std140
+		uniform block read from the camera uniform buffer
 		Returns: const std::string& - The camera matrix uniform variable name
 		*/
 		const std::string& getCameraUniformName() const;
@@ -236,15 +569,25 @@ namespace ActiasFW {
 		std::string m_fragmentShaderSource = "";
 		// This shader's OpenGL ID
 		GLuint m_shaderID = 0;
-		// This shader's vertex attribute sizes (in floats) and offsets (in
-		// bytes)
-		std::vector<std::pair<unsigned int, unsigned int>> m_vertexAttributes;
-		// This shader's vertex attribute strides
-		unsigned int m_vertexAttributeStride = 0;
+		// The layout of the vertices drawn by this shader
+		VertexLayout m_vertexLayout;
+		// Whether this shader draws sprites as instances
+		bool m_instanced = false;
+		// The number of texture units this shader selects between
+		unsigned int m_textureUnitCount = 1;
+		// This shader's texture sampler array uniform name
+		std::string m_textureSamplerUniformName = "";
 		// This shader's camera
 		Camera* m_camera = 0;
 		// This shader's camera matrix uniform name
 		std::string m_cameraUniformName = "";
+		// The locations of this shader's uniform variables by name
+		std::map<std::string, GLint> m_uniformLocations;
+		// This shader's camera matrix uniform, if it is not in a uniform block
+		Uniform<glm::mat4> m_cameraUniform;
+		// Whether this shader reads its camera matrix from the camera uniform
+		// buffer
+		bool m_cameraBlock = false;
 
 		/*
 		Compile this shader program's vertex and fragment shader source code and
@@ -253,25 +596,853 @@ namespace ActiasFW {
 		*/
 		bool compile();
 		/*
-		Get the location of a uniform variable by name in this shader
+		Query the locations of every active uniform variable in this shader
+		program, including each element of uniform arrays
+		*/
+		void cacheUniformLocations();
+		/*
+		Locate this shader's camera matrix uniform, binding its uniform block to
+		the camera uniform buffer if it is in one
+		*/
+		void locateCameraUniform();
+		/*
+		Get the cached location of a uniform variable by name in this shader
 		Parameter: const std::string& uniformName - The uniform to locate
 		Parameter: GLint& location - The location to populate
 		Returns: bool - Whether the uniform was found
 		*/
-		bool getUniformLocation(const std::string&, GLint& location);
+		bool getUniformLocation(const std::string&, GLint& location) const;
+	};
+
+	// An OpenGL buffer which is rewritten by the CPU every frame, either
+	// persistently mapped and fenced in sections (OpenGL 4.4) or orphaned and
+	// mapped in sub-allocations (OpenGL 3.3)
+	class StreamBuffer {
+	public:
+		/*
+		Allocate this stream buffer's storage in OpenGL
+		Parameter: GLenum target - The OpenGL binding target of this buffer
+		Parameter: GLsizeiptr size - The total size in bytes of this buffer
+		Returns: bool - Whether this buffer's storage could be allocated
+		*/
+		bool initialize(GLenum, GLsizeiptr);
+		/*
+		Reserve a range of this buffer for writing, waiting for OpenGL to finish
+		reading it or orphaning the buffer if necessary
+		Parameter: GLsizeiptr size - The number of bytes to reserve
+		Parameter: GLsizeiptr alignment - The alignment in bytes of the start
+		of the reserved range in this buffer
+		Parameter: GLintptr& offset - The offset in bytes of the reserved range
+		in this buffer to populate
+		Returns: void* - A pointer to the reserved range or 0 if the range is
+		larger than this buffer's capacity
+		*/
+		void* map(GLsizeiptr, GLsizeiptr, GLintptr&);
+		/*
+		Finish writing the last range reserved from this buffer so OpenGL can
+		draw from it
+		*/
+		void unmap();
+		/*
+		Free this stream buffer's storage in OpenGL
+		*/
+		void destroy();
+		/*
+		Get the OpenGL ID of this stream buffer
+		Returns: GLuint - This buffer's ID
+		*/
+		GLuint getBufferID() const;
+		/*
+		Get the largest number of bytes which can be reserved at once from this
+		stream buffer
+		Returns: GLsizeiptr - This buffer's capacity
+		*/
+		GLsizeiptr getCapacity() const;
+		/*
+		Test whether this stream buffer is persistently mapped
+		Returns: bool - Whether this buffer is persistently mapped
+		*/
+		bool isPersistent() const;
+
+	private:
+		// The number of fenced sections a persistently mapped buffer is split
+		// into so the CPU can write one while OpenGL reads the others
+		static const unsigned int SectionCount = 3;
+		// The OpenGL binding target of this buffer
+		GLenum m_target = 0;
+		// This buffer's OpenGL ID
+		GLuint m_bufferID = 0;
+		// The total size in bytes of this buffer
+		GLsizeiptr m_size = 0;
+		// Whether this buffer is persistently mapped
+		bool m_persistent = false;
+		// The persistently mapped memory of this buffer
+		unsigned char* m_memory = 0;
+		// The offset in bytes of the next free byte in this buffer
+		GLintptr m_cursor = 0;
+		// The section of a persistently mapped buffer currently being written
+		unsigned int m_section = 0;
+		// The fences guarding each section of a persistently mapped buffer
+		GLsync m_fences[SectionCount] = { 0, 0, 0, };
+		// Whether a range of an orphaned buffer is currently mapped
+		bool m_mapped = false;
+
+		/*
+		Fence the current section of a persistently mapped buffer and wait for
+		OpenGL to finish reading the next one
+		*/
+		void advanceSection();
+	};
+
+	// A set of OpenGL textures (pages) into which many small images are packed
+	// so sprites using different images can be drawn together
+	class TextureAtlas {
+	public:
+		/*
+		Initialize this texture atlas's memory
+		Parameter: int pageSize - The width and height in pixels of each page
+		of this atlas
+		Parameter: int padding - The number of pixels each image's edges are
+		extended by in its page to prevent bleeding between images
+		*/
+		void initialize(int, int);
+		/*
+		Test whether an image is small enough to be packed into this atlas
+		Parameter: const glm::ivec2& dimensions - The width and height of the
+		image in pixels
+		Returns: bool - Whether the image can be packed into a page
+		*/
+		bool accepts(const glm::ivec2&) const;
+		/*
+		Get the dimensions of the area an image occupies in a page of this
+		atlas, including its padding
+		Parameter: const glm::ivec2& dimensions - The width and height of the
+		image in pixels
+		Returns: glm::ivec2 - The padded width and height of the image
+		*/
+		glm::ivec2 getPaddedDimensions(const glm::ivec2&) const;
+		/*
+		Copy an image with its edges extended by this atlas's padding, ready to
+		be uploaded to the area reserved for it, which may be done on any thread
+		Parameter: const unsigned char* pixels - The RGBA pixel data of the
+		image
+		Parameter: const glm::ivec2& dimensions - The width and height of the
+		image in pixels
+		Parameter: std::vector<unsigned char>& padded - The padded RGBA pixel
+		data to populate
+		*/
+		void pad(const unsigned char*, const glm::ivec2&,
+			std::vector<unsigned char>&) const;
+		/*
+		Reserve an area for an image in a page of this atlas, creating a new
+		page if no existing page has room for it
+		Parameter: const glm::ivec2& dimensions - The width and height of the
+		image in pixels, which must be accepted by this atlas
+		Parameter: GLuint& textureID - The OpenGL ID of the page the image was
+		packed into to populate
+		Parameter: glm::vec4& box - The texture coordinates of the image in its
+		page to populate (x, y, width, height)
+		Parameter: glm::ivec2& position - The position in pixels of the padded
+		area reserved in the page to populate
+		*/
+		void reserve(const glm::ivec2&, GLuint&, glm::vec4&, glm::ivec2&);
+		/*
+		Delete this atlas's pages from OpenGL and free its memory
+		*/
+		void destroy();
+		/*
+		Get the width and height in pixels of the pages of this atlas
+		Returns: int - This atlas's page size
+		*/
+		int getPageSize() const;
+		/*
+		Get the number of pages created in this atlas
+		Returns: size_t - The number of pages in this atlas
+		*/
+		size_t getPageCount() const;
+
+	private:
+		// A single OpenGL texture in a texture atlas
+		struct Page {
+			// The OpenGL ID of this page's texture
+			GLuint textureID = 0;
+			// The segments of the top edge of the packed area of this page
+			// (x, y, width)
+			std::vector<glm::ivec3> skyline;
+		};
+
+		// The width and height in pixels of each page of this atlas
+		int m_pageSize = 0;
+		// The number of pixels each image's edges are extended by
+		int m_padding = 0;
+		// The pages of this atlas
+		std::vector<Page> m_pages;
+
+		/*
+		Find the lowest position an area can be packed at in a page of this
+		atlas
+		Parameter: const Page& page - The page to pack the area into
+		Parameter: const glm::ivec2& dimensions - The dimensions of the area
+		Parameter: size_t& node - The index of the skyline segment the area's
+		left edge rests on to populate
+		Parameter: glm::ivec2& position - The position of the area to populate
+		Returns: bool - Whether there is room for the area in the page
+		*/
+		bool fit(const Page&, const glm::ivec2&, size_t&, glm::ivec2&) const;
+		/*
+		Raise the skyline of a page of this atlas over a newly packed area
+		Parameter: Page& page - The page the area was packed into
+		Parameter: size_t node - The index of the skyline segment the area's
+		left edge rests on
+		Parameter: const glm::ivec2& position - The position of the area
+		Parameter: const glm::ivec2& dimensions - The dimensions of the area
+		*/
+		void place(Page&, size_t, const glm::ivec2&, const glm::ivec2&);
+	};
+
+	// A single channel texture holding the images of a font's glyphs as they
+	// are first drawn, divided into square pages packed in rows, which grows
+	// taller while it can and then reuses its least recently drawn page
+	class GlyphAtlas {
+	public:
+		// The most pages an atlas can hold, so that the pages a text uses fit
+		// in one 64-bit mask
+		static const unsigned int MaxPages = 64;
+
+		/*
+		Initialize this glyph atlas's memory and create its texture one page
+		tall
+		Parameter: int width - The width in pixels of this atlas's texture,
+		which must be a multiple of the page size
+		Parameter: int pageSize - The width and height in pixels of each page
+		Parameter: int padding - The number of empty pixels kept between glyphs
+		Returns: bool - Whether this glyph atlas was initialized successfully
+		*/
+		bool initialize(int, int, int);
+		/*
+		Reserve an area for a glyph's image in a page of this atlas, growing
+		the texture or clearing the least recently drawn page not drawn this
+		frame if no page has room for it
+		Parameter: const glm::ivec2& dimensions - The width and height of the
+		image in pixels
+		Parameter: char32_t codepoint - The codepoint of the glyph
+		Parameter: unsigned int frame - The current frame
+		Parameter: glm::ivec2& position - The position in pixels of the area
+		reserved to populate
+		Parameter: std::vector<char32_t>& evicted - The codepoints of glyphs
+		whose images were cleared to append to
+		Returns: int - The index of the page the area was reserved in, or -1 if
+		there was no room for it
+		*/
+		int reserve(const glm::ivec2&, char32_t, unsigned int, glm::ivec2&,
+			std::vector<char32_t>&);
+		/*
+		Copy a glyph's image into an area of this atlas and its texture
+		Parameter: const unsigned char* pixels - The single channel pixel data
+		of the image
+		Parameter: int pitch - The number of bytes between rows of the image
+		Parameter: const glm::ivec2& position - The position of the area in
+		pixels
+		Parameter: const glm::ivec2& dimensions - The dimensions of the image
+		in pixels
+		*/
+		void upload(const unsigned char*, int, const glm::ivec2&,
+			const glm::ivec2&);
+		/*
+		Mark pages of this atlas as drawn in a frame, so they are not cleared
+		while text drawn in the frame uses them
+		Parameter: std::uint64_t pages - A mask with one bit for each page
+		Parameter: unsigned int frame - The current frame
+		*/
+		void touch(std::uint64_t, unsigned int);
+		/*
+		Get the OpenGL ID of this atlas's texture
+		Returns: GLuint - The texture's ID
+		*/
+		GLuint getTextureID() const;
+		/*
+		Get the width and height in pixels of this atlas's texture
+		Returns: glm::ivec2 - The texture's dimensions
+		*/
+		glm::ivec2 getDimensions() const;
+		/*
+		Get the number of times this atlas's texture has grown or cleared a
+		page, after which texture coordinates computed from it are stale
+		Returns: unsigned int - This atlas's generation
+		*/
+		unsigned int getGeneration() const;
+		/*
+		Get the number of pages created in this atlas
+		Returns: size_t - The number of pages in this atlas
+		*/
+		size_t getPageCount() const;
+		/*
+		Delete this atlas's texture from OpenGL and free its memory
+		*/
+		void destroy();
+
+	private:
+		// A square region of the texture whose glyphs are packed in rows
+		struct Page {
+			// The position of the next glyph in the current row, relative to
+			// the page
+			glm::ivec2 cursor = glm::ivec2();
+			// The height of the tallest glyph in the current row
+			int rowHeight = 0;
+			// The frame the page was last drawn in
+			unsigned int frame = 0;
+			// The codepoints of the glyphs in the page
+			std::vector<char32_t> glyphs;
+		};
+
+		// The OpenGL ID of this atlas's texture
+		GLuint m_textureID = 0;
+		// The width in pixels of the texture
+		int m_width = 0;
+		// The height in pixels of the texture
+		int m_height = 0;
+		// The height in pixels the texture cannot grow past
+		int m_maximumHeight = 0;
+		// The width and height in pixels of each page
+		int m_pageSize = 0;
+		// The number of empty pixels kept between glyphs
+		int m_padding = 0;
+		// A copy of the texture's pixels, uploaded again when it grows
+		std::vector<unsigned char> m_pixels;
+		// The pages of this atlas, in rows across the texture
+		std::vector<Page> m_pages;
+		// The number of times the texture has grown or cleared a page
+		unsigned int m_generation = 0;
+
+		/*
+		Find room for an area in the current or next row of a page
+		Parameter: const Page& page - The page to pack the area into
+		Parameter: const glm::ivec2& dimensions - The dimensions of the area
+		Parameter: glm::ivec2& position - The position of the area relative to
+		the page to populate
+		Returns: bool - Whether there is room for the area in the page
+		*/
+		bool fit(const Page&, const glm::ivec2&, glm::ivec2&) const;
+		/*
+		Get the position in pixels of a page in the texture
+		Parameter: size_t page - The index of the page
+		Returns: glm::ivec2 - The position of the page's top left corner
+		*/
+		glm::ivec2 getPageOrigin(size_t) const;
+		/*
+		Double the height of the texture, keeping its pixels
+		Returns: bool - Whether the texture could grow
+		*/
+		bool grow();
+	};
+
+	// A set of sprites that rarely change, baked once into vertex and index
+	// buffers that stay on the GPU and are drawn without any CPU vertex work
+	class StaticBatch {
+	public:
+		/*
+		Initialize this batch's memory and OpenGL buffers, the sprites are baked
+		the first time the batch is submitted
+		Parameter: const std::vector<Sprite*>& sprites - The sprites in this
+		batch, which must outlive it
+		Parameter: GLSLShader& shader - The shader to draw this batch with,
+		which must not be instanced
+		Returns: bool - Whether this batch was initialized successfully
+		*/
+		bool initialize(const std::vector<Sprite*>&, GLSLShader&);
+		/*
+		Mark this batch to be baked again the next time it is submitted, after
+		any of its sprites has changed
+		*/
+		void markDirty();
+		/*
+		Test whether this batch must be baked again before it is drawn
+		Returns: bool - Whether this batch is dirty
+		*/
+		bool isDirty() const;
+		/*
+		Get the sprites in this batch
+		Returns: const std::vector<Sprite*>& - The sprites in this batch
+		*/
+		const std::vector<Sprite*>& getSprites() const;
+		/*
+		Get the shader this batch is drawn with
+		Returns: GLSLShader& - The shader this batch is drawn with
+		*/
+		GLSLShader& getShader();
+		/*
+		Free this batch's memory and OpenGL buffers
+		Returns: bool - Whether this batch was freed successfully
+		*/
+		bool destroy();
+
+	private:
+		// The number of cells along each side of the grid a batch's bounds are
+		// split into, a group holds the sprites of one cell so that groups
+		// outside the camera can be culled
+		static constexpr int GridSize = 8;
+
+		// Allow the GraphicsManager class access to private memory
+		friend class GraphicsManager;
+
+		// A run of baked sprites sharing a depth, texture, and grid cell,
+		// drawn in one call
+		struct Group {
+			// The depth of the sprites in this group
+			float depth = 0.0f;
+			// The file name of the texture of the sprites in this group
+			std::string textureFileName = "";
+			// The rectangle bounding the sprites in this group (x, y, width,
+			// height)
+			glm::vec4 bounds = glm::vec4();
+			// The index of the first index of this group in the index buffer
+			unsigned int firstIndex = 0;
+			// The number of indices in this group
+			unsigned int indexCount = 0;
+			// The number of sprites in this group
+			unsigned int spriteCount = 0;
+			// The texture unit this group's texture is bound to
+			unsigned int unit = 0;
+			// The set of textures bound together when drawing this group, so
+			// consecutive groups of one set are drawn in one call
+			unsigned int textureSet = 0;
+		};
+
+		// The sprites in this batch
+		std::vector<Sprite*> m_sprites;
+		// The shader to draw this batch with
+		GLSLShader* m_shader = 0;
+		// The ID of the OpenGL vertex array object of this batch
+		GLuint m_VAOID = 0;
+		// The ID of the OpenGL buffer of this batch's vertices
+		GLuint m_VBOID = 0;
+		// The ID of the OpenGL buffer of this batch's indices
+		GLuint m_IBOID = 0;
+		// The groups of sprites baked into this batch's buffers in draw order
+		std::vector<Group> m_groups;
+		// The OpenGL IDs of the textures of this batch's groups, split into
+		// sets of as many textures as the batch's shader has texture units
+		std::vector<GLuint> m_textureIDs;
+		// Whether this batch must be baked before it is drawn
+		bool m_dirty = true;
+	};
+
+	// Text laid out into the quads of its glyphs once and kept until it
+	// changes, so text drawn unchanged every frame does no layout work
+	class TextMesh {
+	public:
+		/*
+		Initialize this text mesh's memory, the text is laid out the first time
+		the mesh is submitted
+		Parameter: const std::string& text - The text to draw
+		Parameter: const glm::vec3& posiion - The position and depth to draw the
+		text at
+		Parameter: const glm::vec4& box - The bounding box to draw the text
+		inside of (x, y, width, height)
+		Parameter: float scale - The scale to draw the text at
+		Parameter: const glm::vec4& color - The color to draw the text in (RGBA)
+		Parameter: const std::string& fontFileName - The file name of the font
+		to draw the text in
+		Parameter: Alignment horizontalAlignment - The horizontal alignment to
+		draw the text in inside its box
+		Parameter: Alignment verticalAlignment - The vertical alignment to draw
+		the text in inside its box
+		*/
+		void initialize(const std::string&, const glm::vec3&, const glm::vec4&,
+			float, const glm::vec4&, const std::string&, Alignment, Alignment);
+		/*
+		Get the text drawn by this mesh
+		Returns: const std::string& - This mesh's text
+		*/
+		const std::string& getText() const;
+		/*
+		Set the text drawn by this mesh, laying it out again if it changed
+		Parameter: const std::string& text - This mesh's new text
+		*/
+		void setText(const std::string&);
+		/*
+		Get the position and depth this mesh's text is drawn at
+		Returns: const glm::vec3& - This mesh's position
+		*/
+		const glm::vec3& getPosition() const;
+		/*
+		Set the position and depth this mesh's text is drawn at, laying it out
+		again if it changed
+		Parameter: const glm::vec3& position - This mesh's new position
+		*/
+		void setPosition(const glm::vec3&);
+		/*
+		Get the bounding box this mesh's text is drawn inside of
+		Returns: const glm::vec4& - This mesh's box (x, y, width, height)
+		*/
+		const glm::vec4& getBox() const;
+		/*
+		Set the bounding box this mesh's text is drawn inside of, laying it out
+		again if it changed
+		Parameter: const glm::vec4& box - This mesh's new box
+		*/
+		void setBox(const glm::vec4&);
+		/*
+		Get the color this mesh's text is drawn in
+		Returns: const glm::vec4& - This mesh's color (RGBA)
+		*/
+		const glm::vec4& getColor() const;
+		/*
+		Set the color this mesh's text is drawn in, laying it out again if it
+		changed
+		Parameter: const glm::vec4& color - This mesh's new color
+		*/
+		void setColor(const glm::vec4&);
+		/*
+		Test whether this mesh must be laid out again before it is drawn, since
+		it changed or its font's atlas moved or cleared its glyphs
+		Returns: bool - Whether this mesh is dirty
+		*/
+		bool isDirty() const;
+		/*
+		Free this text mesh's memory
+		*/
+		void destroy();
+
+	private:
+		// Allow the GraphicsManager class access to private memory
+		friend class GraphicsManager;
+		// Allow the FrameTrace class access to private memory
+		friend class FrameTrace;
+
+		// The text drawn by this mesh
+		std::string m_text = "";
+		// The position and depth the text is drawn at
+		glm::vec3 m_position = glm::vec3();
+		// The bounding box the text is drawn inside of
+		glm::vec4 m_box = glm::vec4();
+		// The scale the text is drawn at
+		float m_scale = 1.0f;
+		// The color the text is drawn in
+		glm::vec4 m_color = glm::vec4();
+		// The file name of the font the text is drawn in
+		std::string m_fontFileName = "";
+		// The horizontal alignment of the text inside its box
+		Alignment m_horizontalAlignment = NO_ALIGNMENT;
+		// The vertical alignment of the text inside its box
+		Alignment m_verticalAlignment = NO_ALIGNMENT;
+		// Whether the text must be laid out again
+		bool m_dirty = true;
+		// The number of glyphs of the text inside its box
+		size_t m_glyphCount = 0;
+		// The atlas of the glyph images the text was laid out with
+		GlyphAtlas* m_atlas = 0;
+		// The generation of the atlas when the text was laid out
+		unsigned int m_atlasGeneration = 0;
+		// A mask of the pages of the atlas the text's glyphs are in
+		std::uint64_t m_pages = 0;
+		// The glyphs of the text, made from its quads only when it is drawn
+		// with an instanced shader
+		std::vector<Glyph> m_glyphs;
+		// The vertices of every glyph's quad
+		std::vector<float> m_vertices;
+		// The indices of every glyph's quad
+		std::vector<unsigned int> m_indices;
+		// The rectangle bounding the glyphs (x, y, width, height)
+		glm::vec4 m_bounds = glm::vec4();
+		// The file name of the font's texture
+		std::string m_textureFileName = "";
+	};
+
+	// A layer of tiles drawn from a set of textures, stored as one tile index
+	// per cell of a grid split into square chunks, each chunk baked into its
+	// own buffers the first time it is visible after one of its tiles changed
+	class TileMap {
+	public:
+		// The number of tiles along each side of a chunk
+		static const int ChunkSize = 16;
+		// The tile index of cells with no tile, which are not drawn
+		static constexpr std::uint16_t EmptyTile = 0xFFFF;
+
+		/*
+		Initialize this tile map's memory and its chunks' OpenGL buffers, with
+		every cell empty, the tiles' textures are loaded without the texture
+		atlas so rectangles of one tile can be drawn as one repeating quad
+		Parameter: const glm::ivec2& dimensions - The number of columns and
+		rows of tiles in this map
+		Parameter: const glm::vec3& position - The position of the bottom left
+		corner of this map and the depth to draw it at
+		Parameter: const glm::vec2& tileDimensions - The width and height of
+		each tile
+		Parameter: const std::vector<std::string>& tileTextureFileNames - The
+		file names of the textures of each tile index
+		Parameter: GLSLShader& shader - The shader to draw this map with, which
+		must not be instanced
+		Returns: bool - Whether this tile map was initialized successfully
+		*/
+		bool initialize(const glm::ivec2&, const glm::vec3&, const glm::vec2&,
+			const std::vector<std::string>&, GLSLShader&);
+		/*
+		Get the tile index of a cell of this map
+		Parameter: const glm::ivec2& cell - The column and row of the cell,
+		counted from the bottom left
+		Returns: std::uint16_t - The cell's tile index, or EmptyTile if the
+		cell is outside this map
+		*/
+		std::uint16_t getTile(const glm::ivec2&) const;
+		/*
+		Set the tile index of a cell of this map, marking its chunk to be baked
+		again if the tile changed
+		Parameter: const glm::ivec2& cell - The column and row of the cell,
+		counted from the bottom left
+		Parameter: std::uint16_t tile - The cell's new tile index
+		*/
+		void setTile(const glm::ivec2&, std::uint16_t);
+		/*
+		Get the number of columns and rows of tiles in this map
+		Returns: const glm::ivec2& - This map's dimensions in tiles
+		*/
+		const glm::ivec2& getDimensions() const;
+		/*
+		Get the position of the bottom left corner of this map and its depth
+		Returns: const glm::vec3& - This map's position
+		*/
+		const glm::vec3& getPosition() const;
+		/*
+		Get the width and height of each tile of this map
+		Returns: const glm::vec2& - This map's tile dimensions
+		*/
+		const glm::vec2& getTileDimensions() const;
+		/*
+		Get the file names of the textures of each tile index
+		Returns: const std::vector<std::string>& - This map's tile textures
+		*/
+		const std::vector<std::string>& getTileTextureFileNames() const;
+		/*
+		Get the shader this map is drawn with
+		Returns: GLSLShader& - The shader this map is drawn with
+		*/
+		GLSLShader& getShader();
+		/*
+		Get the number of times this map's tiles have changed, which changes
+		whenever any chunk must be baked again
+		Returns: unsigned int - This map's revision
+		*/
+		unsigned int getRevision() const;
+		/*
+		Free this tile map's memory and its chunks' OpenGL buffers
+		Returns: bool - Whether this tile map was freed successfully
+		*/
+		bool destroy();
+
+	private:
+		// Allow the GraphicsManager class access to private memory
+		friend class GraphicsManager;
+
+		// A square region of a tile map baked into its own buffers
+		struct Chunk {
+			// The column and row of this chunk's bottom left cell
+			glm::ivec2 origin = glm::ivec2();
+			// The number of columns and rows of cells in this chunk, smaller
+			// than the chunk size at the map's top and right edges
+			glm::ivec2 dimensions = glm::ivec2();
+			// The rectangle covered by this chunk (x, y, width, height)
+			glm::vec4 bounds = glm::vec4();
+			// The buffers and groups of this chunk's baked quads
+			StaticBatch batch;
+		};
+
+		// The number of columns and rows of tiles in this map
+		glm::ivec2 m_dimensions = glm::ivec2();
+		// The position of the bottom left corner of this map and its depth
+		glm::vec3 m_position = glm::vec3();
+		// The width and height of each tile
+		glm::vec2 m_tileDimensions = glm::vec2();
+		// The file names of the textures of each tile index
+		std::vector<std::string> m_tileTextureFileNames;
+		// The shader to draw this map with
+		GLSLShader* m_shader = 0;
+		// The number of columns and rows of chunks in this map
+		glm::ivec2 m_chunkCounts = glm::ivec2();
+		// The chunks of this map, row by row from the bottom left
+		std::vector<Chunk> m_chunks;
+		// The tile index of every cell, stored chunk by chunk with each
+		// chunk's cells row by row so a chunk's tiles are contiguous
+		std::vector<std::uint16_t> m_tiles;
+		// The number of times this map's tiles have changed
+		unsigned int m_revision = 0;
+
+		/*
+		Get the index of a cell's tile in the tile array
+		Parameter: const glm::ivec2& cell - The column and row of the cell,
+		which must be inside this map
+		Returns: size_t - The index of the cell's tile
+		*/
+		size_t getTileIndex(const glm::ivec2&) const;
+	};
+
+	// A texture sprites and text can be drawn into instead of the window, so
+	// that graphics which rarely change can be drawn once and then drawn as
+	// one sprite each frame
+	class RenderTarget {
+	public:
+		/*
+		Initialize this render target's texture and framebuffer, registering
+		the texture with the graphics manager under a name
+		Parameter: const glm::ivec2& dimensions - The width and height of the
+		texture in pixels
+		Parameter: const std::string& textureFileName - The name sprites draw
+		this target's texture by, which must not name a texture file
+		Returns: bool - Whether this render target was initialized successfully
+		*/
+		bool initialize(const glm::ivec2&, const std::string&);
+		/*
+		Get the width and height of this render target's texture
+		Returns: const glm::ivec2& - This target's dimensions in pixels
+		*/
+		const glm::ivec2& getDimensions() const;
+		/*
+		Resize this render target's texture, discarding what was drawn into it
+		Parameter: const glm::ivec2& dimensions - This target's new dimensions
+		in pixels
+		*/
+		void setDimensions(const glm::ivec2&);
+		/*
+		Get the name sprites draw this render target's texture by
+		Returns: const std::string& - This target's texture file name
+		*/
+		const std::string& getTextureFileName() const;
+		/*
+		Test whether every texture last drawn into this render target had
+		finished loading, rather than being drawn as a placeholder
+		Returns: bool - Whether this target's contents are complete
+		*/
+		bool isComplete() const;
+		/*
+		Free this render target's texture and framebuffer
+		Returns: bool - Whether this render target was freed successfully
+		*/
+		bool destroy();
+
+	private:
+		// Allow the GraphicsManager class access to private memory
+		friend class GraphicsManager;
+		// The ID of the OpenGL framebuffer drawing into the texture
+		GLuint m_framebufferID = 0;
+		// The ID of the OpenGL texture drawn into
+		GLuint m_textureID = 0;
+		// The width and height of the texture in pixels
+		glm::ivec2 m_dimensions = glm::ivec2();
+		// The name the texture is registered with the graphics manager by
+		std::string m_textureFileName = "";
+		// Whether every texture last drawn into this target had loaded
+		bool m_complete = false;
+	};
+
+	// A sprite drawing a render target's texture, whose colors are stored
+	// premultiplied by their alpha and whose bottom row is stored first
+	class TargetSprite : public Sprite {
+	public:
+		/*
+		Initialize this sprite to draw a render target's texture
+		Parameter: const glm::vec3& position - The position and depth of this
+		sprite
+		Parameter: const glm::vec2& dimensions - The dimensions of this sprite
+		Parameter: const RenderTarget& target - The render target to draw
+		*/
+		void initialize(const glm::vec3&, const glm::vec2&,
+			const RenderTarget&);
+
+	private:
+		/*
+		Get the mode the fragment shader draws this sprite in
+		Returns: float - The premultiplied texture draw mode
+		*/
+		float getDrawMode() const override;
 	};
 
 	// The OpenGL graphics system for ActiasFW applications
 	class GraphicsManager {
 	public:
+		// The most texture units a shader can select between in one draw call
+		static constexpr unsigned int MaxTextureUnits = 8;
+		// The number of draw modes encoded in each vertex for each texture
+		// unit, a vertex's mode is its draw mode plus its texture unit times
+		// this number
+		static const unsigned int ModesPerTextureUnit = 8;
+		// The uniform buffer binding point camera matrices are read from
+		static const GLuint CameraBinding = 0;
+		// The pixel size fonts are laid out at, and bitmap fonts rasterized at
+		static const unsigned int FontPixelSize = 64;
+		// The pixel size signed distance field fonts are rasterized at
+		static const unsigned int SDFPixelSize = 32;
+		// The distance in pixels signed distance fields extend outside each
+		// glyph's outline
+		static const int SDFSpread = 8;
+		// The width in pixels of each font's glyph atlas
+		static const int GlyphAtlasWidth = 1024;
+		// The width and height in pixels of each page of a glyph atlas
+		static const int GlyphPageSize = 256;
+		// The codepoint text decodes invalid UTF-8 bytes to
+		static const char32_t ReplacementCharacter = 0xFFFD;
+		// The number of times text is laid out in one frame while laying it
+		// out keeps changing its font's glyph atlas
+		static const unsigned int TextLayoutAttempts = 3;
+
+		// Measurements of the work done by a graphics manager in one frame
+		struct FrameStatistics {
+			// The number of sprites drawn in the frame
+			unsigned int sprites = 0;
+			// The number of sprites submitted in the frame but not drawn
+			// because they were outside their shader's camera
+			unsigned int culledSprites = 0;
+			// The number of OpenGL draw calls issued in the frame
+			unsigned int drawCalls = 0;
+			// The number of bytes of vertex data streamed to OpenGL
+			size_t vertexBytes = 0;
+			// The number of bytes of index data streamed to OpenGL
+			size_t indexBytes = 0;
+			// The number of bytes of texture data uploaded to OpenGL
+			size_t textureBytes = 0;
+			// The number of OpenGL state changes issued in the frame
+			unsigned int stateChanges = 0;
+			// The number of OpenGL state changes skipped in the frame because
+			// the state was already set
+			unsigned int skippedStateChanges = 0;
+			// The time in milliseconds spent uploading loaded textures
+			double uploadTime = 0.0;
+			// The time in milliseconds spent merging the threads' commands,
+			// laying out text and baking static batches
+			double mergeTime = 0.0;
+			// The time in milliseconds spent culling the frame's sprites,
+			// generating their vertices, and building their sort keys
+			double prepareTime = 0.0;
+			// The time in milliseconds spent sorting the frame's sprites
+			double sortTime = 0.0;
+			// The time in milliseconds spent streaming the frame's vertices
+			// and issuing its draw calls
+			double submitTime = 0.0;
+			// The time in milliseconds spent sorting and drawing the frame
+			double drawTime = 0.0;
+		};
+
 		/*
-		Initialize the GLEW and FreeType libraries and this graphics manager's
-		memory
+		Load OpenGL and initialize the FreeType library and this graphics
+		manager's memory
 		Parameter: const glm::vec3& backgroundColor - The color to clear the
 		application's window to
+		Parameter: size_t streamBufferSize - The size in bytes of the buffer
+		vertex data is streamed to OpenGL through each frame
+		Parameter: int atlasPageSize - The width and height in pixels of the
+		texture atlas pages small textures are packed into, or 0 to load every
+		texture separately
+		Parameter: size_t textureUploadBudget - The number of bytes of decoded
+		texture data uploaded to OpenGL each frame, at least one texture is
+		uploaded per frame however large
+		Parameter: const std::string& shaderCacheDirectory - The directory to
+		save linked shader program binaries to, or empty to compile every
+		shader program at startup
+		Parameter: size_t textCacheSize - The number of text layouts submitted
+		by string to keep for reuse in later frames
 		Returns: bool - Whether the graphics system could be initialized
 		*/
-		bool initialize(const glm::vec3&);
+		bool initialize(const glm::vec3&, size_t, int, size_t,
+			const std::string&, size_t);
 		/*
 		Update this graphics manager's default camera
 		Parameter: float timeStep - The number of frames elapsed since the last
@@ -283,18 +1454,21 @@ namespace ActiasFW {
 		*/
 		void begin();
 		/*
-		Submit a sprite to be drawn this frame with a shader
+		Submit a sprite to be drawn this frame with a shader, sprites and text
+		may be submitted from any thread between begin() and end() but each
+		sprite only once per frame
 		Parameter: T& sprite - The sprite to draw
 		Parameter: GLSLShader& shader - The shader to use when drawing
 		*/
 		template <typename T>
 		void submit(T& sprite, GLSLShader& shader) {
-			sprite.draw();
-			if (sprite.getVertices().empty()) {
-				return;
-			}
-			m_sprites.push_back(
-				std::pair<GLSLShader*, Sprite*>(&shader, (Sprite*)&sprite));
+			// Classes derived from the other drawables would otherwise be
+			// drawn as sprites
+			static_assert(std::is_base_of<Sprite, T>::value);
+			RenderItem item;
+			item.shader = &shader;
+			item.sprite = (Sprite*)&sprite;
+			getCommandBuffer().items.push_back(item);
 		}
 		/*
 		Submit a sprite to be drawn this frame with the default shader
@@ -324,7 +1498,85 @@ namespace ActiasFW {
 			submit(sprites, m_defaultShader);
 		}
 		/*
-		Submit text to be drawn this frame with a shader
+		Submit a static batch to be drawn this frame with its shader, baking it
+		at the end of the frame if it is dirty
+		Parameter: StaticBatch& batch - The batch to draw
+		*/
+		void submit(StaticBatch&);
+		/*
+		Submit a tile map to be drawn this frame with its shader, baking its
+		visible chunks at the end of the frame if they are dirty
+		Parameter: TileMap& map - The tile map to draw
+		*/
+		void submit(TileMap&);
+		/*
+		Submit a particle system to be drawn this frame with its shader, its
+		particles are expanded into quads as they are drawn so the system must
+		not be updated before the end of the frame
+		Parameter: ParticleSystem& particles - The particle system to draw
+		*/
+		void submit(ParticleSystem&);
+		/*
+		Submit a text mesh to be drawn this frame with a shader, laying it out
+		at the end of the frame if it is dirty
+		Parameter: TextMesh& mesh - The text to draw, which must not be freed
+		before the end of the frame
+		Parameter: GLSLShader& shader - The shader to use when drawing
+		*/
+		void submit(TextMesh&, GLSLShader&);
+		/*
+		Submit a text mesh to be drawn this frame with the default shader
+		Parameter: TextMesh& mesh - The text to draw
+		*/
+		void submit(TextMesh&);
+		/*
+		Submit a mesh of custom vertices to be drawn this frame with a shader
+		whose vertex layout describes them, the vertices are copied so they may
+		be freed once this returns
+		Parameter: const std::vector<V>& vertices - The vertices of the mesh,
+		ignored if sizeof(V) differs from the shader's vertex stride
+		Parameter: const std::vector<unsigned int>& indices - The indices of the
+		mesh's triangles
+		Parameter: float depth - The depth to draw the mesh at
+		Parameter: const std::string& textureFileName - The file name of the
+		texture to bind to the first texture unit, or empty to draw untextured
+		Parameter: GLSLShader& shader - The shader to use when drawing, which
+		must not be instanced
+		*/
+		template <typename V>
+		void submit(const std::vector<V>& vertices,
+			const std::vector<unsigned int>& indices, float depth,
+			const std::string& textureFileName, GLSLShader& shader) {
+			if (sizeof(V) != shader.getVertexAttributeStride()) {
+				return;
+			}
+			submitVertices((const unsigned char*)vertices.data(),
+				vertices.size() * sizeof(V), indices, depth, textureFileName,
+				shader);
+		}
+		/*
+		Submit a mesh of custom vertices given as bytes to be drawn this frame
+		with a shader whose vertex layout describes them, the vertices are
+		copied so they may be freed once this returns
+		Parameter: const unsigned char* vertices - The bytes of the vertices of
+		the mesh
+		Parameter: size_t vertexBytes - The number of bytes of vertices, ignored
+		if it is not a multiple of the shader's vertex stride
+		Parameter: const std::vector<unsigned int>& indices - The indices of the
+		mesh's triangles
+		Parameter: float depth - The depth to draw the mesh at
+		Parameter: const std::string& textureFileName - The file name of the
+		texture to bind to the first texture unit, or empty to draw untextured
+		Parameter: GLSLShader& shader - The shader to use when drawing, which
+		must not be instanced
+		*/
+		void submitVertices(const unsigned char*, size_t,
+			const std::vector<unsigned int>&, float, const std::string&,
+			GLSLShader&);
+		/*
+		Submit text to be drawn this frame with a shader, reusing its layout
+		from a recent frame if the same text was drawn with the same
+		properties
 		Parameter: const std::string& text - The text to draw
 		Parameter: const glm::vec3& posiion - The position and depth to draw the
 		text at
@@ -362,12 +1614,25 @@ namespace ActiasFW {
 		void submit(const std::string&, const glm::vec3&, const glm::vec4&,
 			float, const glm::vec4&, const std::string&, Alignment, Alignment);
 		/*
-		Draw all the sprites and text submitted this frame
+		Draw everything the calling thread submits into a render target
+		instead of the window until endTarget() is called, each target is
+		cleared and drawn into at the end of the frame before the window, and
+		must only be submitted into by one thread at a time
+		Parameter: RenderTarget& target - The render target to draw into
+		*/
+		void beginTarget(RenderTarget&);
+		/*
+		Draw everything the calling thread submits into the window again
+		*/
+		void endTarget();
+		/*
+		Draw all the sprites and text submitted this frame, first into the
+		render targets submitted into and then into the window
 		*/
 		void end();
 		/*
-		Terminate the GLEW and FreeType libraries and free this graphics
-		manager's memory
+		Terminate the FreeType library and free this graphics manager's
+		memory
 		Returns: bool - Whether this graphics manager was destroyed successfully
 		*/
 		bool destroy();
@@ -383,8 +1648,344 @@ namespace ActiasFW {
 		Returns: GLSLShader& - This graphics manager's default shader
 		*/
 		GLSLShader& getDefaultShader();
+		/*
+		Get the default instanced shader, which draws sprites like the default
+		shader but uploads one compact record per sprite
+		Returns: GLSLShader& - This graphics manager's default instanced shader
+		*/
+		GLSLShader& getDefaultInstancedShader();
+		/*
+		Get the measurements of the work done in the last frame drawn
+		Returns: const FrameStatistics& - The last frame's statistics
+		*/
+		const FrameStatistics& getFrameStatistics() const;
+		/*
+		Get the cache OpenGL state is bound through, which must be invalidated
+		by code binding OpenGL state directly between frames
+		Returns: GLStateCache& - This graphics manager's state cache
+		*/
+		GLStateCache& getStateCache();
+		/*
+		Test whether the compute shaders simulating particles on the GPU were
+		compiled, which requires OpenGL 4.3
+		Returns: bool - Whether particles can be simulated on the GPU
+		*/
+		bool isComputeAvailable() const;
+		/*
+		Set how a font's glyphs are rasterized when it is loaded, fonts are
+		rasterized as bitmaps unless set otherwise before they are first drawn
+		Parameter: const std::string& fileName - The file name of the font
+		Parameter: Font::Rendering rendering - How to rasterize the font
+		*/
+		void setFontRendering(const std::string&, Font::Rendering);
+		/*
+		Get how a font's glyphs are rasterized, or will be when it is loaded
+		Parameter: const std::string& fileName - The file name of the font
+		Returns: Font::Rendering - How the font is rasterized
+		*/
+		Font::Rendering getFontRendering(const std::string&) const;
+		/*
+		Set the trace the work submitted in each frame is recorded into while
+		it is recording
+		Parameter: FrameTrace* trace - The trace to record into, or 0 to record
+		no frames
+		*/
+		void setCapture(FrameTrace*);
+		/*
+		Decode the UTF-8 character starting at an index of a string, decoding
+		invalid and truncated sequences to the replacement character
+		Parameter: const std::string& text - The UTF-8 text to decode
+		Parameter: size_t& index - The index of the character's first byte,
+		advanced past its last byte
+		Returns: char32_t - The character's codepoint
+		*/
+		static char32_t DecodeUTF8(const std::string&, size_t&);
+		/*
+		Get the named frames of a texture listed in its optional frame file
+		(the texture's file name followed by ".frames", with one frame per line
+		written as "name x y width height" in pixels)
+		Parameter: const std::string& textureFileName - The file name of the
+		texture
+		Parameter: const std::string& prefix - The prefix of the names of the
+		frames to get, or empty to get every frame
+		Returns: std::vector<glm::vec4> - The texture coordinates of the frames
+		in the order they appear in the frame file (x, y, width, height)
+		*/
+		std::vector<glm::vec4> getTextureFrames(const std::string&,
+			const std::string& = "");
+		/*
+		Start loading textures on the worker threads so they are uploaded
+		before they are first drawn, sprites drawn with a texture that is still
+		loading are drawn with a transparent placeholder
+		Parameter: const std::vector<std::string>& fileNames - The file names of
+		the textures to load
+		*/
+		void prefetchTextures(const std::vector<std::string>&);
+		/*
+		Test whether a texture has finished loading and been uploaded to OpenGL
+		Parameter: const std::string& fileName - The file name of the texture
+		Returns: bool - Whether the texture is loaded, or failed to load and
+		will be drawn untextured
+		*/
+		bool isTextureReady(const std::string&) const;
+		/*
+		Load a texture into its own OpenGL texture rather than packing it into
+		the texture atlas, so texture coordinates outside of 0 to 1 repeat it,
+		which must be set before the texture is first drawn or prefetched
+		Parameter: const std::string& fileName - The file name of the texture
+		*/
+		void setTextureRepeated(const std::string&);
 
 	private:
+		// An OpenGL texture loaded by a graphics manager and the region of it
+		// occupied by an image
+		struct Texture {
+			// The OpenGL ID of the texture
+			GLuint ID = 0;
+			// The region of the texture occupied by the image (x, y, width,
+			// height)
+			glm::vec4 box = glm::vec4(0.0f, 0.0f, 1.0f, 1.0f);
+			// Whether the texture is a page of the texture atlas
+			bool atlased = false;
+		};
+		// A texture being read and decoded on a worker thread
+		class TextureLoad : public AsyncTask {
+		public:
+			// The states of a texture load
+			enum State {
+				LOAD_PENDING,
+				LOAD_DECODED,
+				LOAD_FAILED,
+			};
+
+			// The file name of the texture
+			std::string fileName = "";
+			// The atlas the texture is padded for if it is small enough, or 0
+			// if the texture must be loaded without the atlas
+			const TextureAtlas* atlas = 0;
+			// The decoded RGBA pixel data of the texture, padded if atlased
+			std::vector<unsigned char> pixels;
+			// The width and height of the texture in pixels
+			glm::ivec2 dimensions = glm::ivec2();
+			// Whether the texture will be packed into the atlas
+			bool atlased = false;
+			// The named frames read from the texture's frame file
+			std::vector<std::pair<std::string, glm::vec4>> frames;
+			// The state of this load, written last by the worker thread
+			std::atomic<int> state = LOAD_PENDING;
+
+			/*
+			Read and decode the texture and its frame file
+			*/
+			void execute() override;
+			/*
+			Block the calling thread until this load has decoded or failed
+			*/
+			void wait();
+
+		private:
+			// Guards the state of this load while a thread waits for it
+			std::mutex m_mutex;
+			// Wakes the thread waiting for this load when it finishes
+			std::condition_variable m_finished;
+
+			/*
+			Set the final state of this load and wake the thread waiting for it
+			Parameter: State finalState - Whether the load decoded or failed
+			*/
+			void finish(State);
+		};
+		struct CommandBuffer;
+		// A sprite submitted this frame with the key it is drawn in order of
+		struct RenderItem {
+			// The sort key of this item, from most to least significant bits
+			// the sprite's depth, the index of its shader this frame, and its
+			// texture (sprites with equal keys keep their submission order)
+			std::uint64_t key = 0;
+			// The shader to draw the sprite with
+			GLSLShader* shader = 0;
+			// The sprite to draw, or 0 if this item is a static batch group, a
+			// mesh, text, or a particle system
+			Sprite* sprite = 0;
+			// The static batch to draw a group of, or 0 if this item is a sprite
+			StaticBatch* batch = 0;
+			// The index of the group of the static batch to draw
+			size_t group = 0;
+			// The command buffer holding the mesh to draw, or 0 if this item
+			// is not a mesh
+			const CommandBuffer* commands = 0;
+			// The index of the mesh to draw in its command buffer
+			size_t mesh = 0;
+			// The text mesh to draw, or 0 if this item is not text
+			TextMesh* text = 0;
+			// The particle system to draw, or 0 if this item is not particles
+			const ParticleSystem* particles = 0;
+			// The texture of the sprite
+			const Texture* texture = 0;
+			// The texture unit the item's texture is bound to when drawn
+			unsigned int unit = 0;
+			// Whether the item is outside its shader's camera
+			bool culled = false;
+		};
+		// Text submitted to be laid out into glyphs at the end of the frame,
+		// whose strings are stored in its command buffer's text data
+		struct TextCommand {
+			// The offset of the text to draw in the text data
+			size_t textOffset = 0;
+			// The length of the text to draw
+			size_t textLength = 0;
+			// The position and depth to draw the text at
+			glm::vec3 position = glm::vec3();
+			// The bounding box to draw the text inside of
+			glm::vec4 box = glm::vec4();
+			// The scale to draw the text at
+			float scale = 1.0f;
+			// The color to draw the text in
+			glm::vec4 color = glm::vec4();
+			// The offset of the file name of the font to draw the text in in
+			// the text data
+			size_t fontOffset = 0;
+			// The length of the font's file name
+			size_t fontLength = 0;
+			// The horizontal alignment of the text inside its box
+			Alignment horizontalAlignment = NO_ALIGNMENT;
+			// The vertical alignment of the text inside its box
+			Alignment verticalAlignment = NO_ALIGNMENT;
+			// The shader to draw the text with
+			GLSLShader* shader = 0;
+		};
+		// Custom vertices submitted to be drawn as one mesh, stored in their
+		// command buffer's vertex and index data
+		struct Mesh {
+			// The shader to draw the mesh with
+			GLSLShader* shader = 0;
+			// The offset in bytes of the mesh's vertices in the vertex data
+			size_t vertexOffset = 0;
+			// The size in bytes of the mesh's vertices
+			size_t vertexBytes = 0;
+			// The index of the mesh's first index in the index data
+			size_t indexOffset = 0;
+			// The number of indices of the mesh
+			size_t indexCount = 0;
+			// The depth to draw the mesh at
+			float depth = 0.0f;
+			// The file name of the mesh's texture
+			std::string textureFileName = "";
+		};
+		// The work submitted by one thread in the current frame
+		struct CommandBuffer {
+			// The sprites submitted by the thread
+			std::vector<RenderItem> items;
+			// The text submitted by the thread
+			std::vector<TextCommand> text;
+			// The characters of the text and font file names submitted by the
+			// thread
+			std::vector<char> textData;
+			// The static batches submitted by the thread
+			std::vector<StaticBatch*> batches;
+			// The tile maps submitted by the thread
+			std::vector<TileMap*> tileMaps;
+			// The particle systems submitted by the thread
+			std::vector<ParticleSystem*> particleSystems;
+			// The text meshes submitted by the thread and their shaders
+			std::vector<std::pair<TextMesh*, GLSLShader*>> textMeshes;
+			// The meshes submitted by the thread
+			std::vector<Mesh> meshes;
+			// The vertices of the meshes submitted by the thread
+			std::vector<unsigned char> vertexData;
+			// The indices of the meshes submitted by the thread
+			std::vector<unsigned int> indexData;
+			// Whether the thread has exited, so this buffer is freed once its
+			// commands have been drawn
+			bool released = false;
+		};
+		// The command buffer of a thread, which is released when the thread
+		// exits so that graphics managers do not keep the buffers of threads
+		// that have finished
+		struct LocalCommandBufferSlot {
+			// The thread's command buffer, or 0 if it has not submitted
+			CommandBuffer* buffer = 0;
+			// The graphics manager the thread's command buffer belongs to
+			GraphicsManager* owner = 0;
+			// The generation of the graphics manager the buffer belongs to
+			unsigned int generation = 0;
+
+			/*
+			Release the thread's command buffer to its graphics manager
+			*/
+			~LocalCommandBufferSlot();
+			/*
+			Mark the thread's command buffer to be freed by its graphics
+			manager once its commands have been drawn, and forget it
+			*/
+			void release();
+		};
+		// A text layout kept for reuse by text submitted by string
+		struct CachedText {
+			// The hash of the text, font, and properties the layout was made
+			// for
+			std::uint64_t hash = 0;
+			// The laid out text
+			TextMesh mesh;
+			// The frame the layout was last drawn in
+			unsigned int frame = 0;
+		};
+		// Culls the sprites submitted this frame and generates their vertices
+		// across the worker pool
+		class PrepareTask : public ParallelTask {
+		public:
+			// The graphics manager whose render items to prepare
+			GraphicsManager* manager = 0;
+
+			/*
+			Cull a range of render items and draw the visible sprites
+			Parameter: size_t first - The index of the first render item
+			Parameter: size_t last - The index after the last render item
+			*/
+			void execute(size_t, size_t) override;
+		};
+		// The parameters of one draw in a multi-draw indirect call
+		struct DrawCommand {
+			// The number of indices to draw
+			GLuint count = 0;
+			// The number of instances to draw
+			GLuint instanceCount = 1;
+			// The index of the first index to draw in the index buffer
+			GLuint firstIndex = 0;
+			// The value added to each index
+			GLint baseVertex = 0;
+			// The index of the first instance to draw
+			GLuint baseInstance = 0;
+		};
+		// A linked shader program shared by every shader compiled from the
+		// same source code
+		struct Program {
+			// The OpenGL ID of the program
+			GLuint ID = 0;
+			// The vertex shader source code the program was compiled from
+			std::string vertexShaderSource = "";
+			// The fragment shader source code the program was compiled from
+			std::string fragmentShaderSource = "";
+			// The number of shaders using the program
+			unsigned int references = 0;
+		};
+		// The FreeType face of a loaded font, kept open to rasterize its
+		// glyphs as they are first drawn, and the atlas they are packed into
+		struct FontFace {
+			// The FreeType face of the font
+			FT_Face face = 0;
+			// The atlas of the font's glyph images
+			GlyphAtlas atlas;
+		};
+
+		// Allow the Camera class access to private memory
+		friend class Camera;
+		// Allow the GLSLShader class access to private memory
+		friend class GLSLShader;
+		// Allow the ParticleSystem class access to private memory
+		friend class ParticleSystem;
+		// Allow the RenderTarget class access to private memory
+		friend class RenderTarget;
 		// Allow the UITextBox class access to private memory
 		friend class UITextBox;
 		// Allow the UIPasswordBox class access to private memory
@@ -393,53 +1994,519 @@ namespace ActiasFW {
 		friend class UITextArea;
 		// Whether this graphics manager has been initialized
 		bool m_initialized = false;
-		// The ID of the OpenGL vertex array object used to draw graphics
+		// The ID of the OpenGL vertex array object used to draw instanced
+		// graphics
 		GLuint m_VAOID = 0;
-		// The ID of the OpenGL vertex buffer object used to draw graphics
-		GLuint m_VBOID = 0;
-		// The ID of the OpenGL index buffer object used to draw graphics
-		GLuint m_IBOID = 0;
+		// The vertex array objects reading the stream buffers with each vertex
+		// layout drawn so far, so switching shaders never respecifies vertex
+		// attributes
+		std::map<VertexLayout, GLuint> m_vertexArrays;
+		// The OpenGL state bound by this graphics manager
+		GLStateCache m_state;
+		// The buffer vertex data is streamed to OpenGL through
+		StreamBuffer m_vertexStream;
+		// The buffer index data is streamed to OpenGL through
+		StreamBuffer m_indexStream;
+		// The vertices of particles expanded before they are mapped into their
+		// texture's atlas page and copied into the vertex stream
+		std::vector<float> m_particleVertices;
+		// The buffer multi-draw indirect commands are streamed to OpenGL
+		// through, if OpenGL 4.3 or ARB_multi_draw_indirect is available
+		StreamBuffer m_indirectStream;
+		// The shader programs compiled by this graphics manager by the hash of
+		// their source code
+		std::map<std::uint64_t, Program> m_programs;
+		// The directory linked shader program binaries are saved to
+		std::string m_shaderCacheDirectory = "";
+		// Whether shader program binaries are saved and loaded
+		bool m_programBinaries = false;
+		// The ID of the compute program moving and compacting particles
+		// simulated on the GPU, or 0 if compute shaders are unavailable
+		GLuint m_particleSimulationProgram = 0;
+		// The ID of the compute program appending spawned particles
+		GLuint m_particleEmissionProgram = 0;
+		// The ID of the compute program expanding particles into vertices
+		GLuint m_particleExpansionProgram = 0;
+		// The ID of the uniform buffer holding every camera's matrix
+		GLuint m_cameraBufferID = 0;
+		// The size in bytes of each camera's slot in the camera buffer, aligned
+		// for binding by range
+		GLsizeiptr m_cameraSlotSize = 0;
+		// The number of slots allocated in the camera buffer
+		size_t m_cameraSlotCount = 0;
+		// The slot of each camera in the camera buffer
+		std::map<const Camera*, size_t> m_cameraSlots;
+		// The slots of the camera buffer freed by destroyed cameras
+		std::vector<size_t> m_freeCameraSlots;
+		// The camera whose slot is bound to the camera binding point
+		const Camera* m_boundCamera = 0;
+		// The textures used by the run of items currently being drawn, in
+		// order of texture unit
+		std::vector<GLuint> m_runTextures;
+		// The index counts of the static groups in a multi-draw call
+		std::vector<GLsizei> m_multiDrawCounts;
+		// The index buffer offsets of the static groups in a multi-draw call
+		std::vector<const void*> m_multiDrawOffsets;
 		// The set of textures loaded by OpenGL
-		std::map<std::string, GLuint> m_textures;
-		// The set of sprites submitted to be drawn in the current frame
-		std::vector<std::pair<GLSLShader*, Sprite*>> m_sprites;
+		std::map<std::string, Texture> m_textures;
+		// The textures being loaded on the worker threads
+		std::map<std::string, TextureLoad> m_textureLoads;
+		// The transparent texture drawn in place of textures still loading
+		Texture m_placeholderTexture;
+		// The pixel buffer texture data is uploaded to OpenGL through
+		StreamBuffer m_pixelStream;
+		// The number of bytes of texture data uploaded each frame
+		size_t m_textureUploadBudget = 0;
+		// The atlas small textures are packed into
+		TextureAtlas m_atlas;
+		// The textures loaded without the atlas so that they repeat
+		std::set<std::string> m_repeatedTextures;
+		// The named frames of each texture with a frame file
+		std::map<std::string, std::vector<std::pair<std::string, glm::vec4>>>
+			m_textureFrames;
+		// The command buffer of each thread that has submitted to this
+		// graphics manager
+		std::list<CommandBuffer> m_commandBuffers;
+		// Guards the command buffers, which are only read and cleared while it
+		// is held
+		std::mutex m_commandBuffersMutex;
+		// The number of times this graphics manager has been destroyed, which
+		// invalidates the threads' cached command buffers
+		unsigned int m_commandBuffersGeneration = 0;
+		// The command buffer of the current thread
+		static thread_local LocalCommandBufferSlot LocalCommandBuffer;
+		// The command buffer of the render target the current thread is
+		// submitting into, or 0 if it is submitting into the window
+		static thread_local CommandBuffer* LocalTargetCommandBuffer;
+		// The command buffers of the work submitted into each render target
+		std::map<const RenderTarget*, CommandBuffer> m_targetCommandBuffers;
+		// The render targets submitted into this frame in order of first
+		// submission
+		std::vector<RenderTarget*> m_frameTargets;
+		// The threads vertex generation and texture loading are split across
+		WorkerPool m_workers;
+		// The sprites and static batch groups to be drawn in the current frame,
+		// in draw order once the frame is sorted
+		std::vector<RenderItem> m_renderItems;
+		// Scratch memory for sorting render items
+		std::vector<RenderItem> m_sortBuffer;
+		// The shaders used in the current frame in order of first use
+		std::vector<GLSLShader*> m_frameShaders;
 		// The instance of the FreeType library used by this graphics manager
 		// to draw text
 		FT_Library m_freeType = 0;
+		// Whether FreeType can render signed distance fields, fonts set to be
+		// rendered as distance fields are rasterized as bitmaps otherwise
+		bool m_distanceFields = false;
 		// The set of fonts loaded by FreeType
 		std::map<std::string, Font> m_fonts;
-		// The set of text characters submitted to be drawn in the current frame
+		// The faces and glyph atlases of the loaded fonts by file name
+		std::map<std::string, FontFace> m_fontFaces;
+		// The codepoints of the glyphs cleared from an atlas by the last
+		// glyph rasterized
+		std::vector<char32_t> m_evictedGlyphs;
+		// The renderings set for fonts which are not rasterized as bitmaps
+		std::map<std::string, Font::Rendering> m_fontRenderings;
+		// The text characters to be drawn with instanced shaders in the current
+		// frame
 		std::map<GLSLShader*, std::vector<Glyph>> m_glyphs;
+		// The text layouts kept for reuse, most recently drawn first
+		std::list<CachedText> m_textCache;
+		// The text layouts kept for reuse by the hashes of their keys
+		std::map<std::uint64_t, std::list<CachedText>::iterator>
+			m_textCacheIndex;
+		// The number of text layouts kept for reuse
+		size_t m_textCacheSize = 0;
+		// The number of frames begun by this graphics manager
+		unsigned int m_frame = 0;
 		// The default camera used by this graphics manager
 		Camera m_defaultCamera;
 		// The default shader used by this graphics manager
 		GLSLShader m_defaultShader;
+		// The default instanced shader used by this graphics manager
+		GLSLShader m_defaultInstancedShader;
+		// The statistics of the last frame drawn
+		FrameStatistics m_statistics;
+		// The trace frames are recorded into, or 0
+		FrameTrace* m_capture = 0;
 
 		/*
-		Get an OpenGL texture ID by its file name or attempt to decode it from
-		disk and load it into OpenGL
+		Get an OpenGL texture by its file name or start loading it on the worker
+		threads if it has not been seen before
+		Parameter: const std::string& fileName - The file name of the texture to
+		get
+		Returns: const Texture& - The texture, the placeholder texture if it is
+		still loading, or a texture with an ID of 0 if it could not be loaded
+		*/
+		const Texture& getTexture(const std::string&);
+		/*
+		Get an OpenGL texture by its file name, waiting for it to load and
+		uploading it immediately if it is not loaded yet
+		Parameter: const std::string& fileName - The file name of the texture to
+		get
+		Returns: const Texture& - The texture, with an ID of 0 if the texture
+		could not be loaded
+		*/
+		const Texture& requireTexture(const std::string&);
+		/*
+		Start loading a texture on the worker threads if it is not loaded or
+		loading already
 		Parameter: const std::string& fileName - The file name of the texture to
 		load
-		Returns: const GLuint - The OpenGL texture ID or 0 if the texture could
-		not be loaded
 		*/
-		const GLuint getTexture(const std::string&);
+		void loadTexture(const std::string&);
+		/*
+		Upload the textures decoded by the worker threads to OpenGL, stopping
+		once this frame's upload budget is spent
+		*/
+		void uploadTextures();
+		/*
+		Upload a finished texture load to OpenGL and add it to the set of
+		loaded textures
+		Parameter: const TextureLoad& load - The finished load
+		Returns: size_t - The number of bytes of texture data uploaded
+		*/
+		size_t finishTextureLoad(const TextureLoad&);
+		/*
+		Get the shader program compiled from a pair of sources, loading its
+		binary from the shader cache directory or compiling and linking it if
+		no shader is using it yet
+		Parameter: const std::string& vertexShaderSource - The vertex shader
+		source code
+		Parameter: const std::string& fragmentShaderSource - The fragment shader
+		source code
+		Returns: GLuint - The program's OpenGL ID, or 0 if it failed to compile
+		*/
+		GLuint acquireProgram(const std::string&, const std::string&);
+		/*
+		Stop a shader using a shader program, deleting the program once no
+		shader is using it
+		Parameter: GLuint programID - The OpenGL ID of the program
+		*/
+		void releaseProgram(GLuint);
+		/*
+		Compile and link a shader program
+		Parameter: const std::string& vertexShaderSource - The vertex shader
+		source code
+		Parameter: const std::string& fragmentShaderSource - The fragment shader
+		source code
+		Returns: GLuint - The program's OpenGL ID, or 0 if it failed to compile
+		*/
+		GLuint linkProgram(const std::string&, const std::string&);
+		/*
+		Compile and link a compute shader program
+		Parameter: const std::string& computeShaderSource - The compute shader
+		source code
+		Returns: GLuint - The program's OpenGL ID, or 0 if it failed to compile
+		*/
+		GLuint linkComputeProgram(const std::string&);
+		/*
+		Load a linked shader program's binary from the shader cache directory
+		Parameter: std::uint64_t hash - The hash of the program's sources
+		Returns: GLuint - The program's OpenGL ID, or 0 if no binary was saved
+		or the driver rejected it
+		*/
+		GLuint loadProgramBinary(std::uint64_t);
+		/*
+		Save a linked shader program's binary to the shader cache directory
+		Parameter: std::uint64_t hash - The hash of the program's sources
+		Parameter: GLuint programID - The program's OpenGL ID
+		*/
+		void saveProgramBinary(std::uint64_t, GLuint);
+		/*
+		Get the file name of a shader program's binary
+		Parameter: std::uint64_t hash - The hash of the program's sources
+		Returns: std::string - The binary's file name
+		*/
+		std::string getProgramBinaryFileName(std::uint64_t) const;
+		/*
+		Hash the source code of a shader program
+		Parameter: const std::string& vertexShaderSource - The vertex shader
+		source code
+		Parameter: const std::string& fragmentShaderSource - The fragment shader
+		source code
+		Returns: std::uint64_t - The hash of the sources
+		*/
+		static std::uint64_t HashSources(const std::string&,
+			const std::string&);
+		/*
+		Continue a 64-bit FNV-1a hash over a block of memory
+		Parameter: std::uint64_t hash - The hash of the preceding memory
+		Parameter: const void* data - The memory to hash
+		Parameter: size_t size - The size in bytes of the memory
+		Returns: std::uint64_t - The hash including the memory
+		*/
+		static std::uint64_t HashBytes(std::uint64_t, const void*, size_t);
+		/*
+		Write a camera's matrix to its slot in the camera buffer, giving it a
+		slot if it has none
+		Parameter: const Camera& camera - The camera to write
+		*/
+		void updateCamera(const Camera&);
+		/*
+		Bind a camera's slot of the camera buffer to the camera binding point
+		Parameter: const Camera& camera - The camera to bind
+		*/
+		void bindCamera(const Camera&);
+		/*
+		Free a camera's slot in the camera buffer
+		Parameter: const Camera& camera - The camera to free the slot of
+		*/
+		void releaseCamera(const Camera&);
+		/*
+		Register a render target's texture under its name so sprites can be
+		drawn with it
+		Parameter: const RenderTarget& target - The render target to register
+		*/
+		void addTarget(const RenderTarget&);
+		/*
+		Remove a render target's texture and the work submitted into it
+		Parameter: const RenderTarget& target - The render target to remove
+		*/
+		void releaseTarget(const RenderTarget&);
+		/*
+		Reallocate the camera buffer with a number of slots and write every
+		camera's matrix to it
+		Parameter: size_t slotCount - The number of slots to allocate
+		*/
+		void resizeCameraBuffer(size_t);
 		/*
 		Get a font from memory or attempt to load it from disk with the
-		FreeType library
+		FreeType library, loading the metrics of its ASCII glyphs and leaving
+		every glyph's image to be rasterized when it is first drawn
 		Parameter: const std::string& fileName - The file name of the font to
 		load
-		Returns: const Font* - A pointer to the font or 0 if the font could not
-		be loaded
+		Returns: Font* - A pointer to the font or 0 if the font could not be
+		loaded
 		*/
-		const Font* getFont(const std::string&);
+		Font* getFont(const std::string&);
 		/*
-		Draw a set of indices of a set of vertices with OpenGL
-		Parameter: const std::vector<unsigned int>& indices - The indices of the
-		vertex data to draw
-		Parameter: const std::vector<float>& vertices - The vertex data to draw
+		Get the metrics of a codepoint's glyph in a font, loading them from
+		the font's face if they have not been
+		Parameter: Font& font - The font to get the glyph of
+		Parameter: char32_t codepoint - The codepoint of the glyph
+		Returns: GlyphMetrics& - The glyph's metrics, which are empty if the
+		face could not load the glyph
+		*/
+		GlyphMetrics& getGlyph(Font&, char32_t);
+		/*
+		Rasterize a glyph's image into its font's atlas, clearing the images of
+		the glyphs of the page it replaces if the atlas is full
+		Parameter: Font& font - The font of the glyph
+		Parameter: char32_t codepoint - The codepoint of the glyph
+		Parameter: GlyphMetrics& glyph - The glyph's metrics, whose image is
+		set if it was rasterized
+		Returns: bool - Whether the glyph's image was rasterized into the atlas
+		*/
+		bool rasterizeGlyph(Font&, char32_t, GlyphMetrics&);
+		/*
+		Get the command buffer of the calling thread, creating it the first
+		time the thread submits to this graphics manager
+		Returns: CommandBuffer& - The calling thread's command buffer
+		*/
+		CommandBuffer& getCommandBuffer();
+		/*
+		Clear the work submitted into a command buffer, keeping its memory
+		Parameter: CommandBuffer& buffer - The command buffer to clear
+		*/
+		static void ClearCommandBuffer(CommandBuffer&);
+		/*
+		Add the work submitted into a command buffer to this frame's render
+		items, laying out its text and baking its static batches
+		Parameter: CommandBuffer& buffer - The command buffer to merge
+		*/
+		void mergeCommandBuffer(CommandBuffer&);
+		/*
+		Cull, sort, and draw this frame's render items into the bound
+		framebuffer
+		*/
+		void drawRenderItems();
+		/*
+		Record the work submitted by every thread this frame into the capture
+		trace
+		*/
+		void captureFrame();
+		/*
+		Lay out a text mesh's text into the quads of its glyphs, laying it out
+		again if its font's glyph atlas changed meanwhile, and keeping a stale
+		layout to be redone next frame after TextLayoutAttempts tries
+		Parameter: TextMesh& mesh - The text mesh to lay out
+		*/
+		void layoutText(TextMesh&);
+		/*
+		Lay out a text mesh's text into the quads of its glyphs once
+		Parameter: TextMesh& mesh - The text mesh to lay out
+		Returns: bool - Whether the font's glyph atlas was unchanged by the
+		layout, so the texture coordinates of every glyph are current
+		*/
+		bool layoutTextOnce(TextMesh&);
+		/*
+		Get the cached layout of text submitted by string, laying it out and
+		evicting the least recently drawn layout not drawn this frame if it
+		is not cached
+		Parameter: const CommandBuffer& buffer - The command buffer holding the
+		text's strings
+		Parameter: const TextCommand& command - The submitted text
+		Returns: TextMesh& - The text's layout
+		*/
+		TextMesh& getCachedText(const CommandBuffer&, const TextCommand&);
+		/*
+		Add the render items drawing a laid out text mesh this frame
+		Parameter: TextMesh& mesh - The text to draw
+		Parameter: GLSLShader* shader - The shader to draw the text with
+		*/
+		void addText(TextMesh&, GLSLShader*);
+		/*
+		Get the rectangle bounding a sprite, bounding rotated sprites by the
+		circle they rotate in
+		Parameter: const Sprite& sprite - The sprite to bound
+		Returns: glm::vec4 - The sprite's bounding rectangle (x, y, width,
+		height)
+		*/
+		glm::vec4 getBounds(const Sprite&) const;
+		/*
+		Test whether any part of a rectangle is inside the visible rectangle of
+		a camera
+		Parameter: const glm::vec4& bounds - The rectangle to test (x, y, width,
+		height)
+		Parameter: const Camera& camera - The camera to test against
+		Returns: bool - Whether the rectangle may be visible through the camera
+		*/
+		bool isVisible(const glm::vec4&, const Camera&) const;
+		/*
+		Bake the sprites of a static batch into its buffers, grouped by depth
+		and texture
+		Parameter: StaticBatch& batch - The batch to bake
+		*/
+		void bake(StaticBatch&);
+		/*
+		Bake the tiles of a chunk of a tile map into the chunk's buffers,
+		merging rectangles of one tile into one quad where its texture repeats
+		Parameter: TileMap& map - The map the chunk belongs to
+		Parameter: TileMap::Chunk& chunk - The chunk to bake
+		*/
+		void bake(TileMap&, TileMap::Chunk&);
+		/*
+		Start a new group of a static batch being baked, giving its texture a
+		unit in one of the batch's texture sets
+		Parameter: StaticBatch& batch - The batch being baked
+		Parameter: float depth - The depth of the group
+		Parameter: const std::string& textureFileName - The file name of the
+		group's texture
+		Parameter: const Texture& texture - The group's texture
+		Parameter: const glm::vec4& bounds - The rectangle bounding the group's
+		first quad (x, y, width, height)
+		Parameter: unsigned int firstIndex - The index of the group's first
+		index in the batch's index buffer
+		*/
+		void addStaticGroup(StaticBatch&, float, const std::string&,
+			const Texture&, const glm::vec4&, unsigned int);
+		/*
+		Upload the vertices and indices of a baked static batch to its buffers
+		and mark it clean
+		Parameter: StaticBatch& batch - The batch being baked
+		Parameter: const std::vector<float>& vertices - The batch's vertices
+		Parameter: const std::vector<unsigned int>& indices - The batch's
+		indices
+		*/
+		void uploadBatch(StaticBatch&, const std::vector<float>&,
+			const std::vector<unsigned int>&);
+		/*
+		Add the render items drawing each group of a baked static batch this
+		frame
+		Parameter: StaticBatch& batch - The batch to draw
+		*/
+		void addStaticGroups(StaticBatch&);
+		/*
+		Get the smallest rectangle enclosing two rectangles
+		Parameter: const glm::vec4& a - The first rectangle (x, y, width,
+		height)
+		Parameter: const glm::vec4& b - The second rectangle (x, y, width,
+		height)
+		Returns: glm::vec4 - The enclosing rectangle (x, y, width, height)
+		*/
+		static glm::vec4 Enclose(const glm::vec4&, const glm::vec4&);
+		/*
+		Copy the vertices of sprites into vertex memory, mapping their texture
+		coordinates into their texture's atlas page and encoding their texture
+		unit into their mode in a single pass, so that write-only vertex memory
+		is never read back
+		Parameter: const std::vector<float>& source - The vertices to copy
+		Parameter: const Texture& texture - The texture of the sprites
+		Parameter: unsigned int unit - The texture unit the sprites' texture is
+		bound to
+		Parameter: float* vertices - The vertex memory to copy to
+		*/
+		void copyVertices(const std::vector<float>&, const Texture&,
+			unsigned int, float*) const;
+		/*
+		Build the sort key of an item submitted this frame
+		Parameter: GLSLShader* shader - The shader to draw the item with
+		Parameter: float depth - The depth of the item
+		Parameter: const Texture& texture - The texture of the item
+		Returns: std::uint64_t - The item's sort key
+		*/
+		std::uint64_t getSortKey(GLSLShader*, float, const Texture&);
+		/*
+		Sort this frame's render items by key, keeping the submission order of
+		items with equal keys, with an insertion sort if they are already
+		almost in order and an LSD radix sort otherwise
+		*/
+		void sortRenderItems();
+		/*
+		Write a range of the sprites and meshes submitted this frame into the
+		stream buffers and draw them with OpenGL, splitting the range into as
+		many draw calls as the stream buffers' capacities require
+		Parameter: size_t first - The index of the first sprite to draw
+		Parameter: size_t last - The index after the last sprite to draw
+		Parameter: unsigned int stride - The size in bytes of one vertex
+		*/
+		void draw(size_t, size_t, unsigned int);
+		/*
+		Expand the particles of a particle system submitted this frame directly
+		into the stream buffers with the quad kernel and draw them, in as many
+		draw calls as the stream buffers' capacities require
+		Parameter: const RenderItem& item - The particle system's render item
+		Parameter: unsigned int stride - The size in bytes of one vertex, which
+		must be the size of a sprite's vertex
+		*/
+		void drawParticles(const RenderItem&, unsigned int);
+		/*
+		Expand the particles of a particle system simulated on the GPU into
+		its vertex buffer with the expansion compute shader and draw them with
+		one indirect draw call
+		Parameter: const RenderItem& item - The particle system's render item
+		*/
+		void drawSimulatedParticles(const RenderItem&);
+		/*
+		Bind textures to the first texture units, skipping units which already
+		have their texture bound
+		Parameter: const std::vector<GLuint>& textures - The textures to bind
+		in order of texture unit
+		*/
+		void bindTextures(const std::vector<GLuint>&);
+		/*
+		Bind the vertex array object a shader draws with, creating and caching
+		one for its vertex layout the first time the layout is drawn
+		Parameter: const GLSLShader& shader - The shader to bind the vertex
+		array object of
+		*/
+		void bindVertexArray(const GLSLShader&);
+		/*
+		Draw a range of groups of one static batch from its buffers in a single
+		multi-draw call
+		Parameter: size_t first - The index of the first group's render item
+		Parameter: size_t last - The index after the last group's render item
+		*/
+		void drawStaticGroups(size_t, size_t);
+		/*
+		Write a range of the sprites submitted this frame into the stream
+		buffer as instance records and draw them with the bound instanced shader
+		Parameter: size_t first - The index of the first sprite to draw
+		Parameter: size_t last - The index after the last sprite to draw
+		Parameter: GLSLShader& shader - The instanced shader to draw with
 		*/
-		void draw(const std::vector<unsigned int>&, const std::vector<float>&);
+		void drawInstances(size_t, size_t, GLSLShader&);
 	};
 }
 
@@ -31,9 +31,9 @@ namespace ActiasFW {
 		virtual void keyReleased(KeyCode);
 		/*
 		A character has been typed on the keyboard
-		Parameter: char - The character typed
+		Parameter: char32_t - The Unicode codepoint of the character typed
 		*/
-		virtual void characterTyped(char);
+		virtual void characterTyped(char32_t);
 		/*
 		A button has been pressed on the mouse
 		Parameter: MouseButtonCode - The button pressed
@@ -311,9 +311,10 @@ namespace ActiasFW {
 		void releaseKey(KeyCode);
 		/*
 		Notify input listeners that a character has been typed on the keyboard
-		Parameter: char character - The character typed
+		Parameter: char32_t codepoint - The Unicode codepoint of the character
+		typed
 		*/
-		void typeCharacter(char);
+		void typeCharacter(char32_t);
 		/*
 		GLFW callback function for keyboard key events
 		Parameter: GLFWwindow* window - The GLFW window handle which triggered
@@ -0,0 +1,59 @@
+/*
+File:		OpenGL.h
+Author:		Keegan MacDonald (keeganm742@gmail.com)
+Created:	2026.10.17@21:10
+Purpose:	Includes the OpenGL API for the platform being built for, through
+			GLEW on Windows and the system's OpenGL library elsewhere, and
+			contains the loader reporting what the current context supports
+*/
+
+#ifndef ACTIASFW_OPENGL_H
+#define ACTIASFW_OPENGL_H
+
+#ifdef _WIN32
+#include <GL/glew.h>
+#else
+// The system's OpenGL library dispatches every core function to whichever
+// context is current, whether it was created through GLX or EGL, so only
+// extension functions need to be loaded
+#define GL_GLEXT_PROTOTYPES
+#include <GL/gl.h>
+#include <GL/glext.h>
+#endif
+
+namespace ActiasFW {
+	// Loads the OpenGL functions of the current context and reports which
+	// versions and extensions it supports
+	class OpenGL {
+	public:
+		/*
+		Load the OpenGL functions of the current context
+		Returns: bool - Whether a context is current and its functions were
+		loaded
+		*/
+		static bool Load();
+		/*
+		Test whether the current context supports an OpenGL version
+		Parameter: int major - The major version number
+		Parameter: int minor - The minor version number
+		Returns: bool - Whether the context's version is at least the given
+		version
+		*/
+		static bool IsVersionSupported(int, int);
+		/*
+		Test whether the current context supports an OpenGL extension
+		Parameter: const char* extension - The name of the extension (i.e.
+		GL_ARB_buffer_storage)
+		Returns: bool - Whether the context supports the extension
+		*/
+		static bool IsExtensionSupported(const char*);
+		/*
+		Let the driver compile shaders on as many threads as it chooses, if it
+		supports parallel shader compilation
+		Returns: bool - Whether shaders will be compiled in parallel
+		*/
+		static bool EnableParallelShaderCompilation();
+	};
+}
+
+#endif
@@ -0,0 +1,326 @@
+/*
+File:		Particles.h
+Author:		Keegan MacDonald (keeganm742@gmail.com)
+Created:	2026.10.17@18:40
+Purpose:	Contains a particle system storing its particles as arrays of their
+			properties, which are spawned by emitters and either simulated on
+			the CPU and drawn as quads expanded directly into the graphics
+			manager's stream buffer, or simulated and drawn entirely on the GPU
+*/
+
+#ifndef ACTIASFW_PARTICLES_H
+#define ACTIASFW_PARTICLES_H
+
+#include "Graphics.h"
+#include "QuadKernel.h"
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace ActiasFW {
+	// The ranges of the properties of the particles spawned by one emitter of
+	// a particle system, each property is chosen uniformly between its
+	// minimum and maximum for each particle
+	struct ParticleEmitter {
+		// The rectangle particles are spawned in (x, y, width, height)
+		glm::vec4 area = glm::vec4();
+		// The number of particles spawned each frame, which may be fractional
+		float rate = 0.0f;
+		// The shortest and longest lifetimes of the particles in frames
+		glm::vec2 lifeTime = glm::vec2(60.0f, 60.0f);
+		// The smallest and largest widths and heights of the particles
+		glm::vec2 size = glm::vec2(1.0f, 1.0f);
+		// The lowest velocity of the particles in units per frame
+		glm::vec2 minimumVelocity = glm::vec2();
+		// The highest velocity of the particles in units per frame
+		glm::vec2 maximumVelocity = glm::vec2();
+		// Whether this emitter spawns particles as the system updates
+		bool enabled = true;
+	};
+
+	// A fixed number of particles stored as one array per property, updated
+	// together by loops the compiler can vectorize and recycled by moving the
+	// last particle into the place of each one that dies, or held in shader
+	// storage buffers and updated by compute shaders
+	class ParticleSystem {
+	public:
+		// The ways a particle system's particles can be simulated
+		enum Simulation {
+			// Updated by the CPU and expanded into the stream buffer each
+			// frame they are drawn
+			SIMULATION_CPU,
+			// Updated, compacted, and expanded into vertices by compute
+			// shaders and drawn indirectly, so they are never read back by the
+			// CPU, which requires OpenGL 4.3
+			SIMULATION_GPU,
+		};
+
+		/*
+		Initialize this particle system's memory
+		Parameter: size_t capacity - The most particles alive at once, further
+		particles are not spawned until others die
+		Parameter: float depth - The depth to draw the particles at
+		Parameter: const std::string& textureFileName - The file name of the
+		particles' texture, or empty to draw them untextured
+		Parameter: unsigned int frameCount - The number of frames the texture
+		is split into from left to right, played once over each particle's
+		lifetime
+		Parameter: GLSLShader& shader - The shader to draw the particles with,
+		which must not be instanced and must use the default vertex layout
+		Parameter: Simulation simulation - Where to simulate the particles,
+		particles are simulated on the CPU if compute shaders are unavailable
+		Returns: bool - Whether this particle system was initialized
+		successfully
+		*/
+		bool initialize(size_t, float, const std::string&, unsigned int,
+			GLSLShader&, Simulation = SIMULATION_CPU);
+		/*
+		Add an emitter spawning particles into this system
+		Parameter: const ParticleEmitter& emitter - The emitter to add
+		Returns: unsigned int - The index of the emitter in this system
+		*/
+		unsigned int addEmitter(const ParticleEmitter&);
+		/*
+		Get an emitter of this particle system to change how it spawns
+		particles
+		Parameter: unsigned int index - The index of the emitter
+		Returns: ParticleEmitter& - The emitter
+		*/
+		ParticleEmitter& getEmitter(unsigned int);
+		/*
+		Spawn a number of particles from an emitter at once, particles
+		simulated on the GPU are spawned at the next update
+		Parameter: unsigned int index - The index of the emitter
+		Parameter: size_t count - The number of particles to spawn
+		*/
+		void emit(unsigned int, size_t);
+		/*
+		Move, age, and animate every particle, remove the particles which have
+		died, and spawn particles from the enabled emitters
+		Parameter: float timeStep - The number of frames elapsed since the last
+		update
+		*/
+		void update(float);
+		/*
+		Remove every particle from this system
+		*/
+		void clear();
+		/*
+		Free this particle system's memory
+		Returns: bool - Whether this particle system was freed successfully
+		*/
+		bool destroy();
+		/*
+		Get the acceleration of every particle in this system
+		Returns: const glm::vec2& - The particles' acceleration in units per
+		frame per frame
+		*/
+		const glm::vec2& getAcceleration() const;
+		/*
+		Set the acceleration of every particle in this system
+		Parameter: const glm::vec2& acceleration - The particles' new
+		acceleration in units per frame per frame
+		*/
+		void setAcceleration(const glm::vec2&);
+		/*
+		Get the number of frames after which each particle's horizontal
+		velocity reverses, making it sway from side to side
+		Returns: float - The particles' sway time, or 0 if they do not sway
+		*/
+		float getSwayTime() const;
+		/*
+		Set the number of frames after which each particle's horizontal
+		velocity reverses
+		Parameter: float swayTime - The particles' new sway time, or 0 to stop
+		them swaying
+		*/
+		void setSwayTime(float);
+		/*
+		Set the colors particles fade between over their lifetimes
+		Parameter: const glm::vec4& startColor - The color of particles when
+		they are spawned (RGBA)
+		Parameter: const glm::vec4& endColor - The color of particles when they
+		die (RGBA)
+		*/
+		void setColors(const glm::vec4&, const glm::vec4&);
+		/*
+		Seed the random number generator particles are spawned with
+		Parameter: std::uint32_t seed - The new seed, which must not be 0
+		*/
+		void setSeed(std::uint32_t);
+		/*
+		Get where this system's particles are simulated
+		Returns: Simulation - Where the particles are simulated
+		*/
+		Simulation getSimulation() const;
+		/*
+		Get the properties of the live particles as sprites for the quad kernel
+		Returns: const QuadBatch& - The live particles, which are empty if they
+		are simulated on the GPU
+		*/
+		const QuadBatch& getParticles() const;
+		/*
+		Get the number of live particles in this system
+		Returns: size_t - The number of live particles, or if they are
+		simulated on the GPU the number that may be alive
+		*/
+		size_t getCount() const;
+		/*
+		Get the most particles this system can hold at once
+		Returns: size_t - This system's capacity
+		*/
+		size_t getCapacity() const;
+		/*
+		Get the depth the particles are drawn at
+		Returns: float - The particles' depth
+		*/
+		float getDepth() const;
+		/*
+		Get the file name of the particles' texture
+		Returns: const std::string& - The particles' texture file name
+		*/
+		const std::string& getTextureFileName() const;
+		/*
+		Get the shader the particles are drawn with
+		Returns: GLSLShader& - The particles' shader
+		*/
+		GLSLShader& getShader();
+
+	private:
+		// The number of floats of each particle's state in the GPU buffers,
+		// its position, velocity, age, lifetime, sway timer, and size
+		static const size_t StateSize = 8;
+		// The number of particles each compute shader work group simulates
+		static const size_t WorkGroupSize = 64;
+
+		// Allow the GraphicsManager class access to private memory
+		friend class GraphicsManager;
+		// Where the particles are simulated
+		Simulation m_simulation = SIMULATION_CPU;
+		// The properties of the live particles as drawn
+		QuadBatch m_particles;
+		// The horizontal velocities of the live particles
+		std::vector<float> m_velocityX;
+		// The vertical velocities of the live particles
+		std::vector<float> m_velocityY;
+		// The number of frames each live particle has been alive
+		std::vector<float> m_age;
+		// The number of frames each live particle lives for
+		std::vector<float> m_lifeTime;
+		// The number of frames since each live particle's horizontal velocity
+		// last reversed
+		std::vector<float> m_swayTimer;
+		// The most particles alive at once
+		size_t m_capacity = 0;
+		// The depth to draw the particles at
+		float m_depth = 0.0f;
+		// The file name of the particles' texture
+		std::string m_textureFileName = "";
+		// The number of frames the texture is split into
+		unsigned int m_frameCount = 1;
+		// The shader to draw the particles with
+		GLSLShader* m_shader = 0;
+		// The emitters spawning particles into this system
+		std::vector<ParticleEmitter> m_emitters;
+		// The fraction of a particle each emitter has yet to spawn
+		std::vector<float> m_spawnRemainders;
+		// The acceleration of every particle
+		glm::vec2 m_acceleration = glm::vec2();
+		// The number of frames after which particles' horizontal velocities
+		// reverse, or 0
+		float m_swayTime = 0.0f;
+		// The color of particles when they are spawned
+		glm::vec4 m_startColor = glm::vec4(1.0f, 1.0f, 1.0f, 1.0f);
+		// The color of particles when they die
+		glm::vec4 m_endColor = glm::vec4(1.0f, 1.0f, 1.0f, 1.0f);
+		// The state of the xorshift random number generator
+		std::uint32_t m_random = 2463534242u;
+		// The IDs of the OpenGL buffers holding the particles' states on the
+		// GPU, one holding the live particles and the other receiving the
+		// survivors of the next update
+		GLuint m_stateBufferIDs[2] = { 0, 0, };
+		// The index of the state buffer holding the live particles
+		GLuint m_source = 0;
+		// The ID of the OpenGL buffer holding the number of particles in each
+		// state buffer
+		GLuint m_countBufferID = 0;
+		// The ID of the OpenGL buffer the particles spawned each update are
+		// uploaded to
+		GLuint m_spawnBufferID = 0;
+		// The ID of the OpenGL buffer the live particles' vertices are
+		// expanded into
+		GLuint m_vertexBufferID = 0;
+		// The ID of the OpenGL buffer holding the indirect draw command whose
+		// vertex count is written by the expansion shader
+		GLuint m_commandBufferID = 0;
+		// The ID of the OpenGL vertex array object reading the vertex buffer
+		GLuint m_VAOID = 0;
+		// The states of the particles spawned since the last GPU update
+		std::vector<float> m_spawns;
+		// The most particles that may be alive on the GPU
+		size_t m_count = 0;
+
+		/*
+		Get the source code of the compute shader moving the live particles
+		and copying the survivors into the other state buffer
+		Returns: std::string - The simulation shader's source code
+		*/
+		static std::string GetSimulationShaderSource();
+		/*
+		Get the source code of the compute shader appending spawned particles
+		to the live particles
+		Returns: std::string - The emission shader's source code
+		*/
+		static std::string GetEmissionShaderSource();
+		/*
+		Get the source code of the compute shader expanding the live particles
+		into vertices and writing the number of vertices into the indirect
+		draw command
+		Returns: std::string - The expansion shader's source code
+		*/
+		static std::string GetExpansionShaderSource();
+		/*
+		Allocate the OpenGL buffers the particles are simulated in on the GPU
+		*/
+		void initializeBuffers();
+		/*
+		Free the OpenGL buffers the particles are simulated in on the GPU
+		*/
+		void destroyBuffers();
+		/*
+		Move, age, and animate the particles on the CPU and remove the
+		particles which have died
+		Parameter: float timeStep - The number of frames elapsed since the last
+		update
+		*/
+		void simulateCPU(float);
+		/*
+		Update the particles on the GPU by moving the live particles into the
+		other state buffer and appending the particles spawned since the last
+		update
+		Parameter: float timeStep - The number of frames elapsed since the last
+		update
+		*/
+		void simulateGPU(float);
+		/*
+		Spawn one particle from an emitter if there is room for it
+		Parameter: const ParticleEmitter& emitter - The emitter to spawn from
+		*/
+		void spawn(const ParticleEmitter&);
+		/*
+		Remove a particle by moving the last live particle into its place
+		Parameter: size_t index - The index of the particle to remove
+		*/
+		void remove(size_t);
+		/*
+		Get the next random number between two bounds
+		Parameter: float minimum - The lowest number to return
+		Parameter: float maximum - The highest number to return
+		Returns: float - A number between the bounds
+		*/
+		float random(float, float);
+	};
+}
+
+#endif
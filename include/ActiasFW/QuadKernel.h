@@ -0,0 +1,202 @@
+/*
+File:		QuadKernel.h
+Author:		Keegan MacDonald (keeganm742@gmail.com)
+Created:	2026.10.17@11:40
+Purpose:	Contains a SIMD kernel expanding sprites stored as arrays of their
+			properties into the vertices of their quads
+*/
+
+#ifndef ACTIASFW_QUAD_KERNEL_H
+#define ACTIASFW_QUAD_KERNEL_H
+
+#include <glm/glm.hpp>
+
+#include <vector>
+
+namespace ActiasFW {
+	// A set of sprites stored as one array per property, so that the quad
+	// kernel can load the same property of several sprites at once
+	struct QuadBatch {
+		// The x coordinates of the sprites
+		std::vector<float> x;
+		// The y coordinates of the sprites
+		std::vector<float> y;
+		// The depths of the sprites
+		std::vector<float> z;
+		// The widths of the sprites
+		std::vector<float> width;
+		// The heights of the sprites
+		std::vector<float> height;
+		// The rotation angles of the sprites in degrees about their centers
+		std::vector<float> rotation;
+		// The texture boxes of the sprites, one array per component (x, y,
+		// width, height)
+		std::vector<float> textureBox[4];
+		// The colors of the sprites, one array per component (RGBA)
+		std::vector<float> color[4];
+		// The modes the fragment shader draws the sprites in
+		std::vector<float> mode;
+		// 1.0 for each sprite reflected horizontally, otherwise 0.0
+		std::vector<float> reflectedHorizontally;
+		// 1.0 for each sprite reflected vertically, otherwise 0.0
+		std::vector<float> reflectedVertically;
+
+		/*
+		Add a sprite to the end of this batch
+		Parameter: const glm::vec3& position - The position and depth of the
+		sprite
+		Parameter: const glm::vec2& dimensions - The width and height of the
+		sprite
+		Parameter: float rotation - The rotation of the sprite in degrees
+		Parameter: const glm::vec4& textureBox - The texture coordinates of the
+		sprite (x, y, width, height)
+		Parameter: const glm::vec4& color - The RGBA color of the sprite
+		Parameter: float mode - The mode the fragment shader draws the sprite in
+		Parameter: bool reflectedHorizontally - Whether the sprite's image is
+		reflected horizontally
+		Parameter: bool reflectedVertically - Whether the sprite's image is
+		reflected vertically
+		*/
+		void add(const glm::vec3&, const glm::vec2&, float, const glm::vec4&,
+			const glm::vec4&, float, bool, bool);
+		/*
+		Reserve memory for a number of sprites in every array
+		Parameter: size_t count - The number of sprites to reserve memory for
+		*/
+		void reserve(size_t);
+		/*
+		Remove a sprite from this batch by moving the last sprite into its
+		place
+		Parameter: size_t index - The index of the sprite to remove
+		*/
+		void remove(size_t);
+		/*
+		Remove every sprite from this batch
+		*/
+		void clear();
+		/*
+		Get the number of sprites in this batch
+		Returns: size_t - The number of sprites in this batch
+		*/
+		size_t size() const;
+	};
+
+	// Expands sprites into the four vertices of their quads in the layout
+	// drawn by the default shader, computing each sprite's rotation once and
+	// reflecting its image by choosing texture coordinates
+	class QuadKernel {
+	public:
+		// The instruction sets the quad kernel can be run with
+		enum Path {
+			PATH_SCALAR,
+			PATH_SSE,
+			PATH_AVX2,
+		};
+
+		// The indices of the two triangles of a quad's four vertices
+		static const unsigned int Indices[6];
+		// The number of floats written for each sprite
+		static const unsigned int FloatsPerSprite = 40;
+
+		/*
+		Get the fastest path supported by this CPU
+		Returns: Path - The fastest supported path
+		*/
+		static Path GetPath();
+		/*
+		Test whether this CPU and build support a path
+		Parameter: Path path - The path to test
+		Returns: bool - Whether the path can be run
+		*/
+		static bool IsSupported(Path);
+		/*
+		Expand a range of a batch's sprites with the fastest supported path
+		Parameter: const QuadBatch& batch - The sprites to expand
+		Parameter: size_t first - The index of the first sprite to expand
+		Parameter: size_t last - The index after the last sprite to expand
+		Parameter: float* vertices - The memory to write FloatsPerSprite floats
+		for each sprite to
+		*/
+		static void Expand(const QuadBatch&, size_t, size_t, float*);
+		/*
+		Expand a range of a batch's sprites with a path, falling back to the
+		scalar path if it is not supported
+		Parameter: const QuadBatch& batch - The sprites to expand
+		Parameter: size_t first - The index of the first sprite to expand
+		Parameter: size_t last - The index after the last sprite to expand
+		Parameter: float* vertices - The memory to write FloatsPerSprite floats
+		for each sprite to
+		Parameter: Path path - The path to run
+		*/
+		static void Expand(const QuadBatch&, size_t, size_t, float*, Path);
+		/*
+		Expand a single sprite with the scalar path
+		Parameter: const glm::vec3& position - The position and depth of the
+		sprite
+		Parameter: const glm::vec2& dimensions - The width and height of the
+		sprite
+		Parameter: float rotation - The rotation of the sprite in degrees
+		Parameter: const glm::vec4& textureBox - The texture coordinates of the
+		sprite (x, y, width, height)
+		Parameter: const glm::vec4& color - The RGBA color of the sprite
+		Parameter: float mode - The mode the fragment shader draws the sprite in
+		Parameter: bool reflectedHorizontally - Whether the sprite's image is
+		reflected horizontally
+		Parameter: bool reflectedVertically - Whether the sprite's image is
+		reflected vertically
+		Parameter: float* vertices - The memory to write FloatsPerSprite floats
+		to
+		*/
+		static void ExpandOne(const glm::vec3&, const glm::vec2&, float,
+			const glm::vec4&, const glm::vec4&, float, bool, bool, float*);
+
+	private:
+		/*
+		Query the CPU for the instruction sets a path needs
+		Parameter: Path path - The path to query for
+		Returns: bool - Whether the CPU supports the path
+		*/
+		static bool IsSupportedByCPU(Path);
+		/*
+		Write the four vertices of a quad
+		Parameter: float* vertices - The memory to write FloatsPerSprite floats
+		to
+		Parameter: const float* x - The x coordinates of the bottom left,
+		bottom right, top left, and top right corners
+		Parameter: const float* y - The y coordinates of the corners
+		Parameter: float z - The depth of the quad
+		Parameter: const float* textureCoordinates - The left and right texture
+		x coordinates then the bottom and top texture y coordinates
+		Parameter: const glm::vec4& color - The RGBA color of the quad
+		Parameter: float mode - The mode the fragment shader draws the quad in
+		*/
+		static void WriteQuad(float*, const float*, const float*, float,
+			const float*, const glm::vec4&, float);
+		/*
+		Expand a range of a batch's sprites one at a time
+		Parameter: const QuadBatch& batch - The sprites to expand
+		Parameter: size_t first - The index of the first sprite to expand
+		Parameter: size_t last - The index after the last sprite to expand
+		Parameter: float* vertices - The memory to write to
+		*/
+		static void ExpandScalar(const QuadBatch&, size_t, size_t, float*);
+		/*
+		Expand a range of a batch's sprites four at a time with SSE2
+		Parameter: const QuadBatch& batch - The sprites to expand
+		Parameter: size_t first - The index of the first sprite to expand
+		Parameter: size_t last - The index after the last sprite to expand
+		Parameter: float* vertices - The memory to write to
+		*/
+		static void ExpandSSE(const QuadBatch&, size_t, size_t, float*);
+		/*
+		Expand a range of a batch's sprites eight at a time with AVX2
+		Parameter: const QuadBatch& batch - The sprites to expand
+		Parameter: size_t first - The index of the first sprite to expand
+		Parameter: size_t last - The index after the last sprite to expand
+		Parameter: float* vertices - The memory to write to
+		*/
+		static void ExpandAVX2(const QuadBatch&, size_t, size_t, float*);
+	};
+}
+
+#endif
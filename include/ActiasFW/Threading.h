@@ -0,0 +1,124 @@
+/*
+File:		Threading.h
+Author:		Keegan MacDonald (keeganm742@gmail.com)
+Created:	2026.10.17@10:12
+Purpose:	Contains a pool of worker threads for splitting work across the
+			cores of the CPU in ActiasFW applications
+*/
+
+#ifndef ACTIASFW_THREADING_H
+#define ACTIASFW_THREADING_H
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace ActiasFW {
+	// A task which can be split by index range across the threads of a worker
+	// pool
+	class ParallelTask {
+	public:
+		/*
+		Execute this task for a range of its indices, possibly at the same time
+		as other ranges on other threads
+		Parameter: size_t first - The first index to execute this task for
+		Parameter: size_t last - The index after the last index to execute this
+		task for
+		*/
+		virtual void execute(size_t, size_t) = 0;
+	};
+
+	// A task executed once on a worker thread while the thread that queued it
+	// continues
+	class AsyncTask {
+	public:
+		/*
+		Execute this task on a worker thread
+		*/
+		virtual void execute() = 0;
+	};
+
+	// A set of threads which wait to execute parallel tasks alongside the
+	// thread that runs them, and asynchronous tasks while no parallel task is
+	// running
+	class WorkerPool {
+	public:
+		/*
+		Initialize this worker pool's memory and start its threads
+		Parameter: unsigned int workerCount - The number of threads to start in
+		addition to the thread running tasks
+		Returns: bool - Whether this worker pool was initialized successfully
+		*/
+		bool initialize(unsigned int);
+		/*
+		Execute a task for every index in a range, splitting the range into
+		chunks taken in turn by the calling thread and every worker, and wait
+		for the task to finish
+		Parameter: ParallelTask& task - The task to execute
+		Parameter: size_t count - The number of indices to execute the task for
+		Parameter: size_t grainSize - The number of indices in each chunk, tasks
+		with no more than one chunk are executed on the calling thread alone
+		*/
+		void run(ParallelTask&, size_t, size_t);
+		/*
+		Queue a task to be executed by the next idle worker, or execute it on
+		the calling thread if this pool has no workers
+		Parameter: AsyncTask& task - The task to queue, which must not be freed
+		until it has been executed
+		*/
+		void enqueue(AsyncTask&);
+		/*
+		Get the number of threads in this worker pool
+		Returns: unsigned int - The number of worker threads
+		*/
+		unsigned int getWorkerCount() const;
+		/*
+		Stop this worker pool's threads and free its memory
+		Returns: bool - Whether this worker pool was freed successfully
+		*/
+		bool destroy();
+
+	private:
+		// The threads of this worker pool
+		std::vector<std::thread> m_workers;
+		// Guards the current task and the workers' state
+		std::mutex m_mutex;
+		// Wakes the workers when a task is run or queued or the pool is
+		// destroyed
+		std::condition_variable m_taskReady;
+		// Wakes the running thread when every worker has finished its chunks
+		std::condition_variable m_taskDone;
+		// The asynchronous tasks waiting for a worker
+		std::deque<AsyncTask*> m_queue;
+		// The task currently being executed
+		ParallelTask* m_task = 0;
+		// The number of indices of the current task
+		size_t m_count = 0;
+		// The number of indices in each chunk of the current task
+		size_t m_grainSize = 1;
+		// The first index of the next chunk of the current task to execute
+		std::atomic<size_t> m_next = 0;
+		// The number of tasks run by this worker pool
+		unsigned int m_generation = 0;
+		// The number of workers executing chunks of the current task
+		unsigned int m_activeWorkers = 0;
+		// Whether the workers should exit
+		bool m_stopping = false;
+
+		/*
+		Wait for parallel and asynchronous tasks and execute them until this
+		worker pool is destroyed, workers busy with an asynchronous task join
+		parallel tasks only once it finishes
+		*/
+		void work();
+		/*
+		Take and execute chunks of the current task until none are left
+		*/
+		void executeChunks();
+	};
+}
+
+#endif
@@ -592,7 +592,19 @@ namespace ActiasFW {
 		float m_timer = 0.0f;
 		// Whether this text box was highlighted in the last update
 		bool m_lastHighlighted = false;
+		// The content text when this text box last marked its group dirty
+		std::string m_drawnText = "";
+		// The cursor's position when this text box last marked its group dirty
+		glm::vec3 m_drawnCursorPosition = glm::vec3();
+		// The horizontal text position when this text box last marked its
+		// group dirty
+		float m_drawnTextPosition = 0.0f;
 
+		/*
+		Mark this text box's group dirty if its content text, its cursor, or
+		the position of its text changed since it was last marked
+		*/
+		void markEditsDirty();
 		/*
 		Draw this text box's graphics
 		*/
@@ -612,10 +624,11 @@ namespace ActiasFW {
 		*/
 		virtual void destroy() override;
 		/*
-		Input callback for characters typed into this text box
-		Parameter: char character - The character typed
+		Input callback for characters typed into this text box, which edits
+		its content one byte per character and so accepts only ASCII
+		Parameter: char32_t codepoint - The codepoint of the character typed
 		*/
-		virtual void characterTyped(char) override;
+		virtual void characterTyped(char32_t) override;
 	};
 
 	// A password input box UI component
@@ -747,9 +760,9 @@ namespace ActiasFW {
 		virtual void destroy() override;
 		/*
 		Callback function for text typed into this text area
-		Parameter: char character - The character typed
+		Parameter: char32_t codepoint - The codepoint of the character typed
 		*/
-		virtual void characterTyped(char) override;
+		virtual void characterTyped(char32_t) override;
 
 	private:
 		/*
@@ -1043,6 +1056,11 @@ namespace ActiasFW {
 		*/
 		virtual void setController(Controller) override;
 		/*
+		One of the components controlled by this carousel has changed how it is
+		drawn, which changes how this carousel is drawn
+		*/
+		virtual void markDirty() override;
+		/*
 		Draw this carousel's graphics and its buttons
 		*/
 		virtual void draw() override;
@@ -1304,6 +1322,11 @@ namespace ActiasFW {
 		*/
 		virtual void setController(Controller) override;
 		/*
+		One of the components controlled by this list box has changed how it is
+		drawn, which changes how this list box is drawn
+		*/
+		virtual void markDirty() override;
+		/*
 		Draw this list box and its values
 		*/
 		virtual void draw() override;
@@ -82,6 +82,10 @@ namespace ActiasFW {
 		Parameter: Controller controller - This listener's new game controller
 		*/
 		virtual void setController(Controller) = 0;
+		/*
+		A component this listener controls has changed how it is drawn
+		*/
+		virtual void markDirty() = 0;
 	};
 
 	// An abstract user interface component controlled by a UI listener
@@ -224,6 +228,11 @@ namespace ActiasFW {
 		// Whether this component is currently highlighted by a game controller
 		bool m_highlighted = false;
 
+		/*
+		Tell this component's parent, if it has one, that this component has
+		changed how it is drawn
+		*/
+		void markParentDirty();
 		/*
 		Draw this components graphics
 		*/
@@ -270,7 +279,8 @@ namespace ActiasFW {
 		bool initialize(Scene&, unsigned int, const std::string&, float,
 			const glm::vec4&, Controller, const std::string&, const glm::vec2&);
 		/*
-		Draw all the components in this group if it is visible
+		Draw all the components in this group if it is visible, drawing them
+		into this group's render target first if it is cached and dirty
 		*/
 		void draw();
 		/*
@@ -441,6 +451,25 @@ namespace ActiasFW {
 		margins
 		*/
 		void setHighlightMargins(const glm::vec2&);
+		/*
+		Test whether this group is drawn from a render target holding its
+		components, which is drawn again only when they change
+		Returns: bool - Whether this group is cached
+		*/
+		bool isCached() const;
+		/*
+		Set whether this group is drawn from a render target holding its
+		components, their setters mark the group dirty but components' sprites
+		changed directly require markDirty() to be called
+		Parameter: bool cached - Whether to cache this group
+		Returns: bool - Whether this group's caching was set successfully
+		*/
+		bool setCached(bool);
+		/*
+		Draw this group's components into its render target again the next
+		time it is drawn, if it is cached
+		*/
+		void markDirty() override;
 
 	private:
 		// Whether this group has been initialized
@@ -477,6 +506,19 @@ namespace ActiasFW {
 		Sprite m_highlightSprite;
 		// The margins of the highlight sprite
 		glm::vec2 m_highlightMargins = glm::vec2();
+		// Whether this group is drawn from its render target
+		bool m_cached = false;
+		// Whether this group's components have changed since they were last
+		// drawn into its render target
+		bool m_dirty = true;
+		// The render target this group's components are drawn into, the size
+		// of the window
+		RenderTarget m_target;
+		// The sprite drawing this group's render target over the window
+		TargetSprite m_targetSprite;
+		// The rectangle visible to this group's shader's camera when its
+		// components were last drawn into its render target
+		glm::vec4 m_targetBox = glm::vec4();
 	};
 }
 
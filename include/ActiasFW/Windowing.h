@@ -8,8 +8,10 @@ Purpose:	Contains GLFW window management utility for ActiasFW applications
 #ifndef ACTIASFW_WINDOWING_H
 #define ACTIASFW_WINDOWING_H
 
+#include "OpenGL.h"
 #include <glm/glm.hpp>
 #include <string>
+#include <vector>
 #include <GLFW/glfw3.h>
 
 namespace ActiasFW {
@@ -28,13 +30,20 @@ namespace ActiasFW {
 		number of logic updates per second
 		Parameter: unsigned int maximumUpdatesPerFrame - The initial maximum
 		number of logic updates per graphical frame
+		Parameter: bool headless - Whether to draw to an offscreen framebuffer
+		with a surfaceless context instead of opening a visible window
+		Parameter: unsigned int frameLimit - The number of frames to draw before
+		this window closes (0 to draw until it is closed)
+		Parameter: const std::string& frameDumpDirectory - The directory to save
+		each drawn frame to as a PNG image (empty to disable)
 		Returns: bool - Whether the GLFW library was successfully initialized
 		and the window was opened successfully
 		*/
 		bool initialize(const glm::ivec2&, const std::string&, bool,
-			unsigned int, unsigned int);
+			unsigned int, unsigned int, bool, unsigned int, const std::string&);
 		/*
-		Update this window's graphics buffer in GLFW
+		Save the last frame if frames are being dumped and update this window's
+		graphics buffer in GLFW
 		Returns: bool - Whether this window should remain open
 		*/
 		bool update();
@@ -118,6 +127,22 @@ namespace ActiasFW {
 		number of logic updates per frame
 		*/
 		void setMaximumUpdatesPerFrame(unsigned int);
+		/*
+		Test whether this window draws to an offscreen framebuffer
+		Returns: bool - Whether this window is headless
+		*/
+		bool isHeadless() const;
+		/*
+		Get the framebuffer this window's frames are drawn to
+		Returns: GLuint - The OpenGL ID of the offscreen framebuffer, or 0 for
+		the framebuffer of a visible window
+		*/
+		GLuint getFramebuffer() const;
+		/*
+		Get the number of frames this window has started drawing
+		Returns: unsigned int - The number of frames started
+		*/
+		unsigned int getFrameCount() const;
 
 	private:
 		// Whether this window manager has been initialized
@@ -139,11 +164,40 @@ namespace ActiasFW {
 		// The maximum number of logic updates per graphics frame rendered in
 		// this window
 		unsigned int m_maximumUpdatesPerFrame = 0;
+		// Whether this window draws to an offscreen framebuffer
+		bool m_headless = false;
+		// The offscreen framebuffer of a headless window
+		GLuint m_framebuffer = 0;
+		// The color renderbuffer attached to the offscreen framebuffer
+		GLuint m_colorBuffer = 0;
+		// The number of frames to draw before this window closes, or 0
+		unsigned int m_frameLimit = 0;
+		// The number of frames this window has started drawing
+		unsigned int m_frameCount = 0;
+		// The directory frames are saved to, or empty
+		std::string m_frameDumpDirectory = "";
+		// The pixels of the last frame read back from OpenGL
+		std::vector<unsigned char> m_framePixels;
+		// The pixels of the last frame flipped into the order of an image
+		std::vector<unsigned char> m_frameImage;
 
 		/*
 		Move this window to the center of its current monitor
 		*/
 		void center();
+		/*
+		Create a hidden window on GLFW's null platform with a surfaceless EGL
+		or OSMesa context and an offscreen framebuffer to draw to
+		Parameter: const glm::ivec2& dimensions - The dimensions of the
+		framebuffer in pixels (width, height)
+		Returns: bool - Whether the context and framebuffer were created
+		*/
+		bool createHeadlessContext(const glm::ivec2&);
+		/*
+		Read the last frame drawn back from OpenGL and save it as a PNG image
+		in the frame dump directory
+		*/
+		void dumpFrame();
 	};
 }
 
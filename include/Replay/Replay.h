@@ -0,0 +1,59 @@
+/*
+File:		Replay.h
+Author:		Keegan MacDonald (keeganm742@gmail.com)
+Created:	2026.10.17@17:55
+Purpose:	Declares the classes of a tool which draws the frames of a trace
+			recorded by the Actias Framework again and times each phase of
+			drawing them
+*/
+
+#include <ActiasFW/ActiasFW.h>
+
+#ifndef REPLAY_REPLAY_H
+#define REPLAY_REPLAY_H
+
+using namespace ActiasFW;
+
+class ReplaySprite : public Sprite {
+public:
+	void initialize(const FrameTrace&, const FrameTrace::SpriteRecord&);
+
+private:
+	float m_drawMode = 0.0f;
+
+	float getDrawMode() const override;
+};
+
+struct ReplayBatch {
+	std::vector<ReplaySprite> sprites;
+	std::vector<Sprite*> spritePointers;
+	StaticBatch batch;
+	size_t firstFrame = 0;
+};
+
+struct ReplayTextMesh {
+	TextMesh mesh;
+	size_t firstFrame = 0;
+};
+
+class TraceReplay {
+public:
+	bool initialize(const FrameTrace&);
+	std::vector<std::string> getTextureFileNames() const;
+	void submitFrame(size_t);
+	void destroy();
+
+private:
+	const FrameTrace* m_trace = 0;
+	std::vector<Camera> m_ownCameras;
+	std::vector<Camera*> m_cameras;
+	std::vector<GLSLShader> m_ownShaders;
+	std::vector<GLSLShader*> m_shaders;
+	std::vector<std::vector<ReplaySprite>> m_frameSprites;
+	std::vector<ReplayTextMesh> m_textMeshes;
+	std::vector<ReplayBatch> m_batches;
+
+	void layoutTextMesh(size_t);
+};
+
+#endif
@@ -13,21 +13,12 @@ Purpose:	Declares classes representing all the entities to appear in the
 
 using namespace ActiasFW;
 
-class Spark : public Animation {
+class Sparks : public ParticleSystem {
 public:
-	void initialize();
-	void update(float) override;
-	void destroy() override;
-	bool isAlive() const;
+	static Simulation SparkSimulation;
 
-private:
-	float m_lifeTime = 0.0f;
-	float m_horizontalVelocityTimer = 0.0f;
-};
-
-class Floor : public Sprite {
-public:
-	void initialize(const glm::vec3&);
+	bool initialize();
+	void reset();
 };
 
 class Wall : public Sprite {
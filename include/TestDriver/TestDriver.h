@@ -19,8 +19,7 @@ private:
 	UIButton m_optionsButton;
 	UIButton m_quitButton;
 	bool m_running = false;
-	std::vector<Spark> m_sparks;
-	float m_timer = 0.0f;
+	Sparks m_sparks;
 
 	bool initialize() override;
 	void enter(Scene&) override;
@@ -57,8 +56,7 @@ private:
 	UISlider m_effectVolumeSlider;
 	UISlider m_musicVolumeSlider;
 	UITextBox m_usernameBox;
-	std::vector<Spark> m_sparks;
-	float m_timer = 0.0f;
+	Sparks m_sparks;
 	Scene* m_lastScene = 0;
 
 	bool initialize() override;
@@ -80,7 +78,10 @@ public:
 	void die();
 
 private:
-	std::vector<Floor> m_floors;
+	static const std::uint16_t FloorTile = 0;
+	static const std::uint16_t WallTile = 1;
+
+	TileMap m_map;
 	std::vector<Wall> m_walls;
 	std::vector<Coin> m_coins;
 	std::vector<Enemy> m_enemies;
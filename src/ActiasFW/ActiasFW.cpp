@@ -5,10 +5,12 @@ Created:	2024.08.05@14:25
 Purpose:	Define variables and implement functions found in ActiasFW.h
 */
 
-#include <Windows.h>
-
 #include "ActiasFW.h"
 
+#include <algorithm>
+#include <chrono>
+#include <thread>
+
 namespace ActiasFW {
 	// Implement Scene class functions
 
@@ -98,7 +100,9 @@ namespace ActiasFW {
 		if (!Window.initialize(configuration.window.dimensions,
 			configuration.window.title, configuration.window.fullscreen,
 			configuration.window.targetUpdatesPerSecond,
-			configuration.window.maximumUpdatesPerFrame)) {
+			configuration.window.maximumUpdatesPerFrame,
+			configuration.window.headless, configuration.window.frameLimit,
+			configuration.window.frameDumpDirectory)) {
 			ACTIASFW_LOG(Application, Error, "Failed to initialize window");
 			return false;
 		}
@@ -116,7 +120,12 @@ namespace ActiasFW {
 			return false;
 		}
 		ACTIASFW_LOG(Application, Info, "Initializing graphics manager");
-		if (!Graphics.initialize(configuration.graphics.backgroundColor)) {
+		if (!Graphics.initialize(configuration.graphics.backgroundColor,
+			configuration.graphics.streamBufferSize,
+			configuration.graphics.atlasPageSize,
+			configuration.graphics.textureUploadBudget,
+			configuration.graphics.shaderCacheDirectory,
+			configuration.graphics.textCacheSize)) {
 			ACTIASFW_LOG(Application, Error, "Failed to initialize graphics ",
 				"manager");
 			return false;
@@ -134,7 +143,10 @@ namespace ActiasFW {
 		float timeStep = 0.0f;
 		unsigned int updates = 0;
 		while (Window.update()) {
-			Sleep(1);
+			// Headless frames are drawn back to back so they can be timed
+			if (!Window.isHeadless()) {
+				std::this_thread::sleep_for(std::chrono::milliseconds(1));
+			}
 			Graphics.begin();
 			CurrentScene->draw();
 			Graphics.end();
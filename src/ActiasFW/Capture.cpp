@@ -0,0 +1,717 @@
+/*
+File:		Capture.cpp
+Author:		Keegan MacDonald (keeganm742@gmail.com)
+Created:	2026.10.17@17:20
+Purpose:	Implement functions found in Capture.h
+*/
+
+#include "ActiasFW.h"
+
+namespace ActiasFW {
+	// Implement FrameTrace class functions
+
+	void FrameTrace::start(const std::string& fileName,
+		unsigned int frameCount) {
+		ACTIASFW_LOG(Capture, Info, "Recording ", frameCount,
+			" frames to trace ", fileName);
+		clear();
+		m_fileName = fileName;
+		m_remainingFrames = frameCount;
+	}
+
+	bool FrameTrace::isRecording() const {
+		return m_remainingFrames > 0;
+	}
+
+	void FrameTrace::beginFrame() {
+		if (m_frames.empty()) {
+			m_windowDimensions = Application::Window.getDimensions();
+		}
+		m_frames.push_back(Frame());
+	}
+
+	void FrameTrace::recordSprite(const Sprite& sprite, GLSLShader& shader) {
+		m_frames.back().sprites.push_back(makeSpriteRecord(sprite,
+			recordShader(shader)));
+	}
+
+	void FrameTrace::recordText(const std::string& text,
+		const glm::vec3& position, const glm::vec4& box, float scale,
+		const glm::vec4& color, const std::string& fontFileName,
+		Alignment horizontalAlignment, Alignment verticalAlignment,
+		GLSLShader& shader) {
+		TextRecord record;
+		record.shader = recordShader(shader);
+		record.text = recordString(text);
+		record.font = recordFont(fontFileName);
+		record.position = position;
+		record.box = box;
+		record.scale = scale;
+		record.color = color;
+		record.horizontalAlignment = horizontalAlignment;
+		record.verticalAlignment = verticalAlignment;
+		m_frames.back().text.push_back(record);
+	}
+
+	void FrameTrace::recordTextMesh(const TextMesh& mesh, GLSLShader& shader) {
+		unsigned int shaderIndex = recordShader(shader);
+		std::map<const TextMesh*, unsigned int>::iterator it
+			= m_textMeshIndices.find(&mesh);
+		// A mesh is recorded again whenever it will be laid out again, which
+		// also covers a mesh freed and another made at the same address
+		if (it == m_textMeshIndices.end() || mesh.m_dirty
+			|| m_textMeshes.at(it->second).shader != shaderIndex) {
+			TextRecord record;
+			record.shader = shaderIndex;
+			record.text = recordString(mesh.m_text);
+			record.font = recordFont(mesh.m_fontFileName);
+			record.position = mesh.m_position;
+			record.box = mesh.m_box;
+			record.scale = mesh.m_scale;
+			record.color = mesh.m_color;
+			record.horizontalAlignment = mesh.m_horizontalAlignment;
+			record.verticalAlignment = mesh.m_verticalAlignment;
+			m_textMeshIndices[&mesh] = (unsigned int)m_textMeshes.size();
+			m_textMeshes.push_back(record);
+		}
+		m_frames.back().textMeshes.push_back(m_textMeshIndices[&mesh]);
+	}
+
+	void FrameTrace::recordBatch(StaticBatch& batch) {
+		unsigned int shaderIndex = recordShader(batch.getShader());
+		std::map<const StaticBatch*, unsigned int>::iterator it
+			= m_batchIndices.find(&batch);
+		if (it == m_batchIndices.end() || batch.isDirty()) {
+			BatchRecord record;
+			record.shader = shaderIndex;
+			record.sprites.reserve(batch.getSprites().size());
+			for (const Sprite* sprite : batch.getSprites()) {
+				record.sprites.push_back(makeSpriteRecord(*sprite,
+					shaderIndex));
+			}
+			m_batchIndices[&batch] = (unsigned int)m_batches.size();
+			m_batches.push_back(record);
+		}
+		m_frames.back().batches.push_back(m_batchIndices[&batch]);
+	}
+
+	void FrameTrace::recordTileMap(TileMap& map) {
+		unsigned int shaderIndex = recordShader(map.getShader());
+		std::map<const TileMap*, std::pair<unsigned int, unsigned int>>
+			::iterator it = m_tileMapIndices.find(&map);
+		if (it == m_tileMapIndices.end()
+			|| it->second.second != map.getRevision()) {
+			BatchRecord record;
+			record.shader = shaderIndex;
+			SpriteRecord sprite;
+			sprite.shader = shaderIndex;
+			sprite.dimensions = map.getTileDimensions();
+			sprite.textureBox = glm::vec4(0.0f, 0.0f, 1.0f, 1.0f);
+			sprite.color = glm::vec4(1.0f, 1.0f, 1.0f, 1.0f);
+			for (int y = 0; y < map.getDimensions().y; y++) {
+				for (int x = 0; x < map.getDimensions().x; x++) {
+					std::uint16_t tile = map.getTile(glm::ivec2(x, y));
+					if (tile >= map.getTileTextureFileNames().size()) {
+						continue;
+					}
+					sprite.texture = recordString(
+						map.getTileTextureFileNames().at(tile));
+					sprite.position = map.getPosition() + glm::vec3(
+						glm::vec2(x, y) * map.getTileDimensions(), 0.0f);
+					record.sprites.push_back(sprite);
+				}
+			}
+			m_tileMapIndices[&map] = std::pair<unsigned int, unsigned int>(
+				(unsigned int)m_batches.size(), map.getRevision());
+			m_batches.push_back(record);
+		}
+		m_frames.back().batches.push_back(m_tileMapIndices[&map].first);
+	}
+
+	void FrameTrace::recordParticles(ParticleSystem& particles) {
+		const QuadBatch& quads = particles.getParticles();
+		SpriteRecord record;
+		record.shader = recordShader(particles.getShader());
+		record.texture = recordString(particles.getTextureFileName());
+		for (size_t i = 0; i < quads.size(); i++) {
+			record.position = glm::vec3(quads.x[i], quads.y[i], quads.z[i]);
+			record.dimensions = glm::vec2(quads.width[i], quads.height[i]);
+			record.rotation = quads.rotation[i];
+			record.textureBox = glm::vec4(quads.textureBox[0][i],
+				quads.textureBox[1][i], quads.textureBox[2][i],
+				quads.textureBox[3][i]);
+			record.color = glm::vec4(quads.color[0][i], quads.color[1][i],
+				quads.color[2][i], quads.color[3][i]);
+			record.mode = quads.mode[i];
+			record.reflectedHorizontally
+				= quads.reflectedHorizontally[i] != 0.0f;
+			record.reflectedVertically = quads.reflectedVertically[i] != 0.0f;
+			m_frames.back().sprites.push_back(record);
+		}
+	}
+
+	void FrameTrace::recordMesh(const unsigned char* vertices,
+		size_t vertexBytes, const unsigned int* indices, size_t indexCount,
+		float depth, const std::string& textureFileName, GLSLShader& shader) {
+		MeshRecord record;
+		record.shader = recordShader(shader);
+		record.texture = recordString(textureFileName);
+		record.depth = depth;
+		record.vertices.assign(vertices, vertices + vertexBytes);
+		record.indices.assign(indices, indices + indexCount);
+		m_frames.back().meshes.push_back(record);
+	}
+
+	void FrameTrace::endFrame() {
+		if (m_remainingFrames == 0 || --m_remainingFrames > 0) {
+			return;
+		}
+		ACTIASFW_LOG(Capture, Info, "Saving trace of ", m_frames.size(),
+			" frames to ", m_fileName);
+		if (!save(m_fileName)) {
+			ACTIASFW_LOG(Capture, Error, "Failed to save trace to ",
+				m_fileName);
+		}
+	}
+
+	bool FrameTrace::save(const std::string& fileName) const {
+		std::ofstream file(fileName, std::ios::binary);
+		if (!file.is_open()) {
+			return false;
+		}
+		Write(file, (std::uint32_t)Version);
+		Write(file, m_windowDimensions);
+		Write(file, (std::uint32_t)m_strings.size());
+		for (const std::string& value : m_strings) {
+			Write(file, (std::uint32_t)value.size());
+			file.write(value.data(), value.size());
+		}
+		WriteRecords(file, m_fonts);
+		Write(file, (std::uint32_t)m_cameras.size());
+		for (const CameraRecord& camera : m_cameras) {
+			Write(file, (std::uint8_t)camera.defaultCamera);
+		}
+		Write(file, (std::uint32_t)m_shaders.size());
+		for (const ShaderRecord& shader : m_shaders) {
+			Write(file, (std::uint32_t)shader.builtIn);
+			Write(file, (std::uint32_t)shader.vertexShaderSource);
+			Write(file, (std::uint32_t)shader.fragmentShaderSource);
+			Write(file, (std::int32_t)shader.vertexLayout.getStride());
+			WriteRecords(file, shader.vertexLayout.getAttributes());
+			Write(file, (std::uint8_t)shader.instanced);
+			Write(file, (std::uint32_t)shader.textureUnitCount);
+			Write(file, (std::uint32_t)shader.textureSamplerUniformName);
+			Write(file, (std::uint32_t)shader.cameraUniformName);
+			Write(file, (std::uint32_t)shader.camera);
+		}
+		WriteRecords(file, m_textMeshes);
+		Write(file, (std::uint32_t)m_batches.size());
+		for (const BatchRecord& batch : m_batches) {
+			Write(file, (std::uint32_t)batch.shader);
+			WriteRecords(file, batch.sprites);
+		}
+		Write(file, (std::uint32_t)m_frames.size());
+		for (const Frame& frame : m_frames) {
+			WriteRecords(file, frame.cameras);
+			WriteRecords(file, frame.sprites);
+			WriteRecords(file, frame.text);
+			WriteArray(file, frame.textMeshes);
+			WriteArray(file, frame.batches);
+			Write(file, (std::uint32_t)frame.meshes.size());
+			for (const MeshRecord& mesh : frame.meshes) {
+				Write(file, (std::uint32_t)mesh.shader);
+				Write(file, (std::uint32_t)mesh.texture);
+				Write(file, mesh.depth);
+				WriteArray(file, mesh.vertices);
+				WriteArray(file, mesh.indices);
+			}
+		}
+		return (bool)file;
+	}
+
+	bool FrameTrace::load(const std::string& fileName) {
+		clear();
+		std::ifstream file(fileName, std::ios::binary | std::ios::ate);
+		if (!file.is_open()) {
+			return false;
+		}
+		// Every count is tested against the bytes left in the file before
+		// memory is allocated for it, so a corrupt count fails to load
+		std::streamoff end = file.tellg();
+		file.seekg(0, std::ios::beg);
+		std::uint32_t version = 0;
+		if (!Read(file, version) || version != Version
+			|| !Read(file, m_windowDimensions)) {
+			return false;
+		}
+		std::uint32_t count = 0;
+		if (!ReadCount(file, end, StringBytes, count)) {
+			return false;
+		}
+		m_strings.resize(count);
+		for (std::string& value : m_strings) {
+			std::uint32_t length = 0;
+			if (!ReadCount(file, end, 1, length)) {
+				return false;
+			}
+			value.resize(length);
+			if (!file.read(value.data(), length)) {
+				return false;
+			}
+		}
+		if (!ReadRecords(file, end, FontRecordBytes, m_fonts)
+			|| !ReadCount(file, end, CameraRecordBytes, count)) {
+			return false;
+		}
+		m_cameras.resize(count);
+		for (CameraRecord& camera : m_cameras) {
+			std::uint8_t defaultCamera = 0;
+			if (!Read(file, defaultCamera)) {
+				return false;
+			}
+			camera.defaultCamera = defaultCamera != 0;
+		}
+		if (!ReadCount(file, end, ShaderRecordBytes, count)) {
+			return false;
+		}
+		m_shaders.resize(count);
+		for (ShaderRecord& shader : m_shaders) {
+			std::uint32_t builtIn = 0;
+			std::int32_t stride = 0;
+			std::vector<VertexAttribute> attributes;
+			std::uint8_t instanced = 0;
+			std::uint32_t fields[6] = {};
+			if (!Read(file, builtIn) || !Read(file, fields[0])
+				|| !Read(file, fields[1]) || !Read(file, stride)
+				|| !ReadRecords(file, end, VertexAttributeBytes, attributes)
+				|| !Read(file, instanced) || !Read(file, fields[2])
+				|| !Read(file, fields[3]) || !Read(file, fields[4])
+				|| !Read(file, fields[5])
+				|| builtIn > BUILT_IN_DEFAULT_INSTANCED || stride < 0) {
+				return false;
+			}
+			shader.builtIn = (BuiltInShader)builtIn;
+			shader.vertexShaderSource = fields[0];
+			shader.fragmentShaderSource = fields[1];
+			shader.vertexLayout = VertexLayout::Of(attributes,
+				(GLsizei)stride);
+			shader.instanced = instanced != 0;
+			shader.textureUnitCount = fields[2];
+			shader.textureSamplerUniformName = fields[3];
+			shader.cameraUniformName = fields[4];
+			shader.camera = fields[5];
+		}
+		if (!ReadRecords(file, end, TextRecordBytes, m_textMeshes)
+			|| !ReadCount(file, end, BatchRecordBytes, count)) {
+			return false;
+		}
+		m_batches.resize(count);
+		for (BatchRecord& batch : m_batches) {
+			std::uint32_t shader = 0;
+			if (!Read(file, shader)
+				|| !ReadRecords(file, end, SpriteRecordBytes, batch.sprites)) {
+				return false;
+			}
+			batch.shader = shader;
+		}
+		if (!ReadCount(file, end, FrameBytes, count)) {
+			return false;
+		}
+		m_frames.resize(count);
+		for (Frame& frame : m_frames) {
+			if (!ReadRecords(file, end, CameraStateBytes, frame.cameras)
+				|| !ReadRecords(file, end, SpriteRecordBytes, frame.sprites)
+				|| !ReadRecords(file, end, TextRecordBytes, frame.text)
+				|| !ReadArray(file, end, frame.textMeshes)
+				|| !ReadArray(file, end, frame.batches)
+				|| !ReadCount(file, end, MeshRecordBytes, count)) {
+				return false;
+			}
+			frame.meshes.resize(count);
+			for (MeshRecord& mesh : frame.meshes) {
+				std::uint32_t shader = 0;
+				std::uint32_t texture = 0;
+				if (!Read(file, shader) || !Read(file, texture)
+					|| !Read(file, mesh.depth)
+					|| !ReadArray(file, end, mesh.vertices)
+					|| !ReadArray(file, end, mesh.indices)) {
+					return false;
+				}
+				mesh.shader = shader;
+				mesh.texture = texture;
+			}
+		}
+		return validate();
+	}
+
+	void FrameTrace::clear() {
+		m_windowDimensions = glm::ivec2();
+		m_strings.clear();
+		m_shaders.clear();
+		m_fonts.clear();
+		m_cameras.clear();
+		m_textMeshes.clear();
+		m_batches.clear();
+		m_frames.clear();
+		m_fileName = "";
+		m_remainingFrames = 0;
+		m_stringIndices.clear();
+		m_shaderIndices.clear();
+		m_cameraIndices.clear();
+		m_textMeshIndices.clear();
+		m_batchIndices.clear();
+		m_tileMapIndices.clear();
+	}
+
+	const glm::ivec2& FrameTrace::getWindowDimensions() const {
+		return m_windowDimensions;
+	}
+
+	const std::string& FrameTrace::getString(unsigned int index) const {
+		static const std::string empty = "";
+		return index < m_strings.size() ? m_strings.at(index) : empty;
+	}
+
+	const std::vector<FrameTrace::ShaderRecord>& FrameTrace::getShaders()
+		const {
+		return m_shaders;
+	}
+
+	const std::vector<FrameTrace::FontRecord>& FrameTrace::getFonts() const {
+		return m_fonts;
+	}
+
+	const std::vector<FrameTrace::CameraRecord>& FrameTrace::getCameras()
+		const {
+		return m_cameras;
+	}
+
+	const std::vector<FrameTrace::TextRecord>& FrameTrace::getTextMeshes()
+		const {
+		return m_textMeshes;
+	}
+
+	const std::vector<FrameTrace::BatchRecord>& FrameTrace::getBatches()
+		const {
+		return m_batches;
+	}
+
+	const std::vector<FrameTrace::Frame>& FrameTrace::getFrames() const {
+		return m_frames;
+	}
+
+	unsigned int FrameTrace::recordString(const std::string& value) {
+		std::map<std::string, unsigned int>::iterator it
+			= m_stringIndices.find(value);
+		if (it != m_stringIndices.end()) {
+			return it->second;
+		}
+		unsigned int index = (unsigned int)m_strings.size();
+		m_strings.push_back(value);
+		m_stringIndices[value] = index;
+		return index;
+	}
+
+	unsigned int FrameTrace::recordFont(const std::string& fileName) {
+		unsigned int index = recordString(fileName);
+		for (const FontRecord& font : m_fonts) {
+			if (font.fileName == index) {
+				return index;
+			}
+		}
+		FontRecord font;
+		font.fileName = index;
+		font.rendering = Application::Graphics.getFontRendering(fileName);
+		m_fonts.push_back(font);
+		return index;
+	}
+
+	unsigned int FrameTrace::recordShader(GLSLShader& shader) {
+		unsigned int index = 0;
+		std::map<const GLSLShader*, unsigned int>::iterator it
+			= m_shaderIndices.find(&shader);
+		if (it != m_shaderIndices.end()) {
+			index = it->second;
+		}
+		else {
+			const Camera* camera = &shader.getCamera();
+			std::map<const Camera*, unsigned int>::iterator c
+				= m_cameraIndices.find(camera);
+			if (c == m_cameraIndices.end()) {
+				CameraRecord record;
+				record.defaultCamera
+					= camera == &Application::Graphics.getDefaultCamera();
+				c = m_cameraIndices.insert(std::make_pair(camera,
+					(unsigned int)m_cameras.size())).first;
+				m_cameras.push_back(record);
+			}
+			ShaderRecord record;
+			if (&shader == &Application::Graphics.getDefaultShader()) {
+				record.builtIn = BUILT_IN_DEFAULT;
+			}
+			else if (&shader
+				== &Application::Graphics.getDefaultInstancedShader()) {
+				record.builtIn = BUILT_IN_DEFAULT_INSTANCED;
+			}
+			record.vertexShaderSource
+				= recordString(shader.getVertexShaderSource());
+			record.fragmentShaderSource
+				= recordString(shader.getFragmentShaderSource());
+			record.vertexLayout = shader.getVertexLayout();
+			record.instanced = shader.isInstanced();
+			record.textureUnitCount = shader.getTextureUnitCount();
+			record.textureSamplerUniformName
+				= recordString(shader.getTextureSamplerUniformName());
+			record.cameraUniformName
+				= recordString(shader.getCameraUniformName());
+			record.camera = c->second;
+			index = (unsigned int)m_shaders.size();
+			m_shaderIndices[&shader] = index;
+			m_shaders.push_back(record);
+		}
+		// Record the state of the shader's camera the first time it is drawn
+		// through each frame
+		std::vector<CameraState>& cameras = m_frames.back().cameras;
+		unsigned int camera = m_shaders.at(index).camera;
+		for (const CameraState& state : cameras) {
+			if (state.camera == camera) {
+				return index;
+			}
+		}
+		CameraState state;
+		state.camera = camera;
+		state.position = shader.getCamera().getPosition();
+		state.scale = shader.getCamera().getScale();
+		cameras.push_back(state);
+		return index;
+	}
+
+	FrameTrace::SpriteRecord FrameTrace::makeSpriteRecord(const Sprite& sprite,
+		unsigned int shader) {
+		SpriteRecord record;
+		record.shader = shader;
+		record.texture = recordString(sprite.m_textureFileName);
+		record.position = sprite.getPosition();
+		record.dimensions = sprite.m_dimensions;
+		record.rotation = sprite.m_rotation;
+		record.textureBox = sprite.m_textureBox;
+		record.color = sprite.m_color;
+		record.mode = sprite.getDrawMode();
+		record.reflectedHorizontally = sprite.m_reflectedHorizontally;
+		record.reflectedVertically = sprite.m_reflectedVertically;
+		return record;
+	}
+
+	bool FrameTrace::validate() const {
+		size_t strings = m_strings.size();
+		for (const FontRecord& font : m_fonts) {
+			if (font.fileName >= strings) {
+				return false;
+			}
+		}
+		for (const ShaderRecord& shader : m_shaders) {
+			if (shader.vertexShaderSource >= strings
+				|| shader.fragmentShaderSource >= strings
+				|| shader.textureSamplerUniformName >= strings
+				|| shader.cameraUniformName >= strings
+				|| shader.camera >= m_cameras.size()) {
+				return false;
+			}
+		}
+		for (const TextRecord& text : m_textMeshes) {
+			if (text.shader >= m_shaders.size() || text.text >= strings
+				|| text.font >= strings) {
+				return false;
+			}
+		}
+		for (const BatchRecord& batch : m_batches) {
+			if (batch.shader >= m_shaders.size()) {
+				return false;
+			}
+			for (const SpriteRecord& sprite : batch.sprites) {
+				if (sprite.texture >= strings) {
+					return false;
+				}
+			}
+		}
+		for (const Frame& frame : m_frames) {
+			for (const CameraState& camera : frame.cameras) {
+				if (camera.camera >= m_cameras.size()) {
+					return false;
+				}
+			}
+			for (const SpriteRecord& sprite : frame.sprites) {
+				if (sprite.shader >= m_shaders.size()
+					|| sprite.texture >= strings) {
+					return false;
+				}
+			}
+			for (const TextRecord& text : frame.text) {
+				if (text.shader >= m_shaders.size() || text.text >= strings
+					|| text.font >= strings) {
+					return false;
+				}
+			}
+			for (unsigned int mesh : frame.textMeshes) {
+				if (mesh >= m_textMeshes.size()) {
+					return false;
+				}
+			}
+			for (unsigned int batch : frame.batches) {
+				if (batch >= m_batches.size()) {
+					return false;
+				}
+			}
+			for (const MeshRecord& mesh : frame.meshes) {
+				if (mesh.shader >= m_shaders.size()
+					|| mesh.texture >= strings) {
+					return false;
+				}
+			}
+		}
+		return true;
+	}
+
+	void FrameTrace::WriteRecord(std::ostream& stream,
+		const FontRecord& record) {
+		Write(stream, (std::uint32_t)record.fileName);
+		Write(stream, (std::uint32_t)record.rendering);
+	}
+
+	void FrameTrace::WriteRecord(std::ostream& stream,
+		const CameraState& record) {
+		Write(stream, (std::uint32_t)record.camera);
+		Write(stream, record.position);
+		Write(stream, record.scale);
+	}
+
+	void FrameTrace::WriteRecord(std::ostream& stream,
+		const SpriteRecord& record) {
+		Write(stream, (std::uint32_t)record.shader);
+		Write(stream, (std::uint32_t)record.texture);
+		Write(stream, record.position);
+		Write(stream, record.dimensions);
+		Write(stream, record.rotation);
+		Write(stream, record.textureBox);
+		Write(stream, record.color);
+		Write(stream, record.mode);
+		Write(stream, (std::uint8_t)record.reflectedHorizontally);
+		Write(stream, (std::uint8_t)record.reflectedVertically);
+	}
+
+	void FrameTrace::WriteRecord(std::ostream& stream,
+		const TextRecord& record) {
+		Write(stream, (std::uint32_t)record.shader);
+		Write(stream, (std::uint32_t)record.text);
+		Write(stream, (std::uint32_t)record.font);
+		Write(stream, record.position);
+		Write(stream, record.box);
+		Write(stream, record.scale);
+		Write(stream, record.color);
+		Write(stream, (std::uint32_t)record.horizontalAlignment);
+		Write(stream, (std::uint32_t)record.verticalAlignment);
+	}
+
+	void FrameTrace::WriteRecord(std::ostream& stream,
+		const VertexAttribute& record) {
+		Write(stream, (std::int32_t)record.size);
+		Write(stream, (std::uint32_t)record.type);
+		Write(stream, (std::uint8_t)record.normalized);
+		Write(stream, (std::uint32_t)record.offset);
+	}
+
+	bool FrameTrace::ReadCount(std::istream& stream, std::streamoff end,
+		size_t elementBytes, std::uint32_t& count) {
+		if (!Read(stream, count)) {
+			return false;
+		}
+		std::streamoff position = stream.tellg();
+		return position >= 0 && position <= end
+			&& (std::uint64_t)count * elementBytes
+			<= (std::uint64_t)(end - position);
+	}
+
+	bool FrameTrace::ReadRecord(std::istream& stream, FontRecord& record) {
+		std::uint32_t fileName = 0;
+		std::uint32_t rendering = 0;
+		if (!Read(stream, fileName) || !Read(stream, rendering)
+			|| rendering > Font::RENDERING_SDF) {
+			return false;
+		}
+		record.fileName = fileName;
+		record.rendering = (Font::Rendering)rendering;
+		return true;
+	}
+
+	bool FrameTrace::ReadRecord(std::istream& stream, CameraState& record) {
+		std::uint32_t camera = 0;
+		if (!Read(stream, camera) || !Read(stream, record.position)
+			|| !Read(stream, record.scale)) {
+			return false;
+		}
+		record.camera = camera;
+		return true;
+	}
+
+	bool FrameTrace::ReadRecord(std::istream& stream, SpriteRecord& record) {
+		std::uint32_t shader = 0;
+		std::uint32_t texture = 0;
+		std::uint8_t reflectedHorizontally = 0;
+		std::uint8_t reflectedVertically = 0;
+		if (!Read(stream, shader) || !Read(stream, texture)
+			|| !Read(stream, record.position)
+			|| !Read(stream, record.dimensions)
+			|| !Read(stream, record.rotation)
+			|| !Read(stream, record.textureBox)
+			|| !Read(stream, record.color) || !Read(stream, record.mode)
+			|| !Read(stream, reflectedHorizontally)
+			|| !Read(stream, reflectedVertically)) {
+			return false;
+		}
+		record.shader = shader;
+		record.texture = texture;
+		record.reflectedHorizontally = reflectedHorizontally != 0;
+		record.reflectedVertically = reflectedVertically != 0;
+		return true;
+	}
+
+	bool FrameTrace::ReadRecord(std::istream& stream, TextRecord& record) {
+		std::uint32_t shader = 0;
+		std::uint32_t text = 0;
+		std::uint32_t font = 0;
+		std::uint32_t horizontalAlignment = 0;
+		std::uint32_t verticalAlignment = 0;
+		if (!Read(stream, shader) || !Read(stream, text) || !Read(stream, font)
+			|| !Read(stream, record.position) || !Read(stream, record.box)
+			|| !Read(stream, record.scale) || !Read(stream, record.color)
+			|| !Read(stream, horizontalAlignment)
+			|| !Read(stream, verticalAlignment)
+			|| horizontalAlignment > NO_ALIGNMENT
+			|| verticalAlignment > NO_ALIGNMENT) {
+			return false;
+		}
+		record.shader = shader;
+		record.text = text;
+		record.font = font;
+		record.horizontalAlignment = (Alignment)horizontalAlignment;
+		record.verticalAlignment = (Alignment)verticalAlignment;
+		return true;
+	}
+
+	bool FrameTrace::ReadRecord(std::istream& stream,
+		VertexAttribute& record) {
+		std::int32_t size = 0;
+		std::uint32_t type = 0;
+		std::uint8_t normalized = 0;
+		std::uint32_t offset = 0;
+		if (!Read(stream, size) || !Read(stream, type)
+			|| !Read(stream, normalized) || !Read(stream, offset)) {
+			return false;
+		}
+		record.size = (GLint)size;
+		record.type = (GLenum)type;
+		record.normalized = normalized != 0 ? GL_TRUE : GL_FALSE;
+		record.offset = (GLuint)offset;
+		return true;
+	}
+}
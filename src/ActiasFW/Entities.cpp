@@ -163,72 +163,18 @@ namespace ActiasFW {
 	}
 
 	void Sprite::draw() {
-		glm::vec3 bbl(m_position.x, m_position.y, m_position.z);
-		glm::vec3 bbr(m_position.x + m_dimensions.x, m_position.y,
-			m_position.z);
-		glm::vec3 btl(m_position.x, m_position.y + m_dimensions.y,
-			m_position.z);
-		glm::vec3 btr(m_position.x + m_dimensions.x,
-			m_position.y + m_dimensions.y, m_position.z);
-		if ((int)m_rotation % 360 != 0) {
-			bbl = rotate(bbl);
-			bbr = rotate(bbr);
-			btl = rotate(btl);
-			btr = rotate(btr);
+		// The quad's indices never change once its vertices are allocated
+		if (m_vertices.size() != QuadKernel::FloatsPerSprite) {
+			m_indices.assign(QuadKernel::Indices, QuadKernel::Indices + 6);
+			m_vertices.resize(QuadKernel::FloatsPerSprite);
 		}
-		glm::vec2 tbl(m_textureBox.x, m_textureBox.y + m_textureBox.w);
-		glm::vec2 tbr(m_textureBox.x + m_textureBox.z,
-			m_textureBox.y + m_textureBox.w);
-		glm::vec2 ttl(m_textureBox.x, m_textureBox.y);
-		glm::vec2 ttr(m_textureBox.x + m_textureBox.z, m_textureBox.y);
-		m_indices = { 0, 2, 1, 1, 2, 3, };
-		m_vertices = {
-			bbl.x, bbl.y, bbl.z,
-			tbl.x, tbl.y,
-			m_color.r, m_color.g, m_color.b, m_color.a,
-			(float)m_textureFileName.empty(),
-			bbr.x, bbr.y, bbr.z,
-			tbr.x, tbr.y,
-			m_color.r, m_color.g, m_color.b, m_color.a,
-			(float)m_textureFileName.empty(),
-			btl.x, btl.y, btl.z,
-			ttl.x, ttl.y,
-			m_color.r, m_color.g, m_color.b, m_color.a,
-			(float)m_textureFileName.empty(),
-			btr.x, btr.y, btr.z,
-			ttr.x, ttr.y,
-			m_color.r, m_color.g, m_color.b, m_color.a,
-			(float)m_textureFileName.empty(),
-		};
-		if (m_reflectedHorizontally) {
-			transposeVertices(3, 13);
-			transposeVertices(4, 14);
-			transposeVertices(23, 33);
-			transposeVertices(24, 34);
-		}
-		if (m_reflectedVertically) {
-			transposeVertices(3, 23);
-			transposeVertices(4, 24);
-			transposeVertices(13, 33);
-			transposeVertices(14, 34);
-		}
-	}
-
-#define PI 3.1415926f
-
-	glm::vec3 Sprite::rotate(const glm::vec3& p) const {
-		float a = (PI / 180.0f) * m_rotation;
-		glm::vec2 c = glm::vec2(m_position.x, m_position.y)
-			+ (m_dimensions / 2.0f);
-		float rx = cos(a) * (p.x - c.x) - sin(a) * (p.y - c.y) + c.x;
-		float ry = sin(a) * (p.x - c.x) + cos(a) * (p.y - c.y) + c.y;
-		return glm::vec3(rx, ry, p.z);
+		QuadKernel::ExpandOne(m_position, m_dimensions, m_rotation,
+			m_textureBox, m_color, getDrawMode(), m_reflectedHorizontally,
+			m_reflectedVertically, m_vertices.data());
 	}
 
-	void Sprite::transposeVertices(size_t a, size_t b) {
-		float v = m_vertices.at(a);
-		m_vertices[a] = m_vertices.at(b);
-		m_vertices[b] = v;
+	float Sprite::getDrawMode() const {
+		return (float)m_textureFileName.empty();
 	}
 
 	// Implement Animation class functions
@@ -236,16 +182,27 @@ namespace ActiasFW {
 	void Animation::initialize(const glm::vec3& position,
 		const glm::vec2& dimensions, const std::string& textureFileName,
 		const glm::ivec2& frameDimensions, float frameTime) {
-		Sprite::initialize(position, dimensions, textureFileName);
-		m_textureBox = glm::vec4(0.0f, 0.0f, 1.0f / (float)frameDimensions.x,
+		glm::vec2 fd(1.0f / (float)frameDimensions.x,
 			1.0f / (float)frameDimensions.y);
-		m_frameCoordinates.resize(frameDimensions.x * frameDimensions.y);
+		std::vector<glm::vec4> frames(frameDimensions.x * frameDimensions.y);
 		for (int y = 0; y < frameDimensions.y; y++) {
 			for (int x = 0; x < frameDimensions.x; x++) {
-				m_frameCoordinates[x + y * frameDimensions.x]
-					= glm::vec2(m_textureBox.z * x, m_textureBox.w * y);
+				frames[x + y * frameDimensions.x]
+					= glm::vec4(fd.x * x, fd.y * y, fd.x, fd.y);
 			}
 		}
+		initialize(position, dimensions, textureFileName, frames, frameTime);
+	}
+
+	void Animation::initialize(const glm::vec3& position,
+		const glm::vec2& dimensions, const std::string& textureFileName,
+		const std::vector<glm::vec4>& frames, float frameTime) {
+		Sprite::initialize(position, dimensions, textureFileName);
+		m_frameCoordinates = frames;
+		if (m_frameCoordinates.empty()) {
+			m_frameCoordinates.push_back(m_textureBox);
+		}
+		m_textureBox = m_frameCoordinates.front();
 		setCurrentFrame(0);
 		setFrameTime(frameTime);
 	}
@@ -260,8 +217,7 @@ namespace ActiasFW {
 			m_currentFrame = (m_currentFrame + 1) % m_frameCoordinates.size();
 		}
 		m_timer += timeStep;
-		m_textureBox.x = m_frameCoordinates.at(m_currentFrame).x;
-		m_textureBox.y = m_frameCoordinates.at(m_currentFrame).y;
+		m_textureBox = m_frameCoordinates.at(m_currentFrame);
 	}
 
 	void Animation::play() {
@@ -276,8 +232,7 @@ namespace ActiasFW {
 		m_currentFrame = 0;
 		m_timer = 0.0f;
 		m_playing = false;
-		m_textureBox.x = m_frameCoordinates.at(m_currentFrame).x;
-		m_textureBox.y = m_frameCoordinates.at(m_currentFrame).y;
+		m_textureBox = m_frameCoordinates.at(m_currentFrame);
 	}
 
 	void Animation::destroy() {
@@ -327,35 +282,89 @@ namespace ActiasFW {
 		m_offset = offset;
 	}
 
-	void Glyph::draw() {
-		Sprite::draw();
-		m_vertices[9] = 2.0f;
-		m_vertices[19] = 2.0f;
-		m_vertices[29] = 2.0f;
-		m_vertices[39] = 2.0f;
+	float Glyph::getDrawMode() const {
+		return m_drawMode;
 	}
 
 	// Implement Font class functions
 
-	const std::map<char, Glyph>& Font::getGlyphs() const {
-		return m_glyphs;
+	const GlyphMetrics Font::MissingGlyph = GlyphMetrics();
+
+	const GlyphMetrics& Font::getGlyph(char32_t codepoint) const {
+		if (codepoint < CharacterCount) {
+			return m_glyphs[codepoint];
+		}
+		std::map<char32_t, GlyphMetrics>::const_iterator it
+			= m_extendedGlyphs.find(codepoint);
+		if (it == m_extendedGlyphs.end()) {
+			return MissingGlyph;
+		}
+		return it->second;
+	}
+
+	bool Font::hasGlyph(char32_t codepoint) const {
+		return getGlyph(codepoint).loaded;
 	}
 
-	void Font::addGlyph(char character, const Glyph& glyph) {
-		if (m_glyphs.find(character) != m_glyphs.end()) {
+	void Font::addGlyph(char32_t codepoint, const GlyphMetrics& glyph) {
+		if (hasGlyph(codepoint)) {
+			return;
+		}
+		GlyphMetrics& entry = codepoint < CharacterCount
+			? m_glyphs[codepoint] : m_extendedGlyphs[codepoint];
+		entry = glyph;
+		entry.loaded = true;
+		if (codepoint >= 128) {
 			return;
 		}
-		m_glyphs[character] = glyph;
-		if ((float)(glyph.getDimensions().y - glyph.getBearing().y)
-			> m_minimumBearing) {
-			m_minimumBearing
-				= (float)(glyph.getDimensions().y - glyph.getBearing().y);
+		if ((float)(glyph.dimensions.y - glyph.bearing.y) > m_minimumBearing) {
+			m_minimumBearing = (float)(glyph.dimensions.y - glyph.bearing.y);
 		}
-		if ((float)glyph.getBearing().y > m_maximumBearing) {
-			m_maximumBearing = (float)glyph.getBearing().y;
+		if ((float)glyph.bearing.y > m_maximumBearing) {
+			m_maximumBearing = (float)glyph.bearing.y;
 		}
 	}
 
+	const std::string& Font::getTextureFileName() const {
+		return m_textureFileName;
+	}
+
+	void Font::setTextureFileName(const std::string& textureFileName) {
+		m_textureFileName = textureFileName;
+	}
+
+	Font::Rendering Font::getRendering() const {
+		return m_rendering;
+	}
+
+	void Font::setRendering(Rendering rendering) {
+		m_rendering = rendering;
+	}
+
+	float Font::getPadding() const {
+		return m_padding;
+	}
+
+	void Font::setPadding(float padding) {
+		m_padding = padding;
+	}
+
+	float Font::getDrawMode() const {
+		return m_rendering == RENDERING_SDF ? 3.0f : 2.0f;
+	}
+
+	GlyphMetrics* Font::findGlyph(char32_t codepoint) {
+		if (codepoint < CharacterCount) {
+			return m_glyphs[codepoint].loaded ? &m_glyphs[codepoint] : 0;
+		}
+		std::map<char32_t, GlyphMetrics>::iterator it
+			= m_extendedGlyphs.find(codepoint);
+		if (it == m_extendedGlyphs.end()) {
+			return 0;
+		}
+		return &it->second;
+	}
+
 	float Font::getMinimumBearing() const {
 		return m_minimumBearing;
 	}
@@ -365,11 +374,11 @@ namespace ActiasFW {
 	}
 
 	void Font::destroy() {
-		for (std::map<char, Glyph>::iterator it = m_glyphs.begin();
-			it != m_glyphs.end(); it++) {
-			it->second.destroy();
-		}
-		m_glyphs.clear();
+		m_glyphs.assign(CharacterCount, GlyphMetrics());
+		m_extendedGlyphs.clear();
+		m_textureFileName = "";
+		m_rendering = RENDERING_BITMAP;
+		m_padding = 0.0f;
 		m_minimumBearing = 0.0f;
 		m_maximumBearing = 0.0f;
 	}
@@ -0,0 +1,172 @@
+/*
+File:		GLState.cpp
+Author:		Keegan MacDonald (keeganm742@gmail.com)
+Created:	2026.10.17@14:05
+Purpose:	Implement functions found in GLState.h
+*/
+
+#include "GLState.h"
+
+namespace ActiasFW {
+	// Implement GLStateCache class functions
+
+	void GLStateCache::useProgram(GLuint programID) {
+		if (m_program == programID) {
+			m_skippedCalls++;
+			return;
+		}
+		glUseProgram(programID);
+		m_program = programID;
+		m_issuedCalls++;
+	}
+
+	void GLStateCache::bindVertexArray(GLuint vertexArrayID) {
+		if (m_vertexArray == vertexArrayID) {
+			m_skippedCalls++;
+			return;
+		}
+		glBindVertexArray(vertexArrayID);
+		m_vertexArray = vertexArrayID;
+		m_buffers[TARGET_ELEMENT_ARRAY] = Unknown;
+		m_issuedCalls++;
+	}
+
+	void GLStateCache::bindBuffer(GLenum target, GLuint bufferID) {
+		int t = GetTargetIndex(target);
+		if (t >= 0 && m_buffers[t] == bufferID) {
+			m_skippedCalls++;
+			return;
+		}
+		glBindBuffer(target, bufferID);
+		if (t >= 0) {
+			m_buffers[t] = bufferID;
+		}
+		m_issuedCalls++;
+	}
+
+	void GLStateCache::bindBufferRange(GLenum target, GLuint index,
+		GLuint bufferID, GLintptr offset, GLsizeiptr size) {
+		glBindBufferRange(target, index, bufferID, offset, size);
+		int t = GetTargetIndex(target);
+		if (t >= 0) {
+			m_buffers[t] = bufferID;
+		}
+		m_issuedCalls++;
+	}
+
+	void GLStateCache::bindTexture(unsigned int unit, GLuint textureID) {
+		// The unit is activated even when the texture is already bound, as
+		// callers edit the texture through the active unit after binding it
+		if (m_activeTextureUnit != unit) {
+			glActiveTexture(GL_TEXTURE0 + unit);
+			m_activeTextureUnit = unit;
+			m_issuedCalls++;
+		}
+		if (unit < TrackedTextureUnits && m_textures[unit] == textureID) {
+			m_skippedCalls++;
+			return;
+		}
+		glBindTexture(GL_TEXTURE_2D, textureID);
+		if (unit < TrackedTextureUnits) {
+			m_textures[unit] = textureID;
+		}
+		m_issuedCalls++;
+	}
+
+	void GLStateCache::setBlending(bool enabled, GLenum source,
+		GLenum destination) {
+		setBlending(enabled, source, destination, source, destination);
+	}
+
+	void GLStateCache::setBlending(bool enabled, GLenum source,
+		GLenum destination, GLenum alphaSource, GLenum alphaDestination) {
+		if (m_blending != (GLuint)enabled) {
+			if (enabled) {
+				glEnable(GL_BLEND);
+			}
+			else {
+				glDisable(GL_BLEND);
+			}
+			m_blending = (GLuint)enabled;
+			m_issuedCalls++;
+		}
+		else {
+			m_skippedCalls++;
+		}
+		if (!enabled) {
+			return;
+		}
+		if (m_blendSource == source && m_blendDestination == destination
+			&& m_blendAlphaSource == alphaSource
+			&& m_blendAlphaDestination == alphaDestination) {
+			m_skippedCalls++;
+			return;
+		}
+		glBlendFuncSeparate(source, destination, alphaSource,
+			alphaDestination);
+		m_blendSource = source;
+		m_blendDestination = destination;
+		m_blendAlphaSource = alphaSource;
+		m_blendAlphaDestination = alphaDestination;
+		m_issuedCalls++;
+	}
+
+	GLuint GLStateCache::getProgram() const {
+		return m_program;
+	}
+
+	GLuint GLStateCache::getVertexArray() const {
+		return m_vertexArray;
+	}
+
+	void GLStateCache::invalidate() {
+		m_program = Unknown;
+		m_vertexArray = Unknown;
+		for (GLuint& buffer : m_buffers) {
+			buffer = Unknown;
+		}
+		for (GLuint& texture : m_textures) {
+			texture = Unknown;
+		}
+		m_activeTextureUnit = Unknown;
+		m_blending = Unknown;
+		m_blendSource = Unknown;
+		m_blendDestination = Unknown;
+		m_blendAlphaSource = Unknown;
+		m_blendAlphaDestination = Unknown;
+	}
+
+	unsigned int GLStateCache::getIssuedCalls() const {
+		return m_issuedCalls;
+	}
+
+	unsigned int GLStateCache::getSkippedCalls() const {
+		return m_skippedCalls;
+	}
+
+	void GLStateCache::resetCounts() {
+		m_issuedCalls = 0;
+		m_skippedCalls = 0;
+	}
+
+	int GLStateCache::GetTargetIndex(GLenum target) {
+		switch (target) {
+		case GL_ARRAY_BUFFER:
+			return TARGET_ARRAY;
+		case GL_ELEMENT_ARRAY_BUFFER:
+			return TARGET_ELEMENT_ARRAY;
+		case GL_UNIFORM_BUFFER:
+			return TARGET_UNIFORM;
+		case GL_PIXEL_UNPACK_BUFFER:
+			return TARGET_PIXEL_UNPACK;
+		case GL_DRAW_INDIRECT_BUFFER:
+			return TARGET_DRAW_INDIRECT;
+		case GL_COPY_READ_BUFFER:
+			return TARGET_COPY_READ;
+		case GL_COPY_WRITE_BUFFER:
+			return TARGET_COPY_WRITE;
+		default:
+			return -1;
+		}
+	}
+}
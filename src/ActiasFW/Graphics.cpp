@@ -7,10 +7,22 @@ Purpose:	Defines variables and implements functions found in Graphics.h
 
 #include "ActiasFW.h"
 
+#include <freetype/ftmodapi.h>
 #include <glm/gtc/matrix_transform.hpp>
 #include <lodepng.h>
 
 #include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iomanip>
+#include <limits>
+#include <sstream>
+#include <string_view>
+#include <thread>
+#include <tuple>
 
 namespace ActiasFW {
 	// Implement Camera class functions
@@ -39,9 +51,11 @@ namespace ActiasFW {
 
 	void Camera::destroy() {
 		Entity::destroy();
+		Application::Graphics.releaseCamera(*this);
 		m_scale = 0.0f;
 		m_scaleVelocity = 0.0f;
 		m_matrix = glm::mat4();
+		m_visibleBox = glm::vec4();
 		m_lastPosition = glm::vec3();
 		m_lastScale = 0.0f;
 		m_lastWindowDimensions = glm::ivec2();
@@ -67,6 +81,10 @@ namespace ActiasFW {
 		return m_matrix;
 	}
 
+	const glm::vec4& Camera::getVisibleBox() const {
+		return m_visibleBox;
+	}
+
 	void Camera::updateMatrix() {
 		glm::vec2 wd((float)Application::Window.getDimensions().x,
 			(float)Application::Window.getDimensions().y);
@@ -80,19 +98,132 @@ namespace ActiasFW {
 			glm::vec3(-m_position.x, -m_position.y, 0.0f));
 		m_matrix = glm::scale(glm::mat4(1.0f),
 			glm::vec3(m_scale, m_scale, 0.0f)) * m_matrix;
+		if (m_scale > 0.0f) {
+			glm::vec2 half = wd / (2.0f * m_scale);
+			m_visibleBox = glm::vec4(m_position.x - half.x,
+				m_position.y - half.y, 2.0f * half.x, 2.0f * half.y);
+		}
+		else {
+			// A camera with no scale sees everything at a single point
+			float m = std::numeric_limits<float>::max();
+			m_visibleBox = glm::vec4(-m / 2.0f, -m / 2.0f, m, m);
+		}
 		m_lastPosition = m_position;
 		m_lastScale = m_scale;
 		m_lastWindowDimensions = Application::Window.getDimensions();
+		Application::Graphics.updateCamera(*this);
+	}
+
+	// Implement VertexLayout class functions
+
+	VertexLayout VertexLayout::OfFloats(
+		const std::vector<unsigned int>& sizes) {
+		VertexLayout layout;
+		for (unsigned int size : sizes) {
+			VertexAttribute attribute;
+			attribute.size = (GLint)size;
+			attribute.offset = (GLuint)layout.m_stride;
+			layout.m_attributes.push_back(attribute);
+			layout.m_stride += (GLsizei)(size * sizeof(float));
+		}
+		return layout;
+	}
+
+	VertexLayout VertexLayout::Of(
+		const std::vector<VertexAttribute>& attributes, GLsizei stride) {
+		VertexLayout layout;
+		layout.m_stride = stride;
+		layout.m_attributes = attributes;
+		return layout;
+	}
+
+	void VertexLayout::bind() const {
+		for (GLuint a = 0; a < m_attributes.size(); a++) {
+			const VertexAttribute& attribute = m_attributes.at(a);
+			glVertexAttribPointer(a, attribute.size, attribute.type,
+				attribute.normalized, m_stride,
+				(void*)(size_t)attribute.offset);
+			glEnableVertexAttribArray(a);
+		}
+	}
+
+	GLsizei VertexLayout::getStride() const {
+		return m_stride;
+	}
+
+	const std::vector<VertexAttribute>& VertexLayout::getAttributes() const {
+		return m_attributes;
+	}
+
+	bool VertexLayout::operator < (const VertexLayout& layout) const {
+		if (m_stride != layout.m_stride) {
+			return m_stride < layout.m_stride;
+		}
+		if (m_attributes.size() != layout.m_attributes.size()) {
+			return m_attributes.size() < layout.m_attributes.size();
+		}
+		for (size_t a = 0; a < m_attributes.size(); a++) {
+			const VertexAttribute& x = m_attributes.at(a);
+			const VertexAttribute& y = layout.m_attributes.at(a);
+			if (x.size != y.size) {
+				return x.size < y.size;
+			}
+			if (x.type != y.type) {
+				return x.type < y.type;
+			}
+			if (x.normalized != y.normalized) {
+				return x.normalized < y.normalized;
+			}
+			if (x.offset != y.offset) {
+				return x.offset < y.offset;
+			}
+		}
+		return false;
 	}
 
 	// Implement GLSLShader class functions
 
+	GLSLShader::GLSLShader() {}
+
+	GLSLShader::GLSLShader(const GLSLShader& shader) {
+		*this = shader;
+	}
+
 	void GLSLShader::operator = (const GLSLShader& shader) {
-		setVertexShaderSource(shader.getVertexShaderSource());
-		setFragmentShaderSource(shader.getFragmentShaderSource());
-		setVertexAttributeSizes(shader.getVertexAttributeSizes());
-		setCamera(*shader.m_camera);
-		setCameraUniformName(shader.getCameraUniformName());
+		if (this == &shader) {
+			return;
+		}
+		if (m_shaderID != 0) {
+			Application::Graphics.releaseProgram(m_shaderID);
+			m_shaderID = 0;
+		}
+		m_vertexShaderSource = shader.m_vertexShaderSource;
+		m_fragmentShaderSource = shader.m_fragmentShaderSource;
+		m_vertexLayout = shader.m_vertexLayout;
+		m_instanced = shader.m_instanced;
+		m_textureUnitCount = shader.m_textureUnitCount;
+		m_textureSamplerUniformName = shader.m_textureSamplerUniformName;
+		m_camera = shader.m_camera;
+		m_cameraUniformName = shader.m_cameraUniformName;
+		m_uniformLocations.clear();
+		m_cameraUniform = Uniform<glm::mat4>();
+		m_cameraBlock = false;
+		if (shader.m_shaderID == 0) {
+			return;
+		}
+		// Acquiring the other shader's sources takes a reference to its
+		// program, whose uniform locations can then be shared
+		m_shaderID = Application::Graphics.acquireProgram(m_vertexShaderSource,
+			m_fragmentShaderSource);
+		if (m_shaderID == shader.m_shaderID) {
+			m_uniformLocations = shader.m_uniformLocations;
+			m_cameraUniform = shader.m_cameraUniform;
+			m_cameraBlock = shader.m_cameraBlock;
+			return;
+		}
+		// The other shader's program was not shared, so this shader compiled
+		// its own
+		Application::Graphics.releaseProgram(m_shaderID);
 		compile();
 	}
 
@@ -109,93 +240,150 @@ namespace ActiasFW {
 	}
 
 	void GLSLShader::begin() {
-		glUseProgram(m_shaderID);
-		for (unsigned int a = 0; a < m_vertexAttributes.size(); a++) {
-			glVertexAttribPointer(a, m_vertexAttributes.at(a).first, GL_FLOAT,
-				GL_FALSE, m_vertexAttributeStride,
-				(void*)m_vertexAttributes.at(a).second);
-			glEnableVertexAttribArray(a);
+		Application::Graphics.m_state.useProgram(m_shaderID);
+		Application::Graphics.bindVertexArray(*this);
+		if (m_cameraBlock) {
+			Application::Graphics.bindCamera(*m_camera);
+		}
+		else if (m_cameraUniform.isValid()) {
+			upload(m_cameraUniform, m_camera->getMatrix());
 		}
-		if (!m_cameraUniformName.empty()) {
-			upload4x4Matrix(m_cameraUniformName, m_camera->getMatrix());
+	}
+
+	void GLSLShader::bindInstanceAttributes(GLintptr offset) {
+		const GLsizei stride = sizeof(SpriteInstance);
+		glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, stride,
+			(void*)(offset + offsetof(SpriteInstance, position)));
+		glVertexAttribPointer(1, 2, GL_FLOAT, GL_FALSE, stride,
+			(void*)(offset + offsetof(SpriteInstance, dimensions)));
+		glVertexAttribPointer(2, 1, GL_FLOAT, GL_FALSE, stride,
+			(void*)(offset + offsetof(SpriteInstance, rotation)));
+		glVertexAttribPointer(3, 4, GL_FLOAT, GL_FALSE, stride,
+			(void*)(offset + offsetof(SpriteInstance, textureBox)));
+		glVertexAttribPointer(4, 4, GL_UNSIGNED_BYTE, GL_TRUE, stride,
+			(void*)(offset + offsetof(SpriteInstance, color)));
+		glVertexAttribPointer(5, 1, GL_FLOAT, GL_FALSE, stride,
+			(void*)(offset + offsetof(SpriteInstance, mode)));
+		for (GLuint a = 0; a < 6; a++) {
+			glVertexAttribDivisor(a, 1);
+			glEnableVertexAttribArray(a);
 		}
 	}
 
+	void GLSLShader::bindVertexAttributes() {
+		m_vertexLayout.bind();
+	}
+
+	void GLSLShader::upload(const Uniform<int>& uniform, int value) {
+		glUniform1i(uniform.location, (GLint)value);
+	}
+
+	void GLSLShader::upload(const Uniform<float>& uniform, float value) {
+		glUniform1f(uniform.location, value);
+	}
+
+	void GLSLShader::upload(const Uniform<glm::vec2>& uniform,
+		const glm::vec2& value) {
+		glUniform2f(uniform.location, value.x, value.y);
+	}
+
+	void GLSLShader::upload(const Uniform<glm::vec3>& uniform,
+		const glm::vec3& value) {
+		glUniform3f(uniform.location, value.x, value.y, value.z);
+	}
+
+	void GLSLShader::upload(const Uniform<glm::vec4>& uniform,
+		const glm::vec4& value) {
+		glUniform4f(uniform.location, value.x, value.y, value.z, value.w);
+	}
+
+	void GLSLShader::upload(const Uniform<glm::mat4>& uniform,
+		const glm::mat4& value) {
+		glUniformMatrix4fv(uniform.location, 1, GL_FALSE, &(value[0][0]));
+	}
+
 	bool GLSLShader::uploadInt(const std::string& uniformName, int value) {
-		GLint location;
-		if (!getUniformLocation(uniformName, location)) {
+		Uniform<int> uniform = getUniform<int>(uniformName);
+		if (!uniform.isValid()) {
 			return false;
 		}
-		glUniform1i(location, (GLint)value);
+		upload(uniform, value);
 		return true;
 	}
 
 	bool GLSLShader::uploadFloat(const std::string& uniformName, float value) {
-		GLint location;
-		if (!getUniformLocation(uniformName, location)) {
+		Uniform<float> uniform = getUniform<float>(uniformName);
+		if (!uniform.isValid()) {
 			return false;
 		}
-		glUniform1f(location, value);
+		upload(uniform, value);
 		return true;
 	}
 
 	bool GLSLShader::upload2DVector(const std::string& uniformName,
 		const glm::vec2& value) {
-		GLint location;
-		if (!getUniformLocation(uniformName, location)) {
+		Uniform<glm::vec2> uniform = getUniform<glm::vec2>(uniformName);
+		if (!uniform.isValid()) {
 			return false;
 		}
-		glUniform2f(location, value.x, value.y);
+		upload(uniform, value);
 		return true;
 	}
 
 	bool GLSLShader::upload3DVector(const std::string& uniformName,
 		const glm::vec3& value) {
-		GLint location;
-		if (!getUniformLocation(uniformName, location)) {
+		Uniform<glm::vec3> uniform = getUniform<glm::vec3>(uniformName);
+		if (!uniform.isValid()) {
 			return false;
 		}
-		glUniform3f(location, value.x, value.y, value.z);
+		upload(uniform, value);
 		return true;
 	}
 
 	bool GLSLShader::upload4DVector(const std::string& uniformName,
 		const glm::vec4& value) {
-		GLint location;
-		if (!getUniformLocation(uniformName, location)) {
+		Uniform<glm::vec4> uniform = getUniform<glm::vec4>(uniformName);
+		if (!uniform.isValid()) {
 			return false;
 		}
-		glUniform4f(location, value.x, value.y, value.z, value.w);
+		upload(uniform, value);
 		return true;
 	}
 
 	bool GLSLShader::upload4x4Matrix(const std::string& uniformName,
 		const glm::mat4& value) {
-		GLint location;
-		if (!getUniformLocation(uniformName, location)) {
+		Uniform<glm::mat4> uniform = getUniform<glm::mat4>(uniformName);
+		if (!uniform.isValid()) {
 			return false;
 		}
-		glUniformMatrix4fv(location, 1, GL_FALSE, &(value[0][0]));
+		upload(uniform, value);
 		return true;
 	}
 
 	void GLSLShader::end() {
-		for (unsigned int a = 0; a < m_vertexAttributes.size(); a++) {
-			glDisableVertexAttribArray(a);
+		if (m_instanced) {
+			for (GLuint a = 0; a < 6; a++) {
+				glVertexAttribDivisor(a, 0);
+				glDisableVertexAttribArray(a);
+			}
 		}
-		glUseProgram(0);
 	}
 
 	void GLSLShader::destroy() {
 		end();
 		m_vertexShaderSource = "";
 		m_fragmentShaderSource = "";
-		glDeleteProgram(m_shaderID);
+		Application::Graphics.releaseProgram(m_shaderID);
 		m_shaderID = 0;
-		m_vertexAttributes.clear();
-		m_vertexAttributeStride = 0;
+		m_vertexLayout = VertexLayout();
+		m_instanced = false;
+		m_textureUnitCount = 1;
+		m_textureSamplerUniformName = "";
 		m_camera = 0;
 		m_cameraUniformName = "";
+		m_uniformLocations.clear();
+		m_cameraUniform = Uniform<glm::mat4>();
+		m_cameraBlock = false;
 	}
 
 	const std::string& GLSLShader::getVertexShaderSource() const {
@@ -222,24 +410,51 @@ namespace ActiasFW {
 
 	std::vector<unsigned int> GLSLShader::getVertexAttributeSizes() const {
 		std::vector<unsigned int> vertexAttributeSizes;
-		for (const std::pair<unsigned int, unsigned int>& attribute
-			: m_vertexAttributes) {
-			vertexAttributeSizes.push_back(attribute.first);
+		for (const VertexAttribute& attribute
+			: m_vertexLayout.getAttributes()) {
+			vertexAttributeSizes.push_back((unsigned int)attribute.size);
 		}
 		return vertexAttributeSizes;
 	}
 
 	void GLSLShader::setVertexAttributeSizes(
 		const std::vector<unsigned int>& vertexAttributeSizes) {
-		m_vertexAttributes.resize(vertexAttributeSizes.size());
-		m_vertexAttributeStride = 0;
-		for (unsigned int a = 0; a < vertexAttributeSizes.size(); a++) {
-			m_vertexAttributes[a].first = vertexAttributeSizes.at(a);
-			m_vertexAttributes[a].second
-				= m_vertexAttributeStride * sizeof(float);
-			m_vertexAttributeStride += vertexAttributeSizes.at(a);
-		}
-		m_vertexAttributeStride *= sizeof(float);
+		m_vertexLayout = VertexLayout::OfFloats(vertexAttributeSizes);
+	}
+
+	unsigned int GLSLShader::getVertexAttributeStride() const {
+		return (unsigned int)m_vertexLayout.getStride();
+	}
+
+	const VertexLayout& GLSLShader::getVertexLayout() const {
+		return m_vertexLayout;
+	}
+
+	void GLSLShader::setVertexLayout(const VertexLayout& vertexLayout) {
+		m_vertexLayout = vertexLayout;
+	}
+
+	bool GLSLShader::isInstanced() const {
+		return m_instanced;
+	}
+
+	void GLSLShader::setInstanced(bool instanced) {
+		m_instanced = instanced;
+	}
+
+	unsigned int GLSLShader::getTextureUnitCount() const {
+		return m_textureUnitCount;
+	}
+
+	const std::string& GLSLShader::getTextureSamplerUniformName() const {
+		return m_textureSamplerUniformName;
+	}
+
+	void GLSLShader::setTextureUnits(unsigned int textureUnitCount,
+		const std::string& textureSamplerUniformName) {
+		m_textureUnitCount = std::clamp(textureUnitCount, 1u,
+			GraphicsManager::MaxTextureUnits);
+		m_textureSamplerUniformName = textureSamplerUniformName;
 	}
 
 	Camera& GLSLShader::getCamera() {
@@ -257,350 +472,2409 @@ namespace ActiasFW {
 	void GLSLShader::setCameraUniformName(
 		const std::string& cameraUniformName) {
 		m_cameraUniformName = cameraUniformName;
+		if (m_shaderID != 0) {
+			locateCameraUniform();
+		}
 	}
 
 	bool GLSLShader::compile() {
-		const char* vSource = m_vertexShaderSource.c_str();
-		GLuint vID = glCreateShader(GL_VERTEX_SHADER);
-		ACTIASFW_LOG(GLSLShader, Info, "Compiling vertex shader ", vID);
-		glShaderSource(vID, 1, &vSource, 0);
-		glCompileShader(vID);
-		int vSuccess;
-		glGetShaderiv(vID, GL_COMPILE_STATUS, &vSuccess);
-		if (!vSuccess) {
-			char vBuffer[1024];
-			glGetShaderInfoLog(vID, 1024, 0, vBuffer);
-			ACTIASFW_LOG(GLSLShader, Warning, "Failed to compile vertex ",
-				"shader ", vID, "\n", vBuffer);
-			return false;
-		}
-		const char* fSource = m_fragmentShaderSource.c_str();
-		GLuint fID = glCreateShader(GL_FRAGMENT_SHADER);
-		ACTIASFW_LOG(GLSLShader, Info, "Compiling fragment shader ", fID);
-		glShaderSource(fID, 1, &fSource, 0);
-		glCompileShader(fID);
-		int fSuccess;
-		glGetShaderiv(fID, GL_COMPILE_STATUS, &fSuccess);
-		if (!fSuccess) {
-			char fBuffer[1024];
-			glGetShaderInfoLog(fID, 1024, 0, fBuffer);
-			ACTIASFW_LOG(GLSLShader, Warning, "Failed to compile fragment ",
-				"shader ", fID, "\n", fBuffer);
+		m_shaderID = Application::Graphics.acquireProgram(m_vertexShaderSource,
+			m_fragmentShaderSource);
+		if (m_shaderID == 0) {
 			return false;
 		}
-		m_shaderID = glCreateProgram();
-		glAttachShader(m_shaderID, vID);
-		glAttachShader(m_shaderID, fID);
-		ACTIASFW_LOG(GLSLShader, Info, "Linking shader program ", m_shaderID);
-		glLinkProgram(m_shaderID);
-		int pSuccess;
-		glGetProgramiv(m_shaderID, GL_LINK_STATUS, &pSuccess);
-		if (!pSuccess) {
-			char pBuffer[1024];
-			glGetProgramInfoLog(m_shaderID, 1024, 0, pBuffer);
-			ACTIASFW_LOG(GLSLShader, Warning, "Failed to link shader program ",
-				m_shaderID);
-			return false;
+		cacheUniformLocations();
+		locateCameraUniform();
+		if (m_textureUnitCount > 1) {
+			Application::Graphics.m_state.useProgram(m_shaderID);
+			for (unsigned int u = 0; u < m_textureUnitCount; u++) {
+				uploadInt(m_textureSamplerUniformName + "["
+					+ std::to_string(u) + "]", (int)u);
+			}
 		}
-		glDeleteShader(vID);
-		glDeleteShader(fID);
 		return true;
 	}
 
-	bool GLSLShader::getUniformLocation(const std::string& uniformName,
-		GLint& location) {
-		location = glGetUniformLocation(m_shaderID, uniformName.c_str());
-		return location != GL_INVALID_VALUE && location != GL_INVALID_OPERATION;
+	void GLSLShader::cacheUniformLocations() {
+		m_uniformLocations.clear();
+		GLint uniformCount = 0;
+		glGetProgramiv(m_shaderID, GL_ACTIVE_UNIFORMS, &uniformCount);
+		for (GLint u = 0; u < uniformCount; u++) {
+			char name[256];
+			GLint size = 0;
+			GLenum type = 0;
+			glGetActiveUniform(m_shaderID, (GLuint)u, sizeof(name), 0, &size,
+				&type, name);
+			GLint location = glGetUniformLocation(m_shaderID, name);
+			if (location < 0) {
+				// Members of uniform blocks have no location
+				continue;
+			}
+			std::string uniformName = name;
+			m_uniformLocations[uniformName] = location;
+			size_t bracket = uniformName.rfind("[0]");
+			if (bracket == std::string::npos
+				|| bracket + 3 != uniformName.length()) {
+				continue;
+			}
+			// Arrays are listed once, so locate each of their elements
+			std::string arrayName = uniformName.substr(0, bracket);
+			m_uniformLocations[arrayName] = location;
+			for (GLint e = 1; e < size; e++) {
+				std::string elementName = arrayName + "["
+					+ std::to_string(e) + "]";
+				m_uniformLocations[elementName] = glGetUniformLocation(
+					m_shaderID, elementName.c_str());
+			}
+		}
 	}
 
-	// Implement GraphicsManager class functions
-
-	bool GraphicsManager::initialize(const glm::vec3& backgroundColor) {
-		ACTIASFW_LOG(Graphics, Info, "Initializing graphics manager");
-		if (m_initialized) {
-			ACTIASFW_LOG(Graphics, Error, "Graphics manager already ",
-				"initialized");
-			return false;
+	void GLSLShader::locateCameraUniform() {
+		m_cameraBlock = false;
+		m_cameraUniform = getUniform<glm::mat4>(m_cameraUniformName);
+		if (m_cameraUniformName.empty() || m_cameraUniform.isValid()) {
+			return;
 		}
-		ACTIASFW_LOG(Graphics, Info, "Initializing GLEW library");
-		if (glewInit() != GLEW_OK) {
-			ACTIASFW_LOG(Graphics, Error, "Failed to initialize GLEW");
-			return false;
+		const char* name = m_cameraUniformName.c_str();
+		GLuint index = GL_INVALID_INDEX;
+		glGetUniformIndices(m_shaderID, 1, &name, &index);
+		if (index == GL_INVALID_INDEX) {
+			return;
 		}
-		const GLubyte* glVersion = glGetString(GL_VERSION);
-		ACTIASFW_LOG(Graphics, Info, glVersion);
-		ACTIASFW_LOG(Graphics, Info, "Initializing FreeType library");
-		if (FT_Init_FreeType(&m_freeType) != FT_Err_Ok) {
-			ACTIASFW_LOG(Graphics, Info, "Failed to initialize FreeType");
+		GLint block = -1;
+		glGetActiveUniformsiv(m_shaderID, 1, &index, GL_UNIFORM_BLOCK_INDEX,
+			&block);
+		if (block < 0) {
+			return;
+		}
+		glUniformBlockBinding(m_shaderID, (GLuint)block,
+			GraphicsManager::CameraBinding);
+		m_cameraBlock = true;
+	}
+
+	bool GLSLShader::getUniformLocation(const std::string& uniformName,
+		GLint& location) const {
+		std::map<std::string, GLint>::const_iterator it
+			= m_uniformLocations.find(uniformName);
+		if (it == m_uniformLocations.end()) {
+			location = -1;
 			return false;
 		}
-		ACTIASFW_LOG(Graphics, Info, "Initializing OpenGL parameters");
-		glClearColor(backgroundColor.r, backgroundColor.g, backgroundColor.b,
-			1.0f);
-		glEnable(GL_BLEND);
-		glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
-		glPixelStorei(GL_UNPACK_ALIGNMENT, GL_TRUE);
-		glfwSwapInterval(1);
-		glGenVertexArrays(1, &m_VAOID);
-		glBindVertexArray(m_VAOID);
-		glGenBuffers(1, &m_VBOID);
-		glBindBuffer(GL_ARRAY_BUFFER, m_VBOID);
-		glGenBuffers(1, &m_IBOID);
-		glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, m_IBOID);
-		m_defaultCamera.initialize();
-		m_defaultShader.initialize(
-			"#version 330 core\n"
-			"layout (location = 0) in vec3 vertexPosition;\n"
-			"layout (location = 1) in vec2 vertexTexturePosition;\n"
-			"layout (location = 2) in vec4 vertexColor;\n"
-			"layout (location = 3) in float vertexMode;\n"
-			"uniform mat4 cameraMatrix;\n"
-			"out vec2 fragmentTexturePosition;\n"
-			"out vec4 fragmentColor;\n"
-			"out float fragmentMode;\n"
-			"void main() {\n"
-			"	gl_Position = cameraMatrix * vec4(vertexPosition, 1.0);\n"
-			"	fragmentTexturePosition = vertexTexturePosition;\n"
-			"	fragmentColor = vertexColor;\n"
-			"	fragmentMode = vertexMode;\n"
-			"}\n",
-			"#version 330 core\n"
-			"in vec2 fragmentTexturePosition;\n"
-			"in vec4 fragmentColor;\n"
-			"in float fragmentMode;\n"
-			"uniform sampler2D textureSampler;\n"
-			"void main() {\n"
-			"	if (fragmentMode >= 2.0) {\n"
-			"		vec4 textureColor = vec4(1.0, 1.0, 1.0,\n"
-			"			texture(textureSampler, fragmentTexturePosition).r);\n"
-			"		gl_FragColor = fragmentColor * textureColor;\n"
-			"	} else {\n"
-			"		gl_FragColor = (1.0 - fragmentMode)"
-			"			* texture(textureSampler, fragmentTexturePosition)"
-			"			+ fragmentMode * fragmentColor;\n"
-			"	}\n"
-			"}\n",
-			{ 3, 2, 4, 1 },
-			m_defaultCamera, "cameraMatrix");
-		m_initialized = true;
+		location = it->second;
 		return true;
 	}
 
-	void GraphicsManager::update(float timeStep) {
-		m_defaultCamera.update(timeStep);
-	}
+	// Implement StreamBuffer class functions
 
-	void GraphicsManager::begin() {
-		glClear(GL_COLOR_BUFFER_BIT);
-		m_sprites.clear();
-		m_glyphs.clear();
+	bool StreamBuffer::initialize(GLenum target, GLsizeiptr size) {
+		m_target = target;
+		m_size = size;
+		m_persistent = OpenGL::IsExtensionSupported("GL_ARB_buffer_storage");
+		m_cursor = 0;
+		m_section = 0;
+		glGenBuffers(1, &m_bufferID);
+		Application::Graphics.getStateCache().bindBuffer(m_target, m_bufferID);
+		if (m_persistent) {
+			GLbitfield flags = GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT
+				| GL_MAP_COHERENT_BIT;
+			glBufferStorage(m_target, m_size, 0, flags);
+			m_memory = (unsigned char*)glMapBufferRange(m_target, 0, m_size,
+				flags);
+			return m_memory != 0;
+		}
+		glBufferData(m_target, m_size, 0, GL_STREAM_DRAW);
+		return true;
 	}
 
-	void GraphicsManager::submit(const std::string& text,
-		const glm::vec3& position, const glm::vec4& box, float scale,
-		const glm::vec4& color, const std::string& fontFileName,
-		Alignment horizontalAlignment, Alignment verticalAlignment,
-		GLSLShader& shader) {
-		if (text.empty()) {
-			return;
-		}
-		const Font* font = getFont(fontFileName);
-		if (font == 0) {
-			return;
-		}
-		if (font->getGlyphs().empty()) {
-			return;
-		}
-		if (m_glyphs.find(&shader) == m_glyphs.end()) {
-			m_glyphs[&shader] = std::vector<Glyph>(0);
-		}
-		float labelWidth = 0.0f;
-		for (char c : text) {
-			labelWidth += font->getGlyphs().at(c).getOffset();
-		}
-		labelWidth *= scale;
-		float x = 0.0f;
-		if (horizontalAlignment == ALIGN_LEFT) {
-			x = box.x;
-		}
-		else if (horizontalAlignment == ALIGN_RIGHT) {
-			x = (box.x + box.z) - labelWidth;
-		}
-		else if (horizontalAlignment == ALIGN_CENTER) {
-			float m = box.x + (box.z / 2.0f);
-			x = m - (labelWidth / 2.0f);
+	void* StreamBuffer::map(GLsizeiptr size, GLsizeiptr alignment,
+		GLintptr& offset) {
+		if (size <= 0 || size > getCapacity() - alignment) {
+			return 0;
 		}
-		else {
-			x = position.x;
+		offset = ((m_cursor + alignment - 1) / alignment) * alignment;
+		if (m_persistent) {
+			GLintptr sectionEnd = (m_section + 1) * getCapacity();
+			if (offset + size > sectionEnd) {
+				advanceSection();
+				offset = ((m_cursor + alignment - 1) / alignment) * alignment;
+			}
+			m_cursor = offset + size;
+			return m_memory + offset;
 		}
-		x -= font->getGlyphs().at(text.at(0)).getBearing().x * scale;
-		float labelHeight
-			= (font->getMinimumBearing() + font->getMaximumBearing()) * scale;
-		float y = 0.0f;
-		if (verticalAlignment == ALIGN_BOTTOM) {
-			y = box.y + (font->getMinimumBearing() * scale);
+		Application::Graphics.getStateCache().bindBuffer(m_target, m_bufferID);
+		GLbitfield flags = GL_MAP_WRITE_BIT | GL_MAP_INVALIDATE_RANGE_BIT
+			| GL_MAP_UNSYNCHRONIZED_BIT;
+		if (offset + size > m_size) {
+			glBufferData(m_target, m_size, 0, GL_STREAM_DRAW);
+			offset = 0;
 		}
-		else if (verticalAlignment == ALIGN_TOP) {
-			y = (box.y + box.w) - labelHeight;
+		m_cursor = offset + size;
+		m_mapped = true;
+		return glMapBufferRange(m_target, offset, size, flags);
+	}
+
+	void StreamBuffer::unmap() {
+		if (m_mapped) {
+			glUnmapBuffer(m_target);
+			m_mapped = false;
 		}
-		else if (verticalAlignment == ALIGN_CENTER) {
-			float m = box.y + (box.w / 2.0f);
-			y = m - (labelHeight / 2.0f);
+	}
+
+	void StreamBuffer::destroy() {
+		unmap();
+		for (GLsync& fence : m_fences) {
+			if (fence != 0) {
+				glDeleteSync(fence);
+				fence = 0;
+			}
 		}
-		else {
-			y = position.y;
+		GLStateCache& state = Application::Graphics.getStateCache();
+		if (m_persistent && m_memory != 0) {
+			state.bindBuffer(m_target, m_bufferID);
+			glUnmapBuffer(m_target);
 		}
-		for (unsigned int i = 0; i < text.length(); i++) {
-			char c = text.at(i);
-			Glyph g = font->getGlyphs().at(c);
-			g.initialize(glm::vec3(x + (g.getBearing().x * scale),
-				y - ((g.getDimensions().y - g.getBearing().y) * scale),
-				position.z), g.getDimensions() * scale, g.getTextureFileName());
-			g.setColor(color);
-			x += (float)g.getOffset() * scale;
-			if (g.getPosition().x < box.x
-				|| g.getPosition().x + g.getDimensions().x > box.x + box.z) {
-				continue;
-			}
-			if (g.getPosition().y < box.y
-				|| g.getPosition().y + g.getDimensions().y > box.y + box.w) {
-				continue;
-			}
-			m_glyphs[&shader].push_back(g);
+		state.bindBuffer(m_target, 0);
+		glDeleteBuffers(1, &m_bufferID);
+		m_target = 0;
+		m_bufferID = 0;
+		m_size = 0;
+		m_persistent = false;
+		m_memory = 0;
+		m_cursor = 0;
+		m_section = 0;
+	}
+
+	GLuint StreamBuffer::getBufferID() const {
+		return m_bufferID;
+	}
+
+	GLsizeiptr StreamBuffer::getCapacity() const {
+		return m_persistent ? m_size / SectionCount : m_size;
+	}
+
+	bool StreamBuffer::isPersistent() const {
+		return m_persistent;
+	}
+
+	void StreamBuffer::advanceSection() {
+		m_fences[m_section] = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+		m_section = (m_section + 1) % SectionCount;
+		m_cursor = m_section * getCapacity();
+		GLsync& fence = m_fences[m_section];
+		if (fence == 0) {
+			return;
 		}
+		while (glClientWaitSync(fence, GL_SYNC_FLUSH_COMMANDS_BIT, 1000000)
+			== GL_TIMEOUT_EXPIRED);
+		glDeleteSync(fence);
+		fence = 0;
 	}
 
-	void GraphicsManager::submit(const std::string& text,
-		const glm::vec3& position, const glm::vec4& box, float scale,
-		const glm::vec4& color, const std::string& fontFileName,
-		Alignment horizontalAlignment, Alignment verticalAlignment) {
-		submit(text, position, box, scale, color, fontFileName,
-			horizontalAlignment, verticalAlignment, m_defaultShader);
+	// Implement TextureAtlas class functions
+
+	void TextureAtlas::initialize(int pageSize, int padding) {
+		m_pageSize = pageSize;
+		m_padding = padding;
+		m_pages.clear();
 	}
 
-	bool CompareSpriteDepth(const std::pair<GLSLShader*, Sprite*>& a,
-		const std::pair<GLSLShader*, Sprite*>& b) {
-		if (a.second == 0 || b.second == 0) {
-			return false;
+	bool TextureAtlas::accepts(const glm::ivec2& dimensions) const {
+		glm::ivec2 pd = getPaddedDimensions(dimensions);
+		return m_pageSize > 0 && pd.x <= m_pageSize / 2
+			&& pd.y <= m_pageSize / 2;
+	}
+
+	glm::ivec2 TextureAtlas::getPaddedDimensions(
+		const glm::ivec2& dimensions) const {
+		return glm::ivec2(dimensions.x + 2 * m_padding,
+			dimensions.y + 2 * m_padding);
+	}
+
+	void TextureAtlas::pad(const unsigned char* pixels,
+		const glm::ivec2& dimensions, std::vector<unsigned char>& padded) const {
+		glm::ivec2 pd = getPaddedDimensions(dimensions);
+		padded.resize(pd.x * pd.y * 4);
+		for (int y = 0; y < pd.y; y++) {
+			int sy = std::clamp(y - m_padding, 0, dimensions.y - 1);
+			for (int x = 0; x < pd.x; x++) {
+				int sx = std::clamp(x - m_padding, 0, dimensions.x - 1);
+				std::memcpy(&padded[(x + y * pd.x) * 4],
+					&pixels[(sx + sy * dimensions.x) * 4], 4);
+			}
 		}
-		return a.second->getPosition().z < b.second->getPosition().z;
 	}
 
-	void GraphicsManager::end() {
-		if (!m_glyphs.empty()) {
-			for (std::pair<GLSLShader*, std::vector<Glyph>> pair : m_glyphs) {
-				submit(m_glyphs[pair.first], *pair.first);
+	void TextureAtlas::reserve(const glm::ivec2& dimensions, GLuint& textureID,
+		glm::vec4& box, glm::ivec2& position) {
+		glm::ivec2 pd = getPaddedDimensions(dimensions);
+		size_t node = 0;
+		Page* page = 0;
+		for (Page& p : m_pages) {
+			if (fit(p, pd, node, position)) {
+				page = &p;
+				break;
 			}
 		}
-		if (m_sprites.empty()) {
-			return;
+		if (page == 0) {
+			m_pages.push_back(Page());
+			page = &m_pages.back();
+			page->skyline.push_back(glm::ivec3(0, 0, m_pageSize));
+			glGenTextures(1, &page->textureID);
+			Application::Graphics.getStateCache().bindTexture(0,
+				page->textureID);
+			glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+			glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+			glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+			glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+			glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA8, m_pageSize, m_pageSize, 0,
+				GL_RGBA, GL_UNSIGNED_BYTE, 0);
+			fit(*page, pd, node, position);
 		}
-		std::stable_sort(m_sprites.begin(), m_sprites.end(),
-			CompareSpriteDepth);
-		glBindVertexArray(m_VAOID);
-		std::vector<unsigned int> indices;
-		std::vector<float> vertices;
-		unsigned int count = 0;
-		GLSLShader* currentShader = m_sprites.front().first;
-		currentShader->begin();
-		GLuint currentTexture = getTexture(
-			m_sprites.front().second->getTextureFileName());
-		glBindTexture(GL_TEXTURE_2D, currentTexture);
-		for (const std::pair<GLSLShader*, Sprite*>& pair : m_sprites) {
-			if (currentShader != pair.first) {
-				if (count > 0) {
-					draw(indices, vertices);
-					indices.clear();
-					vertices.clear();
-					count = 0;
-				}
-				currentShader->end();
-				currentShader = pair.first;
-				currentShader->begin();
+		place(*page, node, position, pd);
+		textureID = page->textureID;
+		box = glm::vec4((float)(position.x + m_padding) / (float)m_pageSize,
+			(float)(position.y + m_padding) / (float)m_pageSize,
+			(float)dimensions.x / (float)m_pageSize,
+			(float)dimensions.y / (float)m_pageSize);
+	}
+
+	void TextureAtlas::destroy() {
+		for (Page& page : m_pages) {
+			glDeleteTextures(1, &page.textureID);
+		}
+		m_pages.clear();
+		m_pageSize = 0;
+		m_padding = 0;
+	}
+
+	int TextureAtlas::getPageSize() const {
+		return m_pageSize;
+	}
+
+	size_t TextureAtlas::getPageCount() const {
+		return m_pages.size();
+	}
+
+	bool TextureAtlas::fit(const Page& page, const glm::ivec2& dimensions,
+		size_t& node, glm::ivec2& position) const {
+		bool found = false;
+		for (size_t n = 0; n < page.skyline.size(); n++) {
+			int x = page.skyline.at(n).x;
+			if (x + dimensions.x > m_pageSize) {
+				break;
+			}
+			int y = 0;
+			int remaining = dimensions.x;
+			for (size_t i = n; remaining > 0; i++) {
+				y = std::max(y, page.skyline.at(i).y);
+				remaining -= page.skyline.at(i).z;
+			}
+			if (y + dimensions.y > m_pageSize) {
+				continue;
+			}
+			if (!found || y < position.y) {
+				found = true;
+				node = n;
+				position = glm::ivec2(x, y);
+			}
+		}
+		return found;
+	}
+
+	void TextureAtlas::place(Page& page, size_t node,
+		const glm::ivec2& position, const glm::ivec2& dimensions) {
+		std::vector<glm::ivec3>& sky = page.skyline;
+		sky.insert(sky.begin() + node, glm::ivec3(position.x,
+			position.y + dimensions.y, dimensions.x));
+		size_t i = node + 1;
+		while (i < sky.size()) {
+			int shrink = (sky.at(i - 1).x + sky.at(i - 1).z) - sky.at(i).x;
+			if (shrink <= 0) {
+				break;
+			}
+			sky[i].x += shrink;
+			sky[i].z -= shrink;
+			if (sky.at(i).z > 0) {
+				break;
+			}
+			sky.erase(sky.begin() + i);
+		}
+		for (i = 0; i + 1 < sky.size();) {
+			if (sky.at(i).y == sky.at(i + 1).y) {
+				sky[i].z += sky.at(i + 1).z;
+				sky.erase(sky.begin() + i + 1);
+			}
+			else {
+				i++;
+			}
+		}
+	}
+
+	// Implement GlyphAtlas class functions
+
+	bool GlyphAtlas::initialize(int width, int pageSize, int padding) {
+		if (m_textureID != 0) {
+			return false;
+		}
+		m_width = width;
+		m_height = pageSize;
+		m_pageSize = pageSize;
+		m_padding = padding;
+		GLint maximumSize = 0;
+		glGetIntegerv(GL_MAX_TEXTURE_SIZE, &maximumSize);
+		m_maximumHeight = std::min((int)(MaxPages / (width / pageSize))
+			* pageSize, (int)maximumSize);
+		m_pixels.assign((size_t)(m_width * m_height), 0);
+		m_pages.clear();
+		m_generation = 0;
+		GLStateCache& state = Application::Graphics.getStateCache();
+		glGenTextures(1, &m_textureID);
+		state.bindTexture(0, m_textureID);
+		state.bindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+		glTexImage2D(GL_TEXTURE_2D, 0, GL_RED, m_width, m_height, 0, GL_RED,
+			GL_UNSIGNED_BYTE, m_pixels.data());
+		return m_textureID != 0;
+	}
+
+	int GlyphAtlas::reserve(const glm::ivec2& dimensions, char32_t codepoint,
+		unsigned int frame, glm::ivec2& position,
+		std::vector<char32_t>& evicted) {
+		glm::ivec2 pd = dimensions + glm::ivec2(m_padding);
+		if (pd.x > m_pageSize || pd.y > m_pageSize) {
+			return -1;
+		}
+		glm::ivec2 p = glm::ivec2();
+		size_t page = m_pages.size();
+		for (size_t i = 0; i < m_pages.size(); i++) {
+			if (fit(m_pages.at(i), pd, p)) {
+				page = i;
+				break;
+			}
+		}
+		if (page == m_pages.size()) {
+			size_t capacity = (size_t)((m_width / m_pageSize)
+				* (m_height / m_pageSize));
+			if (m_pages.size() < MaxPages
+				&& (m_pages.size() < capacity || grow())) {
+				m_pages.push_back(Page());
+			}
+			else {
+				// Clear the least recently drawn page not drawn this frame
+				for (size_t i = 0; i < m_pages.size(); i++) {
+					if (m_pages.at(i).frame != frame && (page == m_pages.size()
+						|| m_pages.at(i).frame < m_pages.at(page).frame)) {
+						page = i;
+					}
+				}
+				if (page == m_pages.size()) {
+					return -1;
+				}
+				Page& cleared = m_pages.at(page);
+				evicted.insert(evicted.end(), cleared.glyphs.begin(),
+					cleared.glyphs.end());
+				cleared.glyphs.clear();
+				cleared.cursor = glm::ivec2();
+				cleared.rowHeight = 0;
+				glm::ivec2 origin = getPageOrigin(page);
+				for (int y = 0; y < m_pageSize; y++) {
+					std::memset(&m_pixels[origin.x + (origin.y + y) * m_width],
+						0, m_pageSize);
+				}
+				GLStateCache& state = Application::Graphics.getStateCache();
+				state.bindTexture(0, m_textureID);
+				state.bindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+				glPixelStorei(GL_UNPACK_ROW_LENGTH, m_width);
+				glTexSubImage2D(GL_TEXTURE_2D, 0, origin.x, origin.y,
+					m_pageSize, m_pageSize, GL_RED, GL_UNSIGNED_BYTE,
+					&m_pixels[origin.x + origin.y * m_width]);
+				glPixelStorei(GL_UNPACK_ROW_LENGTH, 0);
+				m_generation++;
+			}
+			if (!fit(m_pages.at(page), pd, p)) {
+				return -1;
+			}
+		}
+		Page& target = m_pages.at(page);
+		if (p.y != target.cursor.y) {
+			target.rowHeight = 0;
+		}
+		target.cursor = glm::ivec2(p.x + pd.x, p.y);
+		target.rowHeight = std::max(target.rowHeight, pd.y);
+		target.frame = frame;
+		target.glyphs.push_back(codepoint);
+		position = getPageOrigin(page) + p;
+		return (int)page;
+	}
+
+	void GlyphAtlas::upload(const unsigned char* pixels, int pitch,
+		const glm::ivec2& position, const glm::ivec2& dimensions) {
+		for (int y = 0; y < dimensions.y; y++) {
+			std::memcpy(&m_pixels[position.x + (position.y + y) * m_width],
+				pixels + y * pitch, dimensions.x);
+		}
+		GLStateCache& state = Application::Graphics.getStateCache();
+		state.bindTexture(0, m_textureID);
+		state.bindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+		glPixelStorei(GL_UNPACK_ROW_LENGTH, m_width);
+		glTexSubImage2D(GL_TEXTURE_2D, 0, position.x, position.y, dimensions.x,
+			dimensions.y, GL_RED, GL_UNSIGNED_BYTE,
+			&m_pixels[position.x + position.y * m_width]);
+		glPixelStorei(GL_UNPACK_ROW_LENGTH, 0);
+	}
+
+	void GlyphAtlas::touch(std::uint64_t pages, unsigned int frame) {
+		for (size_t p = 0; p < m_pages.size(); p++) {
+			if ((pages >> p) & 1) {
+				m_pages[p].frame = frame;
+			}
+		}
+	}
+
+	GLuint GlyphAtlas::getTextureID() const {
+		return m_textureID;
+	}
+
+	glm::ivec2 GlyphAtlas::getDimensions() const {
+		return glm::ivec2(m_width, m_height);
+	}
+
+	unsigned int GlyphAtlas::getGeneration() const {
+		return m_generation;
+	}
+
+	size_t GlyphAtlas::getPageCount() const {
+		return m_pages.size();
+	}
+
+	void GlyphAtlas::destroy() {
+		glDeleteTextures(1, &m_textureID);
+		m_textureID = 0;
+		m_width = 0;
+		m_height = 0;
+		m_maximumHeight = 0;
+		m_pageSize = 0;
+		m_padding = 0;
+		m_pixels.clear();
+		m_pages.clear();
+		m_generation = 0;
+	}
+
+	bool GlyphAtlas::fit(const Page& page, const glm::ivec2& dimensions,
+		glm::ivec2& position) const {
+		glm::ivec2 p = page.cursor;
+		if (p.x + dimensions.x > m_pageSize) {
+			p = glm::ivec2(0, p.y + page.rowHeight);
+		}
+		if (p.y + dimensions.y > m_pageSize) {
+			return false;
+		}
+		position = p;
+		return true;
+	}
+
+	glm::ivec2 GlyphAtlas::getPageOrigin(size_t page) const {
+		size_t pagesPerRow = (size_t)(m_width / m_pageSize);
+		return glm::ivec2((int)(page % pagesPerRow) * m_pageSize,
+			(int)(page / pagesPerRow) * m_pageSize);
+	}
+
+	bool GlyphAtlas::grow() {
+		if (m_height * 2 > m_maximumHeight) {
+			return false;
+		}
+		// Rows are appended below the existing pixels, which stay in place
+		m_height *= 2;
+		m_pixels.resize((size_t)(m_width * m_height), 0);
+		GLStateCache& state = Application::Graphics.getStateCache();
+		state.bindTexture(0, m_textureID);
+		state.bindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+		glTexImage2D(GL_TEXTURE_2D, 0, GL_RED, m_width, m_height, 0, GL_RED,
+			GL_UNSIGNED_BYTE, m_pixels.data());
+		m_generation++;
+		return true;
+	}
+
+	// Implement StaticBatch class functions
+
+	bool StaticBatch::initialize(const std::vector<Sprite*>& sprites,
+		GLSLShader& shader) {
+		if (shader.isInstanced()) {
+			ACTIASFW_LOG(Graphics, Error, "Static batches cannot be drawn with ",
+				"an instanced shader");
+			return false;
+		}
+		m_sprites = sprites;
+		m_shader = &shader;
+		glGenVertexArrays(1, &m_VAOID);
+		glGenBuffers(1, &m_VBOID);
+		glGenBuffers(1, &m_IBOID);
+		m_groups.clear();
+		m_dirty = true;
+		return true;
+	}
+
+	void StaticBatch::markDirty() {
+		m_dirty = true;
+	}
+
+	bool StaticBatch::isDirty() const {
+		return m_dirty;
+	}
+
+	const std::vector<Sprite*>& StaticBatch::getSprites() const {
+		return m_sprites;
+	}
+
+	GLSLShader& StaticBatch::getShader() {
+		return *m_shader;
+	}
+
+	bool StaticBatch::destroy() {
+		if (m_VAOID == 0) {
+			return false;
+		}
+		glDeleteBuffers(1, &m_VBOID);
+		glDeleteBuffers(1, &m_IBOID);
+		glDeleteVertexArrays(1, &m_VAOID);
+		// Deleting bound objects unbinds them
+		Application::Graphics.getStateCache().invalidate();
+		m_VAOID = 0;
+		m_VBOID = 0;
+		m_IBOID = 0;
+		m_sprites.clear();
+		m_shader = 0;
+		m_groups.clear();
+		m_textureIDs.clear();
+		m_dirty = true;
+		return true;
+	}
+
+	// Implement TextMesh class functions
+
+	void TextMesh::initialize(const std::string& text,
+		const glm::vec3& position, const glm::vec4& box, float scale,
+		const glm::vec4& color, const std::string& fontFileName,
+		Alignment horizontalAlignment, Alignment verticalAlignment) {
+		m_text = text;
+		m_position = position;
+		m_box = box;
+		m_scale = scale;
+		m_color = color;
+		m_fontFileName = fontFileName;
+		m_horizontalAlignment = horizontalAlignment;
+		m_verticalAlignment = verticalAlignment;
+		m_dirty = true;
+	}
+
+	const std::string& TextMesh::getText() const {
+		return m_text;
+	}
+
+	void TextMesh::setText(const std::string& text) {
+		if (m_text != text) {
+			m_text = text;
+			m_dirty = true;
+		}
+	}
+
+	const glm::vec3& TextMesh::getPosition() const {
+		return m_position;
+	}
+
+	void TextMesh::setPosition(const glm::vec3& position) {
+		if (m_position != position) {
+			m_position = position;
+			m_dirty = true;
+		}
+	}
+
+	const glm::vec4& TextMesh::getBox() const {
+		return m_box;
+	}
+
+	void TextMesh::setBox(const glm::vec4& box) {
+		if (m_box != box) {
+			m_box = box;
+			m_dirty = true;
+		}
+	}
+
+	const glm::vec4& TextMesh::getColor() const {
+		return m_color;
+	}
+
+	void TextMesh::setColor(const glm::vec4& color) {
+		if (m_color != color) {
+			m_color = color;
+			m_dirty = true;
+		}
+	}
+
+	bool TextMesh::isDirty() const {
+		return m_dirty || (m_atlas != 0
+			&& m_atlas->getGeneration() != m_atlasGeneration);
+	}
+
+	void TextMesh::destroy() {
+		m_text = "";
+		m_position = glm::vec3();
+		m_box = glm::vec4();
+		m_scale = 1.0f;
+		m_color = glm::vec4();
+		m_fontFileName = "";
+		m_horizontalAlignment = NO_ALIGNMENT;
+		m_verticalAlignment = NO_ALIGNMENT;
+		m_dirty = true;
+		m_glyphCount = 0;
+		m_atlas = 0;
+		m_atlasGeneration = 0;
+		m_pages = 0;
+		m_glyphs.clear();
+		m_vertices.clear();
+		m_indices.clear();
+		m_bounds = glm::vec4();
+		m_textureFileName = "";
+	}
+
+	// Implement TileMap class functions
+
+	bool TileMap::initialize(const glm::ivec2& dimensions,
+		const glm::vec3& position, const glm::vec2& tileDimensions,
+		const std::vector<std::string>& tileTextureFileNames,
+		GLSLShader& shader) {
+		if (shader.isInstanced()) {
+			ACTIASFW_LOG(Graphics, Error, "Tile maps cannot be drawn with an ",
+				"instanced shader");
+			return false;
+		}
+		m_dimensions = glm::max(dimensions, glm::ivec2(0, 0));
+		m_position = position;
+		m_tileDimensions = tileDimensions;
+		m_tileTextureFileNames = tileTextureFileNames;
+		m_shader = &shader;
+		m_chunkCounts = (m_dimensions + (ChunkSize - 1)) / ChunkSize;
+		m_chunks.clear();
+		m_chunks.resize((size_t)(m_chunkCounts.x * m_chunkCounts.y));
+		for (int cy = 0; cy < m_chunkCounts.y; cy++) {
+			for (int cx = 0; cx < m_chunkCounts.x; cx++) {
+				Chunk& chunk = m_chunks[cx + cy * m_chunkCounts.x];
+				chunk.origin = glm::ivec2(cx, cy) * ChunkSize;
+				chunk.dimensions = glm::min(glm::ivec2(ChunkSize, ChunkSize),
+					m_dimensions - chunk.origin);
+				chunk.bounds = glm::vec4(
+					glm::vec2(m_position) + glm::vec2(chunk.origin)
+					* m_tileDimensions,
+					glm::vec2(chunk.dimensions) * m_tileDimensions);
+				chunk.batch.initialize(std::vector<Sprite*>(), shader);
+			}
+		}
+		m_tiles.assign(m_chunks.size() * ChunkSize * ChunkSize, EmptyTile);
+		for (const std::string& fileName : m_tileTextureFileNames) {
+			Application::Graphics.setTextureRepeated(fileName);
+		}
+		m_revision++;
+		return true;
+	}
+
+	std::uint16_t TileMap::getTile(const glm::ivec2& cell) const {
+		if (cell.x < 0 || cell.y < 0 || cell.x >= m_dimensions.x
+			|| cell.y >= m_dimensions.y) {
+			return EmptyTile;
+		}
+		return m_tiles.at(getTileIndex(cell));
+	}
+
+	void TileMap::setTile(const glm::ivec2& cell, std::uint16_t tile) {
+		if (cell.x < 0 || cell.y < 0 || cell.x >= m_dimensions.x
+			|| cell.y >= m_dimensions.y) {
+			return;
+		}
+		std::uint16_t& current = m_tiles[getTileIndex(cell)];
+		if (current == tile) {
+			return;
+		}
+		current = tile;
+		m_chunks[cell.x / ChunkSize + (cell.y / ChunkSize) * m_chunkCounts.x]
+			.batch.markDirty();
+		m_revision++;
+	}
+
+	const glm::ivec2& TileMap::getDimensions() const {
+		return m_dimensions;
+	}
+
+	const glm::vec3& TileMap::getPosition() const {
+		return m_position;
+	}
+
+	const glm::vec2& TileMap::getTileDimensions() const {
+		return m_tileDimensions;
+	}
+
+	const std::vector<std::string>& TileMap::getTileTextureFileNames() const {
+		return m_tileTextureFileNames;
+	}
+
+	GLSLShader& TileMap::getShader() {
+		return *m_shader;
+	}
+
+	unsigned int TileMap::getRevision() const {
+		return m_revision;
+	}
+
+	bool TileMap::destroy() {
+		if (m_shader == 0) {
+			return false;
+		}
+		for (Chunk& chunk : m_chunks) {
+			chunk.batch.destroy();
+		}
+		m_chunks.clear();
+		m_tiles.clear();
+		m_dimensions = glm::ivec2();
+		m_position = glm::vec3();
+		m_tileDimensions = glm::vec2();
+		m_tileTextureFileNames.clear();
+		m_shader = 0;
+		m_chunkCounts = glm::ivec2();
+		// The revision keeps counting so a map initialized again is never
+		// mistaken for its previous contents
+		m_revision++;
+		return true;
+	}
+
+	size_t TileMap::getTileIndex(const glm::ivec2& cell) const {
+		size_t chunk = (size_t)(cell.x / ChunkSize
+			+ (cell.y / ChunkSize) * m_chunkCounts.x);
+		return chunk * ChunkSize * ChunkSize
+			+ (size_t)(cell.x % ChunkSize + (cell.y % ChunkSize) * ChunkSize);
+	}
+
+	// Implement RenderTarget class functions
+
+	bool RenderTarget::initialize(const glm::ivec2& dimensions,
+		const std::string& textureFileName) {
+		if (m_framebufferID != 0) {
+			ACTIASFW_LOG(Graphics, Warning, "Render target ", textureFileName,
+				" has already been initialized");
+			return false;
+		}
+		m_textureFileName = textureFileName;
+		glGenTextures(1, &m_textureID);
+		setDimensions(dimensions);
+		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+		glGenFramebuffers(1, &m_framebufferID);
+		glBindFramebuffer(GL_FRAMEBUFFER, m_framebufferID);
+		glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0,
+			GL_TEXTURE_2D, m_textureID, 0);
+		bool complete = glCheckFramebufferStatus(GL_FRAMEBUFFER)
+			== GL_FRAMEBUFFER_COMPLETE;
+		glBindFramebuffer(GL_FRAMEBUFFER, Application::Window.getFramebuffer());
+		if (!complete) {
+			ACTIASFW_LOG(Graphics, Error, "Render target ", textureFileName,
+				" framebuffer is incomplete");
+			destroy();
+			return false;
+		}
+		Application::Graphics.addTarget(*this);
+		return true;
+	}
+
+	const glm::ivec2& RenderTarget::getDimensions() const {
+		return m_dimensions;
+	}
+
+	void RenderTarget::setDimensions(const glm::ivec2& dimensions) {
+		m_dimensions = glm::max(dimensions, glm::ivec2(1, 1));
+		GLStateCache& state = Application::Graphics.getStateCache();
+		state.bindTexture(0, m_textureID);
+		state.bindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+		glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA8, m_dimensions.x,
+			m_dimensions.y, 0, GL_RGBA, GL_UNSIGNED_BYTE, 0);
+	}
+
+	const std::string& RenderTarget::getTextureFileName() const {
+		return m_textureFileName;
+	}
+
+	bool RenderTarget::isComplete() const {
+		return m_complete;
+	}
+
+	bool RenderTarget::destroy() {
+		if (m_textureID == 0) {
+			return false;
+		}
+		Application::Graphics.releaseTarget(*this);
+		glDeleteFramebuffers(1, &m_framebufferID);
+		glDeleteTextures(1, &m_textureID);
+		// Deleting bound objects unbinds them
+		Application::Graphics.getStateCache().invalidate();
+		m_framebufferID = 0;
+		m_textureID = 0;
+		m_dimensions = glm::ivec2();
+		m_textureFileName = "";
+		m_complete = false;
+		return true;
+	}
+
+	// Implement TargetSprite class functions
+
+	void TargetSprite::initialize(const glm::vec3& position,
+		const glm::vec2& dimensions, const RenderTarget& target) {
+		Sprite::initialize(position, dimensions, target.getTextureFileName());
+		setColor(glm::vec4(1.0f, 1.0f, 1.0f, 1.0f));
+		// The target's first row is its bottom, while textures loaded from
+		// images store their top row first
+		setReflectedVertically(true);
+	}
+
+	float TargetSprite::getDrawMode() const {
+		return 4.0f;
+	}
+
+	// Implement GraphicsManager class functions
+
+	bool GraphicsManager::initialize(const glm::vec3& backgroundColor,
+		size_t streamBufferSize, int atlasPageSize, size_t textureUploadBudget,
+		const std::string& shaderCacheDirectory, size_t textCacheSize) {
+		ACTIASFW_LOG(Graphics, Info, "Initializing graphics manager");
+		if (m_initialized) {
+			ACTIASFW_LOG(Graphics, Error, "Graphics manager already ",
+				"initialized");
+			return false;
+		}
+		ACTIASFW_LOG(Graphics, Info, "Loading OpenGL functions");
+		if (!OpenGL::Load()) {
+			ACTIASFW_LOG(Graphics, Error, "Failed to load OpenGL functions");
+			return false;
+		}
+		const GLubyte* glVersion = glGetString(GL_VERSION);
+		ACTIASFW_LOG(Graphics, Info, glVersion);
+		ACTIASFW_LOG(Graphics, Info, "Initializing FreeType library");
+		if (FT_Init_FreeType(&m_freeType) != FT_Err_Ok) {
+			ACTIASFW_LOG(Graphics, Info, "Failed to initialize FreeType");
+			return false;
+		}
+		FT_Int spread = SDFSpread;
+		m_distanceFields = FT_Property_Set(m_freeType, "sdf", "spread",
+			&spread) == FT_Err_Ok;
+		if (!m_distanceFields) {
+			ACTIASFW_LOG(Graphics, Warning, "FreeType has no signed distance ",
+				"field renderer, fonts will be rasterized as bitmaps");
+		}
+		ACTIASFW_LOG(Graphics, Info, "Initializing OpenGL parameters");
+		glClearColor(backgroundColor.r, backgroundColor.g, backgroundColor.b,
+			1.0f);
+		m_state.invalidate();
+		m_state.setBlending(true, GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+		glPixelStorei(GL_UNPACK_ALIGNMENT, GL_TRUE);
+		glfwSwapInterval(1);
+		glGenVertexArrays(1, &m_VAOID);
+		m_state.bindVertexArray(m_VAOID);
+		ACTIASFW_LOG(Graphics, Info, "Allocating ", streamBufferSize,
+			" byte stream buffer");
+		if (!m_vertexStream.initialize(GL_ARRAY_BUFFER,
+			(GLsizeiptr)streamBufferSize)
+			|| !m_indexStream.initialize(GL_ELEMENT_ARRAY_BUFFER,
+				(GLsizeiptr)streamBufferSize / 4)) {
+			ACTIASFW_LOG(Graphics, Error, "Failed to allocate stream buffer");
+			return false;
+		}
+		if (!m_vertexStream.isPersistent()) {
+			ACTIASFW_LOG(Graphics, Info, "Persistent mapping unavailable, ",
+				"orphaning stream buffer");
+		}
+		if (OpenGL::IsVersionSupported(4, 3)
+			|| OpenGL::IsExtensionSupported("GL_ARB_multi_draw_indirect")) {
+			ACTIASFW_LOG(Graphics, Info, "Drawing static batches with ",
+				"multi-draw indirect");
+			if (!m_indirectStream.initialize(GL_DRAW_INDIRECT_BUFFER,
+				64 * 1024)) {
+				ACTIASFW_LOG(Graphics, Error, "Failed to allocate indirect ",
+					"buffer");
+				return false;
+			}
+		}
+		m_textureUploadBudget = textureUploadBudget;
+		m_textCacheSize = textCacheSize;
+		if (m_textureUploadBudget > 0) {
+			ACTIASFW_LOG(Graphics, Info, "Allocating ",
+				m_textureUploadBudget * 3, " byte pixel buffer");
+			if (!m_pixelStream.initialize(GL_PIXEL_UNPACK_BUFFER,
+				(GLsizeiptr)m_textureUploadBudget * 3)) {
+				ACTIASFW_LOG(Graphics, Error, "Failed to allocate pixel ",
+					"buffer");
+				return false;
+			}
+			m_state.bindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+		}
+		const unsigned char transparent[4] = { 0, 0, 0, 0, };
+		glGenTextures(1, &m_placeholderTexture.ID);
+		m_state.bindTexture(0, m_placeholderTexture.ID);
+		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+		glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA8, 1, 1, 0, GL_RGBA,
+			GL_UNSIGNED_BYTE, transparent);
+		m_atlas.initialize(atlasPageSize, 1);
+		m_workers.initialize(std::max(std::thread::hardware_concurrency(), 1u)
+			- 1);
+		if (OpenGL::EnableParallelShaderCompilation()) {
+			ACTIASFW_LOG(Graphics, Info, "Compiling shaders in parallel");
+		}
+		m_shaderCacheDirectory = shaderCacheDirectory;
+		GLint binaryFormats = 0;
+		if (OpenGL::IsVersionSupported(4, 1)
+			|| OpenGL::IsExtensionSupported("GL_ARB_get_program_binary")) {
+			glGetIntegerv(GL_NUM_PROGRAM_BINARY_FORMATS, &binaryFormats);
+		}
+		m_programBinaries = !m_shaderCacheDirectory.empty()
+			&& binaryFormats > 0;
+		if (m_programBinaries) {
+			std::error_code error;
+			std::filesystem::create_directories(m_shaderCacheDirectory, error);
+			ACTIASFW_LOG(Graphics, Info, "Caching shader program binaries in ",
+				m_shaderCacheDirectory);
+		}
+		// Keep every camera's matrix in one uniform buffer, bound by range to
+		// the shaders drawing with each camera
+		GLint alignment = 1;
+		glGetIntegerv(GL_UNIFORM_BUFFER_OFFSET_ALIGNMENT, &alignment);
+		m_cameraSlotSize = (((GLsizeiptr)sizeof(glm::mat4) + alignment - 1)
+			/ alignment) * alignment;
+		resizeCameraBuffer(16);
+		m_defaultCamera.initialize();
+		// Select each fragment's texture unit from its mode with a chain of
+		// branches, since OpenGL 3.3 cannot index samplers by a varying
+		GLint maxTextureUnits = 1;
+		glGetIntegerv(GL_MAX_TEXTURE_IMAGE_UNITS, &maxTextureUnits);
+		unsigned int textureUnits = (unsigned int)std::clamp(maxTextureUnits,
+			1, (GLint)MaxTextureUnits);
+		ACTIASFW_LOG(Graphics, Info, "Batching sprites across ", textureUnits,
+			" texture units");
+		std::string fragmentShaderSource =
+			"#version 330 core\n"
+			"in vec2 fragmentTexturePosition;\n"
+			"in vec4 fragmentColor;\n"
+			"in float fragmentMode;\n"
+			"uniform sampler2D textureSamplers["
+			+ std::to_string(textureUnits) + "];\n"
+			"vec4 sampleTexture(int unit, vec2 position) {\n";
+		for (unsigned int u = 1; u < textureUnits; u++) {
+			fragmentShaderSource += "	if (unit == " + std::to_string(u)
+				+ ") return texture(textureSamplers[" + std::to_string(u)
+				+ "], position);\n";
+		}
+		fragmentShaderSource +=
+			"	return texture(textureSamplers[0], position);\n"
+			"}\n"
+			"void main() {\n"
+			"	int unit = int(fragmentMode + 0.5) / "
+			+ std::to_string(ModesPerTextureUnit) + ";\n"
+			"	float mode = fragmentMode - float(unit * "
+			+ std::to_string(ModesPerTextureUnit) + ");\n"
+			"	vec4 textureColor\n"
+			"		= sampleTexture(unit, fragmentTexturePosition);\n"
+			"	float edge = fwidth(textureColor.r);\n"
+			"	if (mode >= 4.0) {\n"
+			"		gl_FragColor = fragmentColor * vec4(textureColor.rgb\n"
+			"			/ max(textureColor.a, 0.001), textureColor.a);\n"
+			"	} else if (mode >= 3.0) {\n"
+			"		float alpha = smoothstep(0.5 - edge, 0.5 + edge,\n"
+			"			textureColor.r);\n"
+			"		gl_FragColor = fragmentColor\n"
+			"			* vec4(1.0, 1.0, 1.0, alpha);\n"
+			"	} else if (mode >= 2.0) {\n"
+			"		gl_FragColor = fragmentColor\n"
+			"			* vec4(1.0, 1.0, 1.0, textureColor.r);\n"
+			"	} else {\n"
+			"		gl_FragColor = (1.0 - mode) * textureColor\n"
+			"			+ mode * fragmentColor;\n"
+			"	}\n"
+			"}\n";
+		m_defaultShader.setTextureUnits(textureUnits, "textureSamplers");
+		m_defaultInstancedShader.setTextureUnits(textureUnits,
+			"textureSamplers");
+		m_defaultShader.initialize(
+			"#version 330 core\n"
+			"layout (location = 0) in vec3 vertexPosition;\n"
+			"layout (location = 1) in vec2 vertexTexturePosition;\n"
+			"layout (location = 2) in vec4 vertexColor;\n"
+			"layout (location = 3) in float vertexMode;\n"
+			"layout (std140) uniform Camera {\n"
+			"	mat4 cameraMatrix;\n"
+			"};\n"
+			"out vec2 fragmentTexturePosition;\n"
+			"out vec4 fragmentColor;\n"
+			"out float fragmentMode;\n"
+			"void main() {\n"
+			"	gl_Position = cameraMatrix * vec4(vertexPosition, 1.0);\n"
+			"	fragmentTexturePosition = vertexTexturePosition;\n"
+			"	fragmentColor = vertexColor;\n"
+			"	fragmentMode = vertexMode;\n"
+			"}\n",
+			fragmentShaderSource,
+			{ 3, 2, 4, 1 },
+			m_defaultCamera, "cameraMatrix");
+		m_defaultInstancedShader.setInstanced(true);
+		m_defaultInstancedShader.initialize(
+			"#version 330 core\n"
+			"layout (location = 0) in vec3 instancePosition;\n"
+			"layout (location = 1) in vec2 instanceDimensions;\n"
+			"layout (location = 2) in float instanceRotation;\n"
+			"layout (location = 3) in vec4 instanceTextureBox;\n"
+			"layout (location = 4) in vec4 instanceColor;\n"
+			"layout (location = 5) in float instanceMode;\n"
+			"layout (std140) uniform Camera {\n"
+			"	mat4 cameraMatrix;\n"
+			"};\n"
+			"out vec2 fragmentTexturePosition;\n"
+			"out vec4 fragmentColor;\n"
+			"out float fragmentMode;\n"
+			"void main() {\n"
+			"	vec2 corner = vec2(gl_VertexID & 1, gl_VertexID >> 1);\n"
+			"	vec2 center = instancePosition.xy + instanceDimensions / 2.0;\n"
+			"	vec2 p = instancePosition.xy + corner * instanceDimensions\n"
+			"		- center;\n"
+			"	float a = radians(instanceRotation);\n"
+			"	p = vec2(cos(a) * p.x - sin(a) * p.y,\n"
+			"		sin(a) * p.x + cos(a) * p.y) + center;\n"
+			"	gl_Position = cameraMatrix\n"
+			"		* vec4(p, instancePosition.z, 1.0);\n"
+			"	fragmentTexturePosition = instanceTextureBox.xy\n"
+			"		+ vec2(corner.x, 1.0 - corner.y) * instanceTextureBox.zw;\n"
+			"	fragmentColor = instanceColor;\n"
+			"	fragmentMode = instanceMode;\n"
+			"}\n",
+			fragmentShaderSource,
+			{},
+			m_defaultCamera, "cameraMatrix");
+		if (OpenGL::IsVersionSupported(4, 3)) {
+			ACTIASFW_LOG(Graphics, Info, "Compiling particle compute shaders");
+			m_particleSimulationProgram = linkComputeProgram(
+				ParticleSystem::GetSimulationShaderSource());
+			m_particleEmissionProgram = linkComputeProgram(
+				ParticleSystem::GetEmissionShaderSource());
+			m_particleExpansionProgram = linkComputeProgram(
+				ParticleSystem::GetExpansionShaderSource());
+			if (!isComputeAvailable()) {
+				ACTIASFW_LOG(Graphics, Warning, "Failed to compile particle ",
+					"compute shaders, particles will be simulated on the CPU");
+			}
+		}
+		m_initialized = true;
+		return true;
+	}
+
+	void GraphicsManager::update(float timeStep) {
+		m_defaultCamera.update(timeStep);
+	}
+
+	void GraphicsManager::begin() {
+		glClear(GL_COLOR_BUFFER_BIT);
+		m_statistics = FrameStatistics();
+		m_state.resetCounts();
+		m_frame++;
+		std::lock_guard<std::mutex> lock(m_commandBuffersMutex);
+		// The commands of threads which have exited were drawn last frame
+		std::list<CommandBuffer>::iterator it = m_commandBuffers.begin();
+		while (it != m_commandBuffers.end()) {
+			if (it->released) {
+				it = m_commandBuffers.erase(it);
+			}
+			else {
+				ClearCommandBuffer(*it);
+				it++;
+			}
+		}
+		for (std::pair<const RenderTarget* const, CommandBuffer>& buffer
+			: m_targetCommandBuffers) {
+			ClearCommandBuffer(buffer.second);
+		}
+		m_frameTargets.clear();
+		m_glyphs.clear();
+	}
+
+	void GraphicsManager::submit(const std::string& text,
+		const glm::vec3& position, const glm::vec4& box, float scale,
+		const glm::vec4& color, const std::string& fontFileName,
+		Alignment horizontalAlignment, Alignment verticalAlignment,
+		GLSLShader& shader) {
+		if (text.empty()) {
+			return;
+		}
+		// Copy the strings into the buffer's text data, whose memory is kept
+		// between frames
+		CommandBuffer& buffer = getCommandBuffer();
+		TextCommand command;
+		command.textOffset = buffer.textData.size();
+		command.textLength = text.length();
+		buffer.textData.insert(buffer.textData.end(), text.begin(),
+			text.end());
+		command.fontOffset = buffer.textData.size();
+		command.fontLength = fontFileName.length();
+		buffer.textData.insert(buffer.textData.end(), fontFileName.begin(),
+			fontFileName.end());
+		command.position = position;
+		command.box = box;
+		command.scale = scale;
+		command.color = color;
+		command.horizontalAlignment = horizontalAlignment;
+		command.verticalAlignment = verticalAlignment;
+		command.shader = &shader;
+		buffer.text.push_back(command);
+	}
+
+	void GraphicsManager::submit(const std::string& text,
+		const glm::vec3& position, const glm::vec4& box, float scale,
+		const glm::vec4& color, const std::string& fontFileName,
+		Alignment horizontalAlignment, Alignment verticalAlignment) {
+		submit(text, position, box, scale, color, fontFileName,
+			horizontalAlignment, verticalAlignment, m_defaultShader);
+	}
+
+	void GraphicsManager::submit(StaticBatch& batch) {
+		if (batch.m_VAOID == 0) {
+			return;
+		}
+		getCommandBuffer().batches.push_back(&batch);
+	}
+
+	void GraphicsManager::submit(TileMap& map) {
+		if (map.m_shader == 0) {
+			return;
+		}
+		getCommandBuffer().tileMaps.push_back(&map);
+	}
+
+	void GraphicsManager::submit(ParticleSystem& particles) {
+		if (particles.getCount() == 0) {
+			return;
+		}
+		getCommandBuffer().particleSystems.push_back(&particles);
+	}
+
+	void GraphicsManager::submit(TextMesh& mesh, GLSLShader& shader) {
+		getCommandBuffer().textMeshes.push_back(
+			std::pair<TextMesh*, GLSLShader*>(&mesh, &shader));
+	}
+
+	void GraphicsManager::submit(TextMesh& mesh) {
+		submit(mesh, m_defaultShader);
+	}
+
+	void GraphicsManager::submitVertices(const unsigned char* vertices,
+		size_t vertexBytes, const std::vector<unsigned int>& indices,
+		float depth, const std::string& textureFileName, GLSLShader& shader) {
+		unsigned int stride = shader.getVertexAttributeStride();
+		if (vertexBytes == 0 || indices.empty() || shader.isInstanced()
+			|| stride == 0 || vertexBytes % stride != 0) {
+			return;
+		}
+		CommandBuffer& buffer = getCommandBuffer();
+		Mesh mesh;
+		mesh.shader = &shader;
+		mesh.vertexOffset = buffer.vertexData.size();
+		mesh.vertexBytes = vertexBytes;
+		mesh.indexOffset = buffer.indexData.size();
+		mesh.indexCount = indices.size();
+		mesh.depth = depth;
+		mesh.textureFileName = textureFileName;
+		buffer.vertexData.insert(buffer.vertexData.end(), vertices,
+			vertices + vertexBytes);
+		buffer.indexData.insert(buffer.indexData.end(), indices.begin(),
+			indices.end());
+		buffer.meshes.push_back(mesh);
+	}
+
+	void GraphicsManager::captureFrame() {
+		m_capture->beginFrame();
+		for (CommandBuffer& buffer : m_commandBuffers) {
+			for (const RenderItem& item : buffer.items) {
+				m_capture->recordSprite(*item.sprite, *item.shader);
+			}
+			for (const TextCommand& command : buffer.text) {
+				m_capture->recordText(std::string(buffer.textData.data()
+					+ command.textOffset, command.textLength),
+					command.position, command.box, command.scale,
+					command.color, std::string(buffer.textData.data()
+						+ command.fontOffset, command.fontLength),
+					command.horizontalAlignment, command.verticalAlignment,
+					*command.shader);
+			}
+			for (const std::pair<TextMesh*, GLSLShader*>& text
+				: buffer.textMeshes) {
+				m_capture->recordTextMesh(*text.first, *text.second);
+			}
+			for (StaticBatch* batch : buffer.batches) {
+				m_capture->recordBatch(*batch);
+			}
+			for (TileMap* map : buffer.tileMaps) {
+				m_capture->recordTileMap(*map);
+			}
+			for (ParticleSystem* particles : buffer.particleSystems) {
+				m_capture->recordParticles(*particles);
+			}
+			for (const Mesh& mesh : buffer.meshes) {
+				m_capture->recordMesh(buffer.vertexData.data()
+					+ mesh.vertexOffset, mesh.vertexBytes,
+					buffer.indexData.data() + mesh.indexOffset,
+					mesh.indexCount, mesh.depth, mesh.textureFileName,
+					*mesh.shader);
+			}
+		}
+		m_capture->endFrame();
+	}
+
+	void GraphicsManager::layoutText(TextMesh& mesh) {
+		for (unsigned int a = 0; a < TextLayoutAttempts; a++) {
+			if (layoutTextOnce(mesh)) {
+				return;
+			}
+		}
+	}
+
+	bool GraphicsManager::layoutTextOnce(TextMesh& mesh) {
+		mesh.m_dirty = false;
+		mesh.m_glyphCount = 0;
+		mesh.m_atlas = 0;
+		mesh.m_atlasGeneration = 0;
+		mesh.m_pages = 0;
+		mesh.m_glyphs.clear();
+		mesh.m_vertices.clear();
+		mesh.m_indices.clear();
+		mesh.m_bounds = glm::vec4();
+		mesh.m_textureFileName = "";
+		const std::string& text = mesh.m_text;
+		const glm::vec3& position = mesh.m_position;
+		const glm::vec4& box = mesh.m_box;
+		float scale = mesh.m_scale;
+		if (text.empty()) {
+			return true;
+		}
+		Font* font = getFont(mesh.m_fontFileName);
+		if (font == 0) {
+			return true;
+		}
+		GlyphAtlas& atlas = m_fontFaces.at(mesh.m_fontFileName).atlas;
+		unsigned int generation = atlas.getGeneration();
+		float labelWidth = 0.0f;
+		for (size_t i = 0; i < text.length();) {
+			labelWidth += getGlyph(*font, DecodeUTF8(text, i)).offset;
+		}
+		labelWidth *= scale;
+		float x = 0.0f;
+		if (mesh.m_horizontalAlignment == ALIGN_LEFT) {
+			x = box.x;
+		}
+		else if (mesh.m_horizontalAlignment == ALIGN_RIGHT) {
+			x = (box.x + box.z) - labelWidth;
+		}
+		else if (mesh.m_horizontalAlignment == ALIGN_CENTER) {
+			float m = box.x + (box.z / 2.0f);
+			x = m - (labelWidth / 2.0f);
+		}
+		else {
+			x = position.x;
+		}
+		size_t first = 0;
+		x -= getGlyph(*font, DecodeUTF8(text, first)).bearing.x * scale;
+		float labelHeight
+			= (font->getMinimumBearing() + font->getMaximumBearing()) * scale;
+		float y = 0.0f;
+		if (mesh.m_verticalAlignment == ALIGN_BOTTOM) {
+			y = box.y + (font->getMinimumBearing() * scale);
+		}
+		else if (mesh.m_verticalAlignment == ALIGN_TOP) {
+			y = (box.y + box.w) - labelHeight;
+		}
+		else if (mesh.m_verticalAlignment == ALIGN_CENTER) {
+			float m = box.y + (box.w / 2.0f);
+			y = m - (labelHeight / 2.0f);
+		}
+		else {
+			y = position.y;
+		}
+		// Write each glyph's quad straight from the font's metrics, extending
+		// it over the glyph's padding, and rasterize glyphs drawn for the
+		// first time
+		float padding = font->getPadding() * scale;
+		mesh.m_vertices.reserve(text.length() * QuadKernel::FloatsPerSprite);
+		mesh.m_indices.reserve(text.length() * 6);
+		glm::vec2 min(0.0f, 0.0f);
+		glm::vec2 max(0.0f, 0.0f);
+		for (size_t i = 0; i < text.length();) {
+			char32_t c = DecodeUTF8(text, i);
+			GlyphMetrics& g = getGlyph(*font, c);
+			glm::vec3 p(x + (g.bearing.x * scale),
+				y - ((g.dimensions.y - g.bearing.y) * scale), position.z);
+			glm::vec2 d = g.dimensions * scale;
+			x += (float)g.offset * scale;
+			if (!g.loaded || d.x <= 0.0f || d.y <= 0.0f) {
+				continue;
+			}
+			if (p.x < box.x || p.x + d.x > box.x + box.z) {
+				continue;
+			}
+			if (p.y < box.y || p.y + d.y > box.y + box.w) {
+				continue;
+			}
+			if (g.page < 0 && !rasterizeGlyph(*font, c, g)) {
+				continue;
+			}
+			mesh.m_pages |= (std::uint64_t)1 << g.page;
+			p -= glm::vec3(padding, padding, 0.0f);
+			d += glm::vec2(padding * 2.0f);
+			glm::vec2 ad(atlas.getDimensions());
+			glm::vec4 textureBox(glm::vec2(g.imagePosition) / ad,
+				glm::vec2(g.imageDimensions) / ad);
+			size_t v = mesh.m_vertices.size();
+			mesh.m_vertices.resize(v + QuadKernel::FloatsPerSprite);
+			QuadKernel::ExpandOne(p, d, 0.0f, textureBox, mesh.m_color,
+				font->getDrawMode(), false, false, &mesh.m_vertices[v]);
+			unsigned int base = (unsigned int)(v / Sprite::VertexSize);
+			for (unsigned int index : QuadKernel::Indices) {
+				mesh.m_indices.push_back(index + base);
+			}
+			glm::vec2 corner = glm::vec2(p) + d;
+			if (mesh.m_glyphCount == 0) {
+				min = glm::vec2(p);
+				max = corner;
+			}
+			min = glm::min(min, glm::vec2(p));
+			max = glm::max(max, corner);
+			mesh.m_glyphCount++;
+		}
+		// If the atlas grew or cleared a page while the text was laid out, the
+		// texture coordinates of its first glyphs are stale and the mesh keeps
+		// the generation it was laid out from, so it is laid out again
+		mesh.m_atlas = &atlas;
+		mesh.m_atlasGeneration = generation;
+		if (mesh.m_glyphCount > 0) {
+			mesh.m_textureFileName = font->getTextureFileName();
+		}
+		mesh.m_bounds = glm::vec4(min, max - min);
+		return atlas.getGeneration() == generation;
+	}
+
+	GlyphMetrics& GraphicsManager::getGlyph(Font& font, char32_t codepoint) {
+		GlyphMetrics* glyph = font.findGlyph(codepoint);
+		if (glyph != 0) {
+			return *glyph;
+		}
+		// Glyph boxes are rounded out to whole pixels as FreeType does for
+		// the bitmaps it renders
+		GlyphMetrics metrics;
+		FT_Face face = m_fontFaces.at(font.getTextureFileName()).face;
+		if (FT_Load_Char(face, (FT_ULong)codepoint, FT_LOAD_DEFAULT)
+			== FT_Err_Ok) {
+			FT_Pos metricScale = 1;
+			if (font.getRendering() == Font::RENDERING_SDF) {
+				metricScale = FontPixelSize / SDFPixelSize;
+			}
+			const FT_Glyph_Metrics& m = face->glyph->metrics;
+			if (m.width > 0 && m.height > 0) {
+				FT_Pos left = m.horiBearingX >> 6;
+				FT_Pos right = (m.horiBearingX + m.width + 63) >> 6;
+				FT_Pos top = (m.horiBearingY + 63) >> 6;
+				FT_Pos bottom = (m.horiBearingY - m.height) >> 6;
+				metrics.dimensions = glm::vec2((float)((right - left)
+					* metricScale), (float)((top - bottom) * metricScale));
+				metrics.bearing = glm::ivec2((int)(left * metricScale),
+					(int)(top * metricScale));
+			}
+			metrics.offset = (unsigned int)((face->glyph->advance.x
+				* metricScale) >> 6);
+		}
+		font.addGlyph(codepoint, metrics);
+		return *font.findGlyph(codepoint);
+	}
+
+	bool GraphicsManager::rasterizeGlyph(Font& font, char32_t codepoint,
+		GlyphMetrics& glyph) {
+		FontFace& face = m_fontFaces.at(font.getTextureFileName());
+		if (FT_Load_Char(face.face, (FT_ULong)codepoint, FT_LOAD_DEFAULT)
+			!= FT_Err_Ok) {
+			return false;
+		}
+		FT_Render_Mode mode = FT_RENDER_MODE_NORMAL;
+		if (font.getRendering() == Font::RENDERING_SDF) {
+			mode = FT_RENDER_MODE_SDF;
+		}
+		if (FT_Render_Glyph(face.face->glyph, mode) != FT_Err_Ok) {
+			return false;
+		}
+		const FT_Bitmap& b = face.face->glyph->bitmap;
+		glm::ivec2 dimensions(b.width, b.rows);
+		if (dimensions.x == 0 || dimensions.y == 0) {
+			return false;
+		}
+		glm::ivec2 position;
+		m_evictedGlyphs.clear();
+		int page = face.atlas.reserve(dimensions, codepoint, m_frame, position,
+			m_evictedGlyphs);
+		for (char32_t evicted : m_evictedGlyphs) {
+			GlyphMetrics* g = font.findGlyph(evicted);
+			if (g != 0) {
+				g->page = -1;
+			}
+		}
+		if (page < 0) {
+			ACTIASFW_LOG(Graphics, Warning, "No room for glyph ",
+				(unsigned int)codepoint, " in the atlas of font ",
+				font.getTextureFileName());
+			return false;
+		}
+		face.atlas.upload(b.buffer, b.pitch, position, dimensions);
+		glyph.imagePosition = position;
+		glyph.imageDimensions = dimensions;
+		glyph.page = page;
+		return true;
+	}
+
+	TextMesh& GraphicsManager::getCachedText(const CommandBuffer& buffer,
+		const TextCommand& command) {
+		std::string_view text(&buffer.textData[command.textOffset],
+			command.textLength);
+		std::string_view fontFileName(&buffer.textData[command.fontOffset],
+			command.fontLength);
+		// Hash every property the layout's quads depend on
+		const char separator = 0;
+		const float values[] = { command.position.x, command.position.y,
+			command.position.z, command.box.x, command.box.y, command.box.z,
+			command.box.w, command.scale, command.color.r, command.color.g,
+			command.color.b, command.color.a, };
+		const int alignments[] = { (int)command.horizontalAlignment,
+			(int)command.verticalAlignment, };
+		std::uint64_t hash = HashBytes(14695981039346656037ull, text.data(),
+			text.size());
+		hash = HashBytes(hash, &separator, 1);
+		hash = HashBytes(hash, fontFileName.data(), fontFileName.size());
+		hash = HashBytes(hash, values, sizeof(values));
+		hash = HashBytes(hash, alignments, sizeof(alignments));
+		std::map<std::uint64_t, std::list<CachedText>::iterator>::iterator it
+			= m_textCacheIndex.find(hash);
+		if (it != m_textCacheIndex.end()) {
+			CachedText& cached = *it->second;
+			const TextMesh& mesh = cached.mesh;
+			bool matches = mesh.m_text == text
+				&& mesh.m_fontFileName == fontFileName
+				&& mesh.m_position == command.position
+				&& mesh.m_box == command.box && mesh.m_scale == command.scale
+				&& mesh.m_color == command.color
+				&& mesh.m_horizontalAlignment == command.horizontalAlignment
+				&& mesh.m_verticalAlignment == command.verticalAlignment;
+			if (matches || cached.frame != m_frame) {
+				m_textCache.splice(m_textCache.begin(), m_textCache,
+					it->second);
+				cached.frame = m_frame;
+				if (!matches) {
+					// Another text with the same hash replaces this layout
+					cached.mesh.initialize(std::string(text), command.position,
+						command.box, command.scale, command.color,
+						std::string(fontFileName), command.horizontalAlignment,
+						command.verticalAlignment);
+				}
+				if (cached.mesh.isDirty()) {
+					layoutText(cached.mesh);
+				}
+				return cached.mesh;
+			}
+		}
+		// Layouts drawn this frame are still referenced by render items
+		while (!m_textCache.empty() && m_textCache.size() >= m_textCacheSize
+			&& m_textCache.back().frame != m_frame) {
+			std::list<CachedText>::iterator last = std::prev(m_textCache.end());
+			std::map<std::uint64_t, std::list<CachedText>::iterator>::iterator
+				indexed = m_textCacheIndex.find(last->hash);
+			if (indexed != m_textCacheIndex.end() && indexed->second == last) {
+				m_textCacheIndex.erase(indexed);
+			}
+			last->mesh.destroy();
+			m_textCache.pop_back();
+		}
+		m_textCache.push_front(CachedText());
+		CachedText& cached = m_textCache.front();
+		cached.hash = hash;
+		cached.frame = m_frame;
+		cached.mesh.initialize(std::string(text), command.position,
+			command.box, command.scale, command.color,
+			std::string(fontFileName), command.horizontalAlignment,
+			command.verticalAlignment);
+		layoutText(cached.mesh);
+		// A colliding layout drawn this frame keeps its place in the index
+		if (it == m_textCacheIndex.end()) {
+			m_textCacheIndex[hash] = m_textCache.begin();
+		}
+		return cached.mesh;
+	}
+
+	void GraphicsManager::addText(TextMesh& mesh, GLSLShader* shader) {
+		if (mesh.m_glyphCount == 0) {
+			return;
+		}
+		mesh.m_atlas->touch(mesh.m_pages, m_frame);
+		if (shader->isInstanced()) {
+			if (mesh.m_glyphs.size() != mesh.m_glyphCount) {
+				// Recover each glyph's sprite from the corners of its quad,
+				// whose texture y coordinates run from bottom to top
+				mesh.m_glyphs.resize(mesh.m_glyphCount);
+				for (size_t g = 0; g < mesh.m_glyphCount; g++) {
+					const float* q
+						= &mesh.m_vertices[g * QuadKernel::FloatsPerSprite];
+					Glyph& glyph = mesh.m_glyphs[g];
+					glyph.initialize(glm::vec3(q[0], q[1], q[2]),
+						glm::vec2(q[10] - q[0], q[21] - q[1]),
+						mesh.m_textureFileName);
+					glyph.setTextureBox(glm::vec4(q[3], q[24], q[13] - q[3],
+						q[4] - q[24]));
+					glyph.setColor(glm::vec4(q[5], q[6], q[7], q[8]));
+					glyph.m_drawMode = q[9];
+				}
+			}
+			std::vector<Glyph>& glyphs = m_glyphs[shader];
+			glyphs.insert(glyphs.end(), mesh.m_glyphs.begin(),
+				mesh.m_glyphs.end());
+			return;
+		}
+		RenderItem item;
+		item.shader = shader;
+		item.text = &mesh;
+		item.culled = !isVisible(mesh.m_bounds, shader->getCamera());
+		m_renderItems.push_back(item);
+	}
+
+	void GraphicsManager::beginTarget(RenderTarget& target) {
+		std::lock_guard<std::mutex> lock(m_commandBuffersMutex);
+		if (std::find(m_frameTargets.begin(), m_frameTargets.end(), &target)
+			== m_frameTargets.end()) {
+			m_frameTargets.push_back(&target);
+		}
+		LocalTargetCommandBuffer = &m_targetCommandBuffers[&target];
+	}
+
+	void GraphicsManager::endTarget() {
+		LocalTargetCommandBuffer = 0;
+	}
+
+	void GraphicsManager::end() {
+		double start = glfwGetTime();
+		// Threads submitting for the first time add command buffers, so the
+		// list is held until every buffer has been merged
+		std::lock_guard<std::mutex> lock(m_commandBuffersMutex);
+		if (m_capture != 0 && m_capture->isRecording()) {
+			captureFrame();
+		}
+		// Applications may have bound OpenGL state directly since the last
+		// frame
+		m_state.invalidate();
+		double phaseStart = glfwGetTime();
+		uploadTextures();
+		m_statistics.uploadTime = (glfwGetTime() - phaseStart) * 1000.0;
+		// Draw into the render targets first so that sprites drawn into the
+		// window this frame show their new contents, blending alpha so the
+		// targets hold colors premultiplied by their coverage
+		for (RenderTarget* target : m_frameTargets) {
+			phaseStart = glfwGetTime();
+			m_renderItems.clear();
+			m_glyphs.clear();
+			mergeCommandBuffer(m_targetCommandBuffers.at(target));
+			m_statistics.mergeTime += (glfwGetTime() - phaseStart) * 1000.0;
+			const GLfloat transparent[4] = { 0.0f, 0.0f, 0.0f, 0.0f, };
+			glBindFramebuffer(GL_FRAMEBUFFER, target->m_framebufferID);
+			glViewport(0, 0, target->m_dimensions.x, target->m_dimensions.y);
+			glClearBufferfv(GL_COLOR, 0, transparent);
+			m_state.setBlending(true, GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA,
+				GL_ONE, GL_ONE_MINUS_SRC_ALPHA);
+			drawRenderItems();
+			target->m_complete = true;
+			for (const RenderItem& item : m_renderItems) {
+				if (item.texture == &m_placeholderTexture) {
+					target->m_complete = false;
+					break;
+				}
+			}
+		}
+		if (!m_frameTargets.empty()) {
+			glBindFramebuffer(GL_FRAMEBUFFER,
+				Application::Window.getFramebuffer());
+			glViewport(0, 0, Application::Window.getDimensions().x,
+				Application::Window.getDimensions().y);
+		}
+		phaseStart = glfwGetTime();
+		// Merge every thread's commands, laying out text and baking static
+		// batches on this thread since they need FreeType and OpenGL
+		m_renderItems.clear();
+		m_glyphs.clear();
+		for (CommandBuffer& buffer : m_commandBuffers) {
+			mergeCommandBuffer(buffer);
+		}
+		m_statistics.mergeTime += (glfwGetTime() - phaseStart) * 1000.0;
+		m_state.setBlending(true, GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+		drawRenderItems();
+		m_statistics.drawTime = (glfwGetTime() - start) * 1000.0;
+		m_statistics.stateChanges = m_state.getIssuedCalls();
+		m_statistics.skippedStateChanges = m_state.getSkippedCalls();
+	}
+
+	void GraphicsManager::mergeCommandBuffer(CommandBuffer& buffer) {
+		for (const TextCommand& command : buffer.text) {
+			addText(getCachedText(buffer, command), command.shader);
+		}
+		for (const std::pair<TextMesh*, GLSLShader*>& text
+			: buffer.textMeshes) {
+			if (text.first->isDirty()) {
+				layoutText(*text.first);
+			}
+			addText(*text.first, text.second);
+		}
+		m_renderItems.insert(m_renderItems.end(), buffer.items.begin(),
+			buffer.items.end());
+		for (StaticBatch* batch : buffer.batches) {
+			if (batch->m_dirty) {
+				bake(*batch);
+			}
+			addStaticGroups(*batch);
+		}
+		for (TileMap* map : buffer.tileMaps) {
+			for (TileMap::Chunk& chunk : map->m_chunks) {
+				// Chunks outside the camera are neither baked nor drawn
+				if (!isVisible(chunk.bounds, map->m_shader->getCamera())) {
+					continue;
+				}
+				if (chunk.batch.m_dirty) {
+					bake(*map, chunk);
+				}
+				addStaticGroups(chunk.batch);
+			}
+		}
+		for (ParticleSystem* particles : buffer.particleSystems) {
+			RenderItem item;
+			item.shader = &particles->getShader();
+			item.particles = particles;
+			m_renderItems.push_back(item);
+		}
+		for (size_t m = 0; m < buffer.meshes.size(); m++) {
+			RenderItem item;
+			item.shader = buffer.meshes.at(m).shader;
+			item.commands = &buffer;
+			item.mesh = m;
+			m_renderItems.push_back(item);
+		}
+	}
+
+	void GraphicsManager::drawRenderItems() {
+		double phaseStart = glfwGetTime();
+		// Text laid out before its font's atlas grew this frame has stale
+		// texture coordinates, and laying it out again may grow the atlas
+		bool stale = true;
+		while (stale) {
+			stale = false;
+			for (RenderItem& item : m_renderItems) {
+				if (item.text != 0 && item.text->isDirty()) {
+					layoutText(*item.text);
+					stale = true;
+				}
+			}
+		}
+		for (std::pair<GLSLShader* const, std::vector<Glyph>>& pair
+			: m_glyphs) {
+			for (Glyph& glyph : pair.second) {
+				RenderItem item;
+				item.shader = pair.first;
+				item.sprite = &glyph;
+				m_renderItems.push_back(item);
+			}
+		}
+		m_statistics.mergeTime += (glfwGetTime() - phaseStart) * 1000.0;
+		phaseStart = glfwGetTime();
+		PrepareTask prepare;
+		prepare.manager = this;
+		m_workers.run(prepare, m_renderItems.size(), 1024);
+		m_frameShaders.clear();
+		size_t count = 0;
+		for (size_t i = 0; i < m_renderItems.size(); i++) {
+			RenderItem item = m_renderItems.at(i);
+			if (item.batch != 0) {
+				const StaticBatch::Group& group
+					= item.batch->m_groups.at(item.group);
+				if (item.culled) {
+					m_statistics.culledSprites += group.spriteCount;
+					continue;
+				}
+				item.texture = &getTexture(group.textureFileName);
+				item.key = getSortKey(item.shader, group.depth, *item.texture);
+			}
+			else if (item.text != 0) {
+				if (item.culled) {
+					m_statistics.culledSprites
+						+= (unsigned int)item.text->m_glyphCount;
+					continue;
+				}
+				item.texture = &getTexture(item.text->m_textureFileName);
+				item.key = getSortKey(item.shader, item.text->m_position.z,
+					*item.texture);
+			}
+			else if (item.commands != 0) {
+				const Mesh& mesh = item.commands->meshes.at(item.mesh);
+				item.texture = &getTexture(mesh.textureFileName);
+				item.key = getSortKey(item.shader, mesh.depth, *item.texture);
+			}
+			else if (item.particles != 0) {
+				const ParticleSystem& particles = *item.particles;
+				item.texture = &getTexture(particles.getTextureFileName());
+				item.key = getSortKey(item.shader, particles.getDepth(),
+					*item.texture);
+			}
+			else {
+				if (item.culled) {
+					m_statistics.culledSprites++;
+					continue;
+				}
+				if (!item.shader->isInstanced()
+					&& item.sprite->getVertices().empty()) {
+					continue;
+				}
+				item.texture = &getTexture(item.sprite->getTextureFileName());
+				item.key = getSortKey(item.shader,
+					item.sprite->getPosition().z, *item.texture);
+			}
+			m_renderItems[count++] = item;
+		}
+		m_renderItems.resize(count);
+		m_statistics.prepareTime += (glfwGetTime() - phaseStart) * 1000.0;
+		if (m_renderItems.empty()) {
+			return;
+		}
+		double sortStart = glfwGetTime();
+		sortRenderItems();
+		m_statistics.sortTime += (glfwGetTime() - sortStart) * 1000.0;
+		phaseStart = glfwGetTime();
+		m_state.bindVertexArray(m_VAOID);
+		GLSLShader* currentShader = 0;
+		size_t first = 0;
+		while (first < m_renderItems.size()) {
+			const RenderItem& head = m_renderItems.at(first);
+			GLSLShader* shader = head.shader;
+			size_t last = first + 1;
+			m_runTextures.clear();
+			if (head.batch != 0) {
+				// Consecutive groups of one batch sharing a texture set are
+				// drawn in one call
+				const StaticBatch& batch = *head.batch;
+				unsigned int set = batch.m_groups.at(head.group).textureSet;
+				while (last < m_renderItems.size()
+					&& m_renderItems.at(last).batch == head.batch
+					&& batch.m_groups.at(m_renderItems.at(last).group)
+					.textureSet == set) {
+					last++;
+				}
+				size_t unitCount = shader->getTextureUnitCount();
+				m_runTextures.assign(batch.m_textureIDs.begin() + set
+					* unitCount, batch.m_textureIDs.begin() + std::min(
+						(set + 1) * unitCount, batch.m_textureIDs.size()));
+			}
+			else {
+				// Sprites are drawn together until their shader changes or
+				// they use more textures than it has units, untextured sprites
+				// can be drawn with any textures bound and meshes, whose
+				// vertices have no texture unit, only with their texture on
+				// the first unit
+				last = first;
+				while (last < m_renderItems.size()
+					&& m_renderItems.at(last).shader == shader
+					&& m_renderItems.at(last).batch == 0) {
+					RenderItem& item = m_renderItems[last];
+					GLuint t = item.texture->ID;
+					item.unit = 0;
+					if (t != 0 && item.commands != 0 && !m_runTextures.empty()
+						&& m_runTextures.front() != t) {
+						break;
+					}
+					if (t != 0) {
+						std::vector<GLuint>::iterator it = std::find(
+							m_runTextures.begin(), m_runTextures.end(), t);
+						if (it == m_runTextures.end()) {
+							if (m_runTextures.size()
+								== shader->getTextureUnitCount()) {
+								break;
+							}
+							it = m_runTextures.insert(it, t);
+						}
+						item.unit = (unsigned int)(it - m_runTextures.begin());
+					}
+					last++;
+				}
 			}
-			if (currentTexture != getTexture(
-				pair.second->getTextureFileName())) {
-				if (count > 0) {
-					draw(indices, vertices);
-					indices.clear();
-					vertices.clear();
-					count = 0;
+			if (currentShader != shader) {
+				if (currentShader != 0) {
+					currentShader->end();
 				}
-				currentTexture = getTexture(pair.second->getTextureFileName());
-				glBindTexture(GL_TEXTURE_2D, currentTexture);
+				currentShader = shader;
+				currentShader->begin();
+			}
+			bindTextures(m_runTextures);
+			if (m_renderItems.at(first).batch != 0) {
+				drawStaticGroups(first, last);
+			}
+			else if (currentShader->isInstanced()) {
+				drawInstances(first, last, *currentShader);
+			}
+			else {
+				draw(first, last, currentShader->getVertexAttributeStride());
+			}
+			first = last;
+		}
+		currentShader->end();
+		m_statistics.submitTime += (glfwGetTime() - phaseStart) * 1000.0;
+	}
+
+	bool GraphicsManager::destroy() {
+		ACTIASFW_LOG(Graphics, Info, "Destroying graphics manager");
+		if (!m_initialized) {
+			ACTIASFW_LOG(Graphics, Info, "Graphics manager has already been ",
+				"destroyed");
+			return false;
+		}
+		ACTIASFW_LOG(Graphics, Info, "Freeing OpenGL buffers");
+		m_indexStream.destroy();
+		m_vertexStream.destroy();
+		if (m_pixelStream.getBufferID() != 0) {
+			m_pixelStream.destroy();
+		}
+		if (m_indirectStream.getBufferID() != 0) {
+			m_indirectStream.destroy();
+		}
+		m_state.bindVertexArray(0);
+		glDeleteVertexArrays(1, &m_VAOID);
+		m_VAOID = 0;
+		for (const std::pair<const VertexLayout, GLuint>& vertexArray
+			: m_vertexArrays) {
+			glDeleteVertexArrays(1, &vertexArray.second);
+		}
+		m_vertexArrays.clear();
+		ACTIASFW_LOG(Graphics, Info, "Freeing ", m_fontFaces.size(),
+			" font faces and glyph atlases");
+		for (std::pair<const std::string, FontFace>& fontFace : m_fontFaces) {
+			m_textures.erase(fontFace.first);
+			fontFace.second.atlas.destroy();
+			FT_Done_Face(fontFace.second.face);
+		}
+		m_fontFaces.clear();
+		m_evictedGlyphs.clear();
+		// Render targets delete their own textures
+		for (const std::pair<const RenderTarget* const, CommandBuffer>& buffer
+			: m_targetCommandBuffers) {
+			m_textures.erase(buffer.first->getTextureFileName());
+		}
+		ACTIASFW_LOG(Graphics, Info, "Freeing ", m_textures.size(),
+			" textures");
+		for (const std::pair<const std::string, Texture>& texture
+			: m_textures) {
+			if (!texture.second.atlased) {
+				glDeleteTextures(1, &texture.second.ID);
+			}
+		}
+		m_textures.clear();
+		glDeleteTextures(1, &m_placeholderTexture.ID);
+		m_placeholderTexture = Texture();
+		m_textureFrames.clear();
+		m_repeatedTextures.clear();
+		m_renderItems.clear();
+		m_sortBuffer.clear();
+		m_frameShaders.clear();
+		m_workers.destroy();
+		// The workers have stopped so no load is still being decoded
+		ACTIASFW_LOG(Graphics, Info, "Abandoning ", m_textureLoads.size(),
+			" texture loads");
+		m_textureLoads.clear();
+		std::unique_lock<std::mutex> lock(m_commandBuffersMutex);
+		m_commandBuffers.clear();
+		m_commandBuffersGeneration++;
+		lock.unlock();
+		m_targetCommandBuffers.clear();
+		m_frameTargets.clear();
+		LocalTargetCommandBuffer = 0;
+		ACTIASFW_LOG(Graphics, Info, "Freeing ", m_atlas.getPageCount(),
+			" texture atlas pages");
+		m_atlas.destroy();
+		ACTIASFW_LOG(Graphics, Info, "Destroying FreeType library");
+		FT_Done_FreeType(m_freeType);
+		m_freeType = 0;
+		m_distanceFields = false;
+		ACTIASFW_LOG(Graphics, Info, "Freeing ", m_fonts.size(), " fonts");
+		for (std::map<std::string, Font>::iterator it = m_fonts.begin();
+			it != m_fonts.end(); it++) {
+			it->second.destroy();
+		}
+		m_fonts.clear();
+		m_fontRenderings.clear();
+		m_glyphs.clear();
+		ACTIASFW_LOG(Graphics, Info, "Freeing ", m_textCache.size(),
+			" cached text layouts");
+		for (CachedText& cached : m_textCache) {
+			cached.mesh.destroy();
+		}
+		m_textCache.clear();
+		m_textCacheIndex.clear();
+		m_defaultCamera.destroy();
+		m_state.bindBuffer(GL_UNIFORM_BUFFER, 0);
+		glDeleteBuffers(1, &m_cameraBufferID);
+		m_cameraBufferID = 0;
+		m_cameraSlotSize = 0;
+		m_cameraSlotCount = 0;
+		m_cameraSlots.clear();
+		m_freeCameraSlots.clear();
+		m_boundCamera = 0;
+		m_defaultShader.destroy();
+		m_defaultInstancedShader.destroy();
+		ACTIASFW_LOG(Graphics, Info, "Freeing ", m_programs.size(),
+			" shader programs");
+		for (const std::pair<const std::uint64_t, Program>& program
+			: m_programs) {
+			glDeleteProgram(program.second.ID);
+		}
+		m_programs.clear();
+		glDeleteProgram(m_particleSimulationProgram);
+		glDeleteProgram(m_particleEmissionProgram);
+		glDeleteProgram(m_particleExpansionProgram);
+		m_particleSimulationProgram = 0;
+		m_particleEmissionProgram = 0;
+		m_particleExpansionProgram = 0;
+		m_shaderCacheDirectory = "";
+		m_programBinaries = false;
+		m_statistics = FrameStatistics();
+		m_capture = 0;
+		m_state.invalidate();
+		m_initialized = false;
+		return true;
+	}
+
+	Camera& GraphicsManager::getDefaultCamera() {
+		return m_defaultCamera;
+	}
+
+	GLSLShader& GraphicsManager::getDefaultShader() {
+		return m_defaultShader;
+	}
+
+	GLSLShader& GraphicsManager::getDefaultInstancedShader() {
+		return m_defaultInstancedShader;
+	}
+
+	const GraphicsManager::FrameStatistics&
+		GraphicsManager::getFrameStatistics() const {
+		return m_statistics;
+	}
+
+	GLStateCache& GraphicsManager::getStateCache() {
+		return m_state;
+	}
+
+	bool GraphicsManager::isComputeAvailable() const {
+		return m_particleSimulationProgram != 0
+			&& m_particleEmissionProgram != 0
+			&& m_particleExpansionProgram != 0;
+	}
+
+	void GraphicsManager::setFontRendering(const std::string& fileName,
+		Font::Rendering rendering) {
+		std::map<std::string, Font>::iterator it = m_fonts.find(fileName);
+		if (it != m_fonts.end() && it->second.getRendering() != rendering) {
+			ACTIASFW_LOG(Graphics, Warning, "Font ", fileName, " has already ",
+				"been rasterized, its rendering will not change");
+			return;
+		}
+		m_fontRenderings[fileName] = rendering;
+	}
+
+	Font::Rendering GraphicsManager::getFontRendering(
+		const std::string& fileName) const {
+		std::map<std::string, Font>::const_iterator it = m_fonts.find(fileName);
+		if (it != m_fonts.end()) {
+			return it->second.getRendering();
+		}
+		std::map<std::string, Font::Rendering>::const_iterator rendering
+			= m_fontRenderings.find(fileName);
+		return rendering != m_fontRenderings.end() ? rendering->second
+			: Font::RENDERING_BITMAP;
+	}
+
+	void GraphicsManager::setCapture(FrameTrace* trace) {
+		m_capture = trace;
+	}
+
+	std::vector<glm::vec4> GraphicsManager::getTextureFrames(
+		const std::string& textureFileName, const std::string& prefix) {
+		std::vector<glm::vec4> frames;
+		requireTexture(textureFileName);
+		if (m_textureFrames.find(textureFileName) == m_textureFrames.end()) {
+			return frames;
+		}
+		for (const std::pair<std::string, glm::vec4>& frame
+			: m_textureFrames.at(textureFileName)) {
+			if (frame.first.compare(0, prefix.length(), prefix) == 0) {
+				frames.push_back(frame.second);
+			}
+		}
+		return frames;
+	}
+
+	GLuint GraphicsManager::linkProgram(const std::string& vertexShaderSource,
+		const std::string& fragmentShaderSource) {
+		// Compile both shaders before waiting on either so drivers with
+		// parallel shader compilation can compile them at the same time
+		const char* vSource = vertexShaderSource.c_str();
+		GLuint vID = glCreateShader(GL_VERTEX_SHADER);
+		ACTIASFW_LOG(GLSLShader, Info, "Compiling vertex shader ", vID);
+		glShaderSource(vID, 1, &vSource, 0);
+		glCompileShader(vID);
+		const char* fSource = fragmentShaderSource.c_str();
+		GLuint fID = glCreateShader(GL_FRAGMENT_SHADER);
+		ACTIASFW_LOG(GLSLShader, Info, "Compiling fragment shader ", fID);
+		glShaderSource(fID, 1, &fSource, 0);
+		glCompileShader(fID);
+		int vSuccess;
+		glGetShaderiv(vID, GL_COMPILE_STATUS, &vSuccess);
+		if (!vSuccess) {
+			char vBuffer[1024];
+			glGetShaderInfoLog(vID, 1024, 0, vBuffer);
+			ACTIASFW_LOG(GLSLShader, Warning, "Failed to compile vertex ",
+				"shader ", vID, "\n", vBuffer);
+			glDeleteShader(vID);
+			glDeleteShader(fID);
+			return 0;
+		}
+		int fSuccess;
+		glGetShaderiv(fID, GL_COMPILE_STATUS, &fSuccess);
+		if (!fSuccess) {
+			char fBuffer[1024];
+			glGetShaderInfoLog(fID, 1024, 0, fBuffer);
+			ACTIASFW_LOG(GLSLShader, Warning, "Failed to compile fragment ",
+				"shader ", fID, "\n", fBuffer);
+			glDeleteShader(vID);
+			glDeleteShader(fID);
+			return 0;
+		}
+		GLuint programID = glCreateProgram();
+		glAttachShader(programID, vID);
+		glAttachShader(programID, fID);
+		if (m_programBinaries) {
+			glProgramParameteri(programID, GL_PROGRAM_BINARY_RETRIEVABLE_HINT,
+				GL_TRUE);
+		}
+		ACTIASFW_LOG(GLSLShader, Info, "Linking shader program ", programID);
+		glLinkProgram(programID);
+		glDeleteShader(vID);
+		glDeleteShader(fID);
+		int pSuccess;
+		glGetProgramiv(programID, GL_LINK_STATUS, &pSuccess);
+		if (!pSuccess) {
+			char pBuffer[1024];
+			glGetProgramInfoLog(programID, 1024, 0, pBuffer);
+			ACTIASFW_LOG(GLSLShader, Warning, "Failed to link shader program ",
+				programID, "\n", pBuffer);
+			glDeleteProgram(programID);
+			return 0;
+		}
+		return programID;
+	}
+
+	GLuint GraphicsManager::linkComputeProgram(
+		const std::string& computeShaderSource) {
+		const char* source = computeShaderSource.c_str();
+		GLuint ID = glCreateShader(GL_COMPUTE_SHADER);
+		ACTIASFW_LOG(GLSLShader, Info, "Compiling compute shader ", ID);
+		glShaderSource(ID, 1, &source, 0);
+		glCompileShader(ID);
+		int success;
+		glGetShaderiv(ID, GL_COMPILE_STATUS, &success);
+		if (!success) {
+			char buffer[1024];
+			glGetShaderInfoLog(ID, 1024, 0, buffer);
+			ACTIASFW_LOG(GLSLShader, Warning, "Failed to compile compute ",
+				"shader ", ID, "\n", buffer);
+			glDeleteShader(ID);
+			return 0;
+		}
+		GLuint programID = glCreateProgram();
+		glAttachShader(programID, ID);
+		ACTIASFW_LOG(GLSLShader, Info, "Linking shader program ", programID);
+		glLinkProgram(programID);
+		glDeleteShader(ID);
+		glGetProgramiv(programID, GL_LINK_STATUS, &success);
+		if (!success) {
+			char buffer[1024];
+			glGetProgramInfoLog(programID, 1024, 0, buffer);
+			ACTIASFW_LOG(GLSLShader, Warning, "Failed to link shader program ",
+				programID, "\n", buffer);
+			glDeleteProgram(programID);
+			return 0;
+		}
+		return programID;
+	}
+
+	GLuint GraphicsManager::acquireProgram(
+		const std::string& vertexShaderSource,
+		const std::string& fragmentShaderSource) {
+		std::uint64_t hash = HashSources(vertexShaderSource,
+			fragmentShaderSource);
+		std::map<std::uint64_t, Program>::iterator it = m_programs.find(hash);
+		if (it != m_programs.end()) {
+			if (it->second.vertexShaderSource == vertexShaderSource
+				&& it->second.fragmentShaderSource == fragmentShaderSource) {
+				it->second.references++;
+				return it->second.ID;
+			}
+			// Programs whose sources collide are not shared
+			ACTIASFW_LOG(Graphics, Warning, "Shader source hash collision, ",
+				"compiling an unshared program");
+			return linkProgram(vertexShaderSource, fragmentShaderSource);
+		}
+		GLuint programID = loadProgramBinary(hash);
+		if (programID == 0) {
+			programID = linkProgram(vertexShaderSource, fragmentShaderSource);
+			if (programID == 0) {
+				return 0;
+			}
+			saveProgramBinary(hash, programID);
+		}
+		Program& program = m_programs[hash];
+		program.ID = programID;
+		program.vertexShaderSource = vertexShaderSource;
+		program.fragmentShaderSource = fragmentShaderSource;
+		program.references = 1;
+		return programID;
+	}
+
+	void GraphicsManager::releaseProgram(GLuint programID) {
+		if (programID == 0) {
+			return;
+		}
+		for (std::map<std::uint64_t, Program>::iterator it
+			= m_programs.begin(); it != m_programs.end(); it++) {
+			if (it->second.ID != programID) {
+				continue;
 			}
-			for (unsigned int index : pair.second->getIndices()) {
-				indices.push_back(index + 4 * count);
+			if (--it->second.references == 0) {
+				glDeleteProgram(programID);
+				m_programs.erase(it);
+			}
+			return;
+		}
+		glDeleteProgram(programID);
+	}
+
+	GLuint GraphicsManager::loadProgramBinary(std::uint64_t hash) {
+		if (!m_programBinaries) {
+			return 0;
+		}
+		std::ifstream file(getProgramBinaryFileName(hash),
+			std::ios::in | std::ios::binary);
+		GLenum format = 0;
+		if (!file.read((char*)&format, sizeof(format))) {
+			return 0;
+		}
+		std::vector<char> binary((std::istreambuf_iterator<char>(file)),
+			std::istreambuf_iterator<char>());
+		GLuint programID = glCreateProgram();
+		glProgramBinary(programID, format, binary.data(),
+			(GLsizei)binary.size());
+		int success;
+		glGetProgramiv(programID, GL_LINK_STATUS, &success);
+		if (!success) {
+			// The driver has changed since the binary was saved
+			ACTIASFW_LOG(Graphics, Info, "Discarding stale shader program ",
+				"binary ", getProgramBinaryFileName(hash));
+			glDeleteProgram(programID);
+			return 0;
+		}
+		ACTIASFW_LOG(Graphics, Info, "Loaded shader program binary ",
+			getProgramBinaryFileName(hash));
+		return programID;
+	}
+
+	void GraphicsManager::saveProgramBinary(std::uint64_t hash,
+		GLuint programID) {
+		if (!m_programBinaries) {
+			return;
+		}
+		GLint length = 0;
+		glGetProgramiv(programID, GL_PROGRAM_BINARY_LENGTH, &length);
+		if (length <= 0) {
+			return;
+		}
+		std::vector<char> binary((size_t)length);
+		GLenum format = 0;
+		glGetProgramBinary(programID, length, 0, &format, binary.data());
+		std::ofstream file(getProgramBinaryFileName(hash),
+			std::ios::out | std::ios::binary | std::ios::trunc);
+		if (!file.good()) {
+			ACTIASFW_LOG(Graphics, Warning, "Failed to write shader program ",
+				"binary ", getProgramBinaryFileName(hash));
+			return;
+		}
+		file.write((const char*)&format, sizeof(format));
+		file.write(binary.data(), binary.size());
+	}
+
+	std::string GraphicsManager::getProgramBinaryFileName(
+		std::uint64_t hash) const {
+		std::stringstream fileName;
+		fileName << m_shaderCacheDirectory << "/" << std::hex
+			<< std::setfill('0') << std::setw(16) << hash << ".bin";
+		return fileName.str();
+	}
+
+	std::uint64_t GraphicsManager::HashSources(
+		const std::string& vertexShaderSource,
+		const std::string& fragmentShaderSource) {
+		// Hash both sources separated by a null character
+		const char separator = 0;
+		std::uint64_t hash = HashBytes(14695981039346656037ull,
+			vertexShaderSource.data(), vertexShaderSource.size());
+		hash = HashBytes(hash, &separator, 1);
+		return HashBytes(hash, fragmentShaderSource.data(),
+			fragmentShaderSource.size());
+	}
+
+	std::uint64_t GraphicsManager::HashBytes(std::uint64_t hash,
+		const void* data, size_t size) {
+		const unsigned char* bytes = (const unsigned char*)data;
+		for (size_t b = 0; b < size; b++) {
+			hash = (hash ^ bytes[b]) * 1099511628211ull;
+		}
+		return hash;
+	}
+
+	void GraphicsManager::updateCamera(const Camera& camera) {
+		if (m_cameraBufferID == 0) {
+			return;
+		}
+		std::map<const Camera*, size_t>::iterator it
+			= m_cameraSlots.find(&camera);
+		if (it == m_cameraSlots.end()) {
+			size_t slot = m_cameraSlots.size();
+			if (!m_freeCameraSlots.empty()) {
+				slot = m_freeCameraSlots.back();
+				m_freeCameraSlots.pop_back();
 			}
-			for (float vertex : pair.second->getVertices()) {
-				vertices.push_back(vertex);
+			else if (slot >= m_cameraSlotCount) {
+				resizeCameraBuffer(m_cameraSlotCount * 2);
 			}
-			count++;
-		}
-		if (count > 0) {
-			draw(indices, vertices);
+			it = m_cameraSlots.insert(std::pair<const Camera*, size_t>(
+				&camera, slot)).first;
 		}
+		m_state.bindBuffer(GL_UNIFORM_BUFFER, m_cameraBufferID);
+		glBufferSubData(GL_UNIFORM_BUFFER, it->second * m_cameraSlotSize,
+			sizeof(glm::mat4), &(camera.getMatrix()[0][0]));
 	}
 
-	bool GraphicsManager::destroy() {
-		ACTIASFW_LOG(Graphics, Info, "Destroying graphics manager");
-		if (!m_initialized) {
-			ACTIASFW_LOG(Graphics, Info, "Graphics manager has already been ",
-				"destroyed");
-			return false;
+	void GraphicsManager::bindCamera(const Camera& camera) {
+		if (m_boundCamera == &camera) {
+			return;
 		}
-		ACTIASFW_LOG(Graphics, Info, "Freeing OpenGL buffers");
-		glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
-		glDeleteBuffers(1, &m_IBOID);
-		m_IBOID = 0;
-		glBindBuffer(GL_ARRAY_BUFFER, 0);
-		glDeleteBuffers(1, &m_VBOID);
-		m_VBOID = 0;
-		glBindVertexArray(0);
-		glDeleteVertexArrays(1, &m_VAOID);
-		m_VAOID = 0;
-		ACTIASFW_LOG(Graphics, Info, "Freeing ", m_textures.size(),
-			" textures");
-		for (const std::pair<const std::string, GLuint>& texture : m_textures) {
-			glDeleteTextures(1, &texture.second);
+		if (m_cameraSlots.find(&camera) == m_cameraSlots.end()) {
+			updateCamera(camera);
 		}
-		m_textures.clear();
-		m_sprites.clear();
-		ACTIASFW_LOG(Graphics, Info, "Destroying FreeType library");
-		FT_Done_FreeType(m_freeType);
-		m_freeType = 0;
-		ACTIASFW_LOG(Graphics, Info, "Freeing ", m_fonts.size(), " fonts");
-		for (std::map<std::string, Font>::iterator it = m_fonts.begin();
-			it != m_fonts.end(); it++) {
-			it->second.destroy();
+		m_state.bindBufferRange(GL_UNIFORM_BUFFER, CameraBinding,
+			m_cameraBufferID, m_cameraSlots.at(&camera) * m_cameraSlotSize,
+			sizeof(glm::mat4));
+		m_boundCamera = &camera;
+	}
+
+	void GraphicsManager::releaseCamera(const Camera& camera) {
+		std::map<const Camera*, size_t>::iterator it
+			= m_cameraSlots.find(&camera);
+		if (it == m_cameraSlots.end()) {
+			return;
+		}
+		m_freeCameraSlots.push_back(it->second);
+		m_cameraSlots.erase(it);
+		if (m_boundCamera == &camera) {
+			m_boundCamera = 0;
 		}
-		m_fonts.clear();
-		m_glyphs.clear();
-		m_defaultCamera.destroy();
-		m_defaultShader.destroy();
-		m_initialized = false;
-		return true;
 	}
 
-	Camera& GraphicsManager::getDefaultCamera() {
-		return m_defaultCamera;
+	void GraphicsManager::addTarget(const RenderTarget& target) {
+		Texture texture;
+		texture.ID = target.m_textureID;
+		m_textures[target.getTextureFileName()] = texture;
+		m_targetCommandBuffers[&target];
 	}
 
-	GLSLShader& GraphicsManager::getDefaultShader() {
-		return m_defaultShader;
+	void GraphicsManager::releaseTarget(const RenderTarget& target) {
+		m_textures.erase(target.getTextureFileName());
+		std::map<const RenderTarget*, CommandBuffer>::iterator it
+			= m_targetCommandBuffers.find(&target);
+		if (it != m_targetCommandBuffers.end()) {
+			if (LocalTargetCommandBuffer == &it->second) {
+				LocalTargetCommandBuffer = 0;
+			}
+			m_targetCommandBuffers.erase(it);
+		}
+		m_frameTargets.erase(std::remove(m_frameTargets.begin(),
+			m_frameTargets.end(), &target), m_frameTargets.end());
 	}
 
-	const GLuint GraphicsManager::getTexture(const std::string& fileName) {
-		if (fileName.empty()) {
-			return 0;
+	void GraphicsManager::resizeCameraBuffer(size_t slotCount) {
+		// Copy the matrices on the GPU, since cameras freed without being
+		// destroyed may still hold slots
+		GLuint bufferID = 0;
+		glGenBuffers(1, &bufferID);
+		m_state.bindBuffer(GL_COPY_WRITE_BUFFER, bufferID);
+		glBufferData(GL_COPY_WRITE_BUFFER, slotCount * m_cameraSlotSize, 0,
+			GL_DYNAMIC_DRAW);
+		if (m_cameraBufferID != 0) {
+			m_state.bindBuffer(GL_COPY_READ_BUFFER, m_cameraBufferID);
+			glCopyBufferSubData(GL_COPY_READ_BUFFER, GL_COPY_WRITE_BUFFER, 0, 0,
+				m_cameraSlotCount * m_cameraSlotSize);
+			glDeleteBuffers(1, &m_cameraBufferID);
+			// Deleting the old buffer unbinds it
+			m_state.invalidate();
 		}
-		if (m_textures.find(fileName) != m_textures.end()) {
-			return m_textures[fileName];
+		m_cameraBufferID = bufferID;
+		m_cameraSlotCount = slotCount;
+		// The camera binding point still refers to the old buffer
+		m_boundCamera = 0;
+	}
+
+	void GraphicsManager::prefetchTextures(
+		const std::vector<std::string>& fileNames) {
+		for (const std::string& fileName : fileNames) {
+			loadTexture(fileName);
+		}
+	}
+
+	bool GraphicsManager::isTextureReady(const std::string& fileName) const {
+		return m_textures.find(fileName) != m_textures.end();
+	}
+
+	void GraphicsManager::setTextureRepeated(const std::string& fileName) {
+		m_repeatedTextures.insert(fileName);
+		std::map<std::string, Texture>::const_iterator it
+			= m_textures.find(fileName);
+		if (it != m_textures.end() && it->second.atlased) {
+			ACTIASFW_LOG(Graphics, Warning, "Texture ", fileName,
+				" was packed into the texture atlas before it was set to ",
+				"repeat");
 		}
+	}
+
+	void GraphicsManager::TextureLoad::execute() {
 		std::ifstream file(fileName, std::ios::in | std::ios::binary
 			| std::ios::ate);
 		if (!file.good()) {
-			return 0;
+			finish(LOAD_FAILED);
+			return;
 		}
 		std::streamsize fileSize = 0;
 		file.seekg(0, std::ios::end);
@@ -608,81 +2882,996 @@ namespace ActiasFW {
 		file.seekg(0, std::ios::beg);
 		fileSize -= file.tellg();
 		if (fileSize <= 0) {
-			return 0;
+			finish(LOAD_FAILED);
+			return;
 		}
 		std::vector<unsigned char> buffer;
 		buffer.resize((size_t)fileSize);
 		file.read((char*)(&buffer[0]), fileSize);
 		file.close();
-		std::vector<unsigned char> textureData;
 		unsigned int width = 0;
 		unsigned int height = 0;
-		if (lodepng::decode(textureData, width, height, buffer)) {
+		if (lodepng::decode(pixels, width, height, buffer)) {
+			finish(LOAD_FAILED);
+			return;
+		}
+		dimensions = glm::ivec2((int)width, (int)height);
+		atlased = atlas != 0 && atlas->accepts(dimensions);
+		if (atlased) {
+			std::vector<unsigned char> padded;
+			atlas->pad(pixels.data(), dimensions, padded);
+			pixels.swap(padded);
+		}
+		std::ifstream frameFile(fileName + ".frames");
+		std::string name;
+		glm::vec4 frame;
+		while (frameFile >> name >> frame.x >> frame.y >> frame.z >> frame.w) {
+			frames.push_back(std::pair<std::string, glm::vec4>(name,
+				glm::vec4(frame.x / (float)dimensions.x,
+					frame.y / (float)dimensions.y,
+					frame.z / (float)dimensions.x,
+					frame.w / (float)dimensions.y)));
+		}
+		finish(LOAD_DECODED);
+	}
+
+	void GraphicsManager::TextureLoad::wait() {
+		std::unique_lock<std::mutex> lock(m_mutex);
+		while (state == LOAD_PENDING) {
+			m_finished.wait(lock);
+		}
+	}
+
+	void GraphicsManager::TextureLoad::finish(State finalState) {
+		{
+			std::lock_guard<std::mutex> lock(m_mutex);
+			state = finalState;
+		}
+		m_finished.notify_all();
+	}
+
+	const GraphicsManager::Texture& GraphicsManager::getTexture(
+		const std::string& fileName) {
+		static const Texture NoTexture = { 0, glm::vec4(), false };
+		if (fileName.empty()) {
+			return NoTexture;
+		}
+		std::map<std::string, Texture>::const_iterator it
+			= m_textures.find(fileName);
+		if (it != m_textures.end()) {
+			return it->second;
+		}
+		loadTexture(fileName);
+		return m_placeholderTexture;
+	}
+
+	const GraphicsManager::Texture& GraphicsManager::requireTexture(
+		const std::string& fileName) {
+		const Texture& texture = getTexture(fileName);
+		if (&texture != &m_placeholderTexture) {
+			return texture;
+		}
+		std::map<std::string, TextureLoad>::iterator it
+			= m_textureLoads.find(fileName);
+		it->second.wait();
+		m_statistics.textureBytes += finishTextureLoad(it->second);
+		m_textureLoads.erase(it);
+		return m_textures.at(fileName);
+	}
+
+	void GraphicsManager::loadTexture(const std::string& fileName) {
+		if (fileName.empty() || m_textures.find(fileName) != m_textures.end()
+			|| m_textureLoads.find(fileName) != m_textureLoads.end()) {
+			return;
+		}
+		TextureLoad& load = m_textureLoads[fileName];
+		load.fileName = fileName;
+		load.atlas = m_repeatedTextures.find(fileName)
+			== m_repeatedTextures.end() ? &m_atlas : 0;
+		m_workers.enqueue(load);
+	}
+
+	void GraphicsManager::uploadTextures() {
+		size_t uploaded = 0;
+		std::map<std::string, TextureLoad>::iterator it
+			= m_textureLoads.begin();
+		while (it != m_textureLoads.end()
+			&& (uploaded == 0 || uploaded < m_textureUploadBudget)) {
+			if (it->second.state == TextureLoad::LOAD_PENDING) {
+				it++;
+				continue;
+			}
+			uploaded += finishTextureLoad(it->second);
+			it = m_textureLoads.erase(it);
+		}
+		m_statistics.textureBytes += uploaded;
+	}
+
+	size_t GraphicsManager::finishTextureLoad(const TextureLoad& load) {
+		Texture texture;
+		if (load.state == TextureLoad::LOAD_FAILED) {
+			ACTIASFW_LOG(Graphics, Warning, "Failed to load texture ",
+				load.fileName);
+			texture.ID = 0;
+			m_textures[load.fileName] = texture;
 			return 0;
 		}
-		GLuint textureID = 0;
-		glGenTextures(1, &textureID);
-		glBindTexture(GL_TEXTURE_2D, textureID);
-		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_REPEAT);
-		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_REPEAT);
-		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
-		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
-		glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA8, width, height, 0, GL_RGBA,
-			GL_UNSIGNED_BYTE, &textureData[0]);
-		glBindTexture(GL_TEXTURE_2D, 0);
-		m_textures[fileName] = textureID;
-		return textureID;
+		glm::ivec2 position(0, 0);
+		glm::ivec2 region = load.dimensions;
+		texture.atlased = load.atlased;
+		if (texture.atlased) {
+			m_atlas.reserve(load.dimensions, texture.ID, texture.box, position);
+			region = m_atlas.getPaddedDimensions(load.dimensions);
+			m_state.bindTexture(0, texture.ID);
+		}
+		else {
+			glGenTextures(1, &texture.ID);
+			m_state.bindTexture(0, texture.ID);
+			glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_REPEAT);
+			glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_REPEAT);
+			glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+			glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+			glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA8, region.x, region.y, 0,
+				GL_RGBA, GL_UNSIGNED_BYTE, 0);
+		}
+		// Copy the pixels into the pixel buffer so OpenGL can upload them
+		// without stalling, or upload them directly if they do not fit
+		size_t size = load.pixels.size();
+		const void* pixels = load.pixels.data();
+		GLintptr offset = 0;
+		void* memory = m_pixelStream.map((GLsizeiptr)size, 4, offset);
+		if (memory != 0) {
+			std::memcpy(memory, pixels, size);
+			m_pixelStream.unmap();
+			m_state.bindBuffer(GL_PIXEL_UNPACK_BUFFER,
+				m_pixelStream.getBufferID());
+			pixels = (const void*)offset;
+		}
+		glTexSubImage2D(GL_TEXTURE_2D, 0, position.x, position.y, region.x,
+			region.y, GL_RGBA, GL_UNSIGNED_BYTE, pixels);
+		// Texture uploads from client memory need the pixel buffer unbound
+		m_state.bindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+		if (!load.frames.empty()) {
+			m_textureFrames[load.fileName] = load.frames;
+			ACTIASFW_LOG(Graphics, Info, "Loaded ", load.frames.size(),
+				" frames for texture ", load.fileName);
+		}
+		m_textures[load.fileName] = texture;
+		return size;
 	}
 
-	const Font* GraphicsManager::getFont(const std::string& fileName) {
-		if (m_fonts.find(fileName) != m_fonts.end()) {
-			return &m_fonts.at(fileName);
+	Font* GraphicsManager::getFont(const std::string& fileName) {
+		std::map<std::string, Font>::iterator it = m_fonts.find(fileName);
+		if (it != m_fonts.end()) {
+			return &it->second;
 		}
 		FT_Face face;
 		if (FT_New_Face(m_freeType, fileName.c_str(), 0, &face) != FT_Err_Ok) {
 			return 0;
 		}
-		FT_Set_Pixel_Sizes(face, 0, 64);
-		Font font;
-		for (unsigned char g = 0; g < 128; g++) {
-			if (FT_Load_Char(face, g, FT_LOAD_RENDER) != FT_Err_Ok) {
+		Font::Rendering rendering = Font::RENDERING_BITMAP;
+		std::map<std::string, Font::Rendering>::const_iterator r
+			= m_fontRenderings.find(fileName);
+		if (r != m_fontRenderings.end() && (r->second != Font::RENDERING_SDF
+			|| m_distanceFields)) {
+			rendering = r->second;
+		}
+		// Distance fields are rasterized smaller than text is laid out at, and
+		// extend past each glyph's outline by their spread
+		FT_UInt pixelSize = FontPixelSize;
+		float padding = 0.0f;
+		if (rendering == Font::RENDERING_SDF) {
+			pixelSize = SDFPixelSize;
+			padding = (float)(SDFSpread * (FontPixelSize / SDFPixelSize));
+		}
+		FT_Set_Pixel_Sizes(face, 0, pixelSize);
+		FontFace& fontFace = m_fontFaces[fileName];
+		fontFace.face = face;
+		if (!fontFace.atlas.initialize(GlyphAtlasWidth, GlyphPageSize, 2)) {
+			ACTIASFW_LOG(Graphics, Error, "Failed to create glyph atlas for ",
+				"font ", fileName);
+			FT_Done_Face(face);
+			m_fontFaces.erase(fileName);
+			return 0;
+		}
+		Texture texture;
+		texture.ID = fontFace.atlas.getTextureID();
+		m_textures[fileName] = texture;
+		Font& font = m_fonts[fileName];
+		font.setTextureFileName(fileName);
+		font.setRendering(rendering);
+		font.setPadding(padding);
+		// ASCII metrics set the font's vertical bearings, every image and
+		// every other glyph is loaded when first drawn
+		for (char32_t c = 0; c < 128; c++) {
+			getGlyph(font, c);
+		}
+		ACTIASFW_LOG(Graphics, Info, "Loaded font ", fileName,
+			(rendering == Font::RENDERING_SDF ? " as distance fields" : ""),
+			" with glyphs rasterized on demand");
+		return &font;
+	}
+
+	char32_t GraphicsManager::DecodeUTF8(const std::string& text,
+		size_t& index) {
+		unsigned char lead = (unsigned char)text[index++];
+		if (lead < 0x80) {
+			return lead;
+		}
+		int length = 0;
+		char32_t codepoint = 0;
+		if ((lead & 0xE0) == 0xC0) {
+			length = 1;
+			codepoint = lead & 0x1F;
+		}
+		else if ((lead & 0xF0) == 0xE0) {
+			length = 2;
+			codepoint = lead & 0x0F;
+		}
+		else if ((lead & 0xF8) == 0xF0) {
+			length = 3;
+			codepoint = lead & 0x07;
+		}
+		else {
+			return ReplacementCharacter;
+		}
+		for (int i = 0; i < length; i++) {
+			if (index >= text.length()
+				|| ((unsigned char)text[index] & 0xC0) != 0x80) {
+				return ReplacementCharacter;
+			}
+			codepoint = (codepoint << 6)
+				| ((unsigned char)text[index++] & 0x3F);
+		}
+		return codepoint;
+	}
+
+	thread_local GraphicsManager::LocalCommandBufferSlot
+		GraphicsManager::LocalCommandBuffer;
+	thread_local GraphicsManager::CommandBuffer*
+		GraphicsManager::LocalTargetCommandBuffer = 0;
+
+	GraphicsManager::LocalCommandBufferSlot::~LocalCommandBufferSlot() {
+		release();
+	}
+
+	void GraphicsManager::LocalCommandBufferSlot::release() {
+		if (owner == 0) {
+			return;
+		}
+		std::lock_guard<std::mutex> lock(owner->m_commandBuffersMutex);
+		if (generation == owner->m_commandBuffersGeneration) {
+			buffer->released = true;
+		}
+		buffer = 0;
+		owner = 0;
+	}
+
+	GraphicsManager::CommandBuffer& GraphicsManager::getCommandBuffer() {
+		if (LocalTargetCommandBuffer != 0) {
+			return *LocalTargetCommandBuffer;
+		}
+		LocalCommandBufferSlot& slot = LocalCommandBuffer;
+		if (slot.buffer == 0 || slot.owner != this
+			|| slot.generation != m_commandBuffersGeneration) {
+			// A thread moving to another graphics manager releases its
+			// buffer in the last one
+			slot.release();
+			std::lock_guard<std::mutex> lock(m_commandBuffersMutex);
+			m_commandBuffers.push_back(CommandBuffer());
+			slot.buffer = &m_commandBuffers.back();
+			slot.owner = this;
+			slot.generation = m_commandBuffersGeneration;
+		}
+		return *slot.buffer;
+	}
+
+	void GraphicsManager::ClearCommandBuffer(CommandBuffer& buffer) {
+		buffer.items.clear();
+		buffer.text.clear();
+		buffer.textData.clear();
+		buffer.batches.clear();
+		buffer.tileMaps.clear();
+		buffer.particleSystems.clear();
+		buffer.textMeshes.clear();
+		buffer.meshes.clear();
+		buffer.vertexData.clear();
+		buffer.indexData.clear();
+	}
+
+	void GraphicsManager::PrepareTask::execute(size_t first, size_t last) {
+		for (size_t i = first; i < last; i++) {
+			RenderItem& item = manager->m_renderItems[i];
+			if (item.sprite == 0) {
+				continue;
+			}
+			item.culled = !manager->isVisible(manager->getBounds(*item.sprite),
+				item.shader->getCamera());
+			if (!item.culled && !item.shader->isInstanced()) {
+				item.sprite->draw();
+			}
+		}
+	}
+
+	glm::vec4 GraphicsManager::getBounds(const Sprite& sprite) const {
+		if ((int)sprite.m_rotation % 360 == 0) {
+			return glm::vec4(sprite.m_position.x, sprite.m_position.y,
+				sprite.m_dimensions.x, sprite.m_dimensions.y);
+		}
+		float radius = glm::length(sprite.m_dimensions) / 2.0f;
+		glm::vec2 center = glm::vec2(sprite.m_position.x, sprite.m_position.y)
+			+ sprite.m_dimensions / 2.0f;
+		return glm::vec4(center.x - radius, center.y - radius,
+			2.0f * radius, 2.0f * radius);
+	}
+
+	bool GraphicsManager::isVisible(const glm::vec4& bounds,
+		const Camera& camera) const {
+		const glm::vec4& view = camera.getVisibleBox();
+		return bounds.x + bounds.z >= view.x && bounds.x <= view.x + view.z
+			&& bounds.y + bounds.w >= view.y && bounds.y <= view.y + view.w;
+	}
+
+	void GraphicsManager::bake(StaticBatch& batch) {
+		// Baked texture coordinates need the batch's textures to be loaded, so
+		// start every load before waiting on any of them
+		for (Sprite* sprite : batch.m_sprites) {
+			loadTexture(sprite->getTextureFileName());
+		}
+		// Split the batch's bounds into a grid so that each group covers the
+		// sprites of one cell rather than the whole batch
+		std::vector<glm::vec4> spriteBounds(batch.m_sprites.size());
+		glm::vec4 batchBounds = glm::vec4();
+		for (size_t s = 0; s < batch.m_sprites.size(); s++) {
+			spriteBounds.at(s) = getBounds(*batch.m_sprites.at(s));
+			batchBounds = s == 0 ? spriteBounds.at(s)
+				: Enclose(batchBounds, spriteBounds.at(s));
+		}
+		glm::vec2 cellSize = glm::max(glm::vec2(batchBounds.z, batchBounds.w)
+			/ (float)StaticBatch::GridSize, glm::vec2(1.0f, 1.0f));
+		// Order the sprites by depth, texture, then grid cell so each group is
+		// contiguous
+		std::vector<std::tuple<std::uint64_t, int, size_t>> order;
+		order.reserve(batch.m_sprites.size());
+		for (size_t s = 0; s < batch.m_sprites.size(); s++) {
+			Sprite* sprite = batch.m_sprites.at(s);
+			const Texture& texture
+				= requireTexture(sprite->getTextureFileName());
+			const glm::vec4& bounds = spriteBounds.at(s);
+			glm::ivec2 cell = glm::clamp(glm::ivec2((glm::vec2(bounds)
+				+ glm::vec2(bounds.z, bounds.w) / 2.0f
+				- glm::vec2(batchBounds)) / cellSize), glm::ivec2(0, 0),
+				glm::ivec2(StaticBatch::GridSize - 1));
+			order.push_back(std::tuple<std::uint64_t, int, size_t>(
+				getSortKey(batch.m_shader, sprite->getPosition().z, texture),
+				cell.x + cell.y * StaticBatch::GridSize, s));
+		}
+		std::sort(order.begin(), order.end());
+		unsigned int stride = batch.m_shader->getVertexAttributeStride();
+		std::vector<float> vertices;
+		std::vector<unsigned int> indices;
+		batch.m_groups.clear();
+		batch.m_textureIDs.clear();
+		std::uint64_t groupKey = 0;
+		int groupCell = 0;
+		for (const std::tuple<std::uint64_t, int, size_t>& o : order) {
+			Sprite& sprite = *batch.m_sprites.at(std::get<2>(o));
+			sprite.draw();
+			if (sprite.getVertices().empty() || stride == 0) {
 				continue;
 			}
-			GLuint textureID;
-			glGenTextures(1, &textureID);
-			glBindTexture(GL_TEXTURE_2D, textureID);
-			glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
-			glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
-			glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
-			glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
-			glTexImage2D(GL_TEXTURE_2D, 0, GL_RED, face->glyph->bitmap.width,
-				face->glyph->bitmap.rows, 0, GL_RED, GL_UNSIGNED_BYTE,
-				face->glyph->bitmap.buffer);
-			Glyph glyph;
-			glyph.setDimensions(glm::vec2(face->glyph->bitmap.width,
-				face->glyph->bitmap.rows));
-			glyph.setBearing(glm::ivec2(face->glyph->bitmap_left,
-				face->glyph->bitmap_top));
-			glyph.setOffset(face->glyph->advance.x >> 6);
-			glyph.setTextureFileName(fileName + "-" + (char)g);
-			m_textures[glyph.getTextureFileName()] = textureID;
-			font.addGlyph(g, glyph);
-		}
-		FT_Done_Face(face);
-		m_fonts[fileName] = font;
-		return &m_fonts.at(fileName);
-	}
-
-	void GraphicsManager::draw(const std::vector<unsigned int>& indices,
-		const std::vector<float>& vertices) {
-		glBindBuffer(GL_ARRAY_BUFFER, m_VBOID);
-		glBufferData(GL_ARRAY_BUFFER, sizeof(float) * vertices.size(),
+			const glm::vec4& bounds = spriteBounds.at(std::get<2>(o));
+			const Texture& texture
+				= requireTexture(sprite.getTextureFileName());
+			if (batch.m_groups.empty() || std::get<0>(o) != groupKey
+				|| std::get<1>(o) != groupCell) {
+				addStaticGroup(batch, sprite.getPosition().z,
+					sprite.getTextureFileName(), texture, bounds,
+					(unsigned int)indices.size());
+				groupKey = std::get<0>(o);
+				groupCell = std::get<1>(o);
+			}
+			StaticBatch::Group& group = batch.m_groups.back();
+			group.bounds = Enclose(group.bounds, bounds);
+			unsigned int base
+				= (unsigned int)(vertices.size() * sizeof(float) / stride);
+			for (unsigned int index : sprite.getIndices()) {
+				indices.push_back(index + base);
+			}
+			size_t v = vertices.size();
+			vertices.resize(v + sprite.getVertices().size());
+			copyVertices(sprite.getVertices(), texture, group.unit,
+				vertices.data() + v);
+			group.indexCount += (unsigned int)sprite.getIndices().size();
+			group.spriteCount++;
+		}
+		uploadBatch(batch, vertices, indices);
+		ACTIASFW_LOG(Graphics, Info, "Baked ", batch.m_sprites.size(),
+			" sprites into ", batch.m_groups.size(), " static batch groups");
+	}
+
+	void GraphicsManager::bake(TileMap& map, TileMap::Chunk& chunk) {
+		StaticBatch& batch = chunk.batch;
+		for (const std::string& fileName : map.m_tileTextureFileNames) {
+			loadTexture(fileName);
+		}
+		// Cover the chunk's cells with rectangles of one tile, growing each
+		// rectangle right then up while its texture repeats, and order them by
+		// texture so each group is contiguous
+		const std::uint16_t* tiles = map.m_tiles.data()
+			+ map.getTileIndex(chunk.origin);
+		bool covered[TileMap::ChunkSize * TileMap::ChunkSize] = {};
+		std::vector<glm::ivec4> rectangles;
+		std::vector<std::pair<std::uint64_t, size_t>> order;
+		for (int y = 0; y < chunk.dimensions.y; y++) {
+			for (int x = 0; x < chunk.dimensions.x; x++) {
+				std::uint16_t tile = tiles[x + y * TileMap::ChunkSize];
+				if (covered[x + y * TileMap::ChunkSize]
+					|| tile >= map.m_tileTextureFileNames.size()) {
+					continue;
+				}
+				const Texture& texture
+					= requireTexture(map.m_tileTextureFileNames.at(tile));
+				glm::ivec2 size(1, 1);
+				while (!texture.atlased && x + size.x < chunk.dimensions.x
+					&& tiles[x + size.x + y * TileMap::ChunkSize] == tile
+					&& !covered[x + size.x + y * TileMap::ChunkSize]) {
+					size.x++;
+				}
+				bool grow = !texture.atlased;
+				while (grow && y + size.y < chunk.dimensions.y) {
+					for (int r = x; r < x + size.x && grow; r++) {
+						size_t c = r + (y + size.y) * TileMap::ChunkSize;
+						grow = tiles[c] == tile && !covered[c];
+					}
+					if (grow) {
+						size.y++;
+					}
+				}
+				for (int cy = y; cy < y + size.y; cy++) {
+					for (int cx = x; cx < x + size.x; cx++) {
+						covered[cx + cy * TileMap::ChunkSize] = true;
+					}
+				}
+				order.push_back(std::pair<std::uint64_t, size_t>(getSortKey(
+					map.m_shader, map.m_position.z, texture),
+					rectangles.size()));
+				rectangles.push_back(glm::ivec4(x, y, size.x, size.y));
+			}
+		}
+		std::sort(order.begin(), order.end());
+		std::vector<float> quad(QuadKernel::FloatsPerSprite);
+		std::vector<float> vertices;
+		std::vector<unsigned int> indices;
+		batch.m_groups.clear();
+		batch.m_textureIDs.clear();
+		std::uint64_t groupKey = 0;
+		for (const std::pair<std::uint64_t, size_t>& o : order) {
+			const glm::ivec4& rectangle = rectangles.at(o.second);
+			const std::string& fileName = map.m_tileTextureFileNames.at(
+				tiles[rectangle.x + rectangle.y * TileMap::ChunkSize]);
+			const Texture& texture = requireTexture(fileName);
+			glm::vec4 bounds(glm::vec2(map.m_position) + glm::vec2(
+				chunk.origin + glm::ivec2(rectangle)) * map.m_tileDimensions,
+				glm::vec2(rectangle.z, rectangle.w) * map.m_tileDimensions);
+			if (batch.m_groups.empty() || o.first != groupKey) {
+				addStaticGroup(batch, map.m_position.z, fileName, texture,
+					bounds, (unsigned int)indices.size());
+				groupKey = o.first;
+			}
+			StaticBatch::Group& group = batch.m_groups.back();
+			group.bounds = Enclose(group.bounds, bounds);
+			// Texture coordinates past 1 repeat the tile's texture once per
+			// cell of the rectangle
+			QuadKernel::ExpandOne(glm::vec3(bounds.x, bounds.y,
+				map.m_position.z), glm::vec2(bounds.z, bounds.w), 0.0f,
+				glm::vec4(0.0f, 0.0f, (float)rectangle.z, (float)rectangle.w),
+				glm::vec4(1.0f, 1.0f, 1.0f, 1.0f), 0.0f, false, false,
+				quad.data());
+			unsigned int base
+				= (unsigned int)(vertices.size() / Sprite::VertexSize);
+			for (unsigned int index : QuadKernel::Indices) {
+				indices.push_back(index + base);
+			}
+			size_t v = vertices.size();
+			vertices.resize(v + quad.size());
+			copyVertices(quad, texture, group.unit, vertices.data() + v);
+			group.indexCount += 6;
+			group.spriteCount++;
+		}
+		uploadBatch(batch, vertices, indices);
+	}
+
+	void GraphicsManager::addStaticGroup(StaticBatch& batch, float depth,
+		const std::string& textureFileName, const Texture& texture,
+		const glm::vec4& bounds, unsigned int firstIndex) {
+		StaticBatch::Group group;
+		group.depth = depth;
+		group.textureFileName = textureFileName;
+		group.bounds = bounds;
+		group.firstIndex = firstIndex;
+		// Give each of the batch's textures a unit in a texture set
+		size_t unitCount = batch.m_shader->getTextureUnitCount();
+		size_t t = std::find(batch.m_textureIDs.begin(),
+			batch.m_textureIDs.end(), texture.ID) - batch.m_textureIDs.begin();
+		if (t == batch.m_textureIDs.size()) {
+			batch.m_textureIDs.push_back(texture.ID);
+		}
+		group.unit = (unsigned int)(t % unitCount);
+		group.textureSet = (unsigned int)(t / unitCount);
+		batch.m_groups.push_back(group);
+	}
+
+	void GraphicsManager::uploadBatch(StaticBatch& batch,
+		const std::vector<float>& vertices,
+		const std::vector<unsigned int>& indices) {
+		m_state.bindVertexArray(batch.m_VAOID);
+		m_state.bindBuffer(GL_ARRAY_BUFFER, batch.m_VBOID);
+		glBufferData(GL_ARRAY_BUFFER, vertices.size() * sizeof(float),
 			vertices.data(), GL_STATIC_DRAW);
-		glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, m_IBOID);
+		m_state.bindBuffer(GL_ELEMENT_ARRAY_BUFFER, batch.m_IBOID);
 		glBufferData(GL_ELEMENT_ARRAY_BUFFER,
-			sizeof(unsigned int) * indices.size(), indices.data(),
+			indices.size() * sizeof(unsigned int), indices.data(),
 			GL_STATIC_DRAW);
-		glDrawElements(GL_TRIANGLES, (GLsizei)indices.size(), GL_UNSIGNED_INT,
-			(void*)0);
+		batch.m_shader->bindVertexAttributes();
+		batch.m_dirty = false;
+	}
+
+	void GraphicsManager::addStaticGroups(StaticBatch& batch) {
+		for (size_t g = 0; g < batch.m_groups.size(); g++) {
+			RenderItem item;
+			item.shader = batch.m_shader;
+			item.batch = &batch;
+			item.group = g;
+			item.culled = !isVisible(batch.m_groups.at(g).bounds,
+				batch.m_shader->getCamera());
+			m_renderItems.push_back(item);
+		}
+	}
+
+	glm::vec4 GraphicsManager::Enclose(const glm::vec4& a,
+		const glm::vec4& b) {
+		glm::vec2 min = glm::min(glm::vec2(a), glm::vec2(b));
+		glm::vec2 max = glm::max(glm::vec2(a) + glm::vec2(a.z, a.w),
+			glm::vec2(b) + glm::vec2(b.z, b.w));
+		return glm::vec4(min, max - min);
+	}
+
+	void GraphicsManager::copyVertices(const std::vector<float>& source,
+		const Texture& texture, unsigned int unit, float* vertices) const {
+		if (!texture.atlased && unit == 0) {
+			std::memcpy(vertices, source.data(),
+				source.size() * sizeof(float));
+			return;
+		}
+		// Map the sprites' texture coordinates into their atlas page and add
+		// their texture unit to their mode as they are copied, so that the
+		// vertex memory is only written to once
+		glm::vec4 box = texture.atlased ? texture.box
+			: glm::vec4(0.0f, 0.0f, 1.0f, 1.0f);
+		float mode = (float)(unit * ModesPerTextureUnit);
+		const float* from = source.data();
+		for (size_t v = 0; v + Sprite::VertexSize <= source.size();
+			v += Sprite::VertexSize) {
+			vertices[v] = from[v];
+			vertices[v + 1] = from[v + 1];
+			vertices[v + 2] = from[v + 2];
+			vertices[v + 3] = box.x + from[v + 3] * box.z;
+			vertices[v + 4] = box.y + from[v + 4] * box.w;
+			vertices[v + 5] = from[v + 5];
+			vertices[v + 6] = from[v + 6];
+			vertices[v + 7] = from[v + 7];
+			vertices[v + 8] = from[v + 8];
+			vertices[v + 9] = from[v + 9] + mode;
+		}
+	}
+
+	std::uint64_t GraphicsManager::getSortKey(GLSLShader* shader, float z,
+		const Texture& texture) {
+		// Map the depth's bits to an unsigned integer with the same order
+		std::uint32_t depth = 0;
+		std::memcpy(&depth, &z, sizeof(depth));
+		depth = (depth & 0x80000000u) != 0 ? ~depth : depth | 0x80000000u;
+		std::uint64_t shaderIndex = 0;
+		if (m_frameShaders.empty() || m_frameShaders.back() != shader) {
+			std::vector<GLSLShader*>::iterator it = std::find(
+				m_frameShaders.begin(), m_frameShaders.end(), shader);
+			shaderIndex = it - m_frameShaders.begin();
+			if (it == m_frameShaders.end()) {
+				m_frameShaders.push_back(shader);
+			}
+		}
+		else {
+			shaderIndex = m_frameShaders.size() - 1;
+		}
+		return ((std::uint64_t)depth << 32) | ((shaderIndex & 0xFFF) << 20)
+			| (std::uint64_t)(texture.ID & 0xFFFFF);
+	}
+
+	void GraphicsManager::sortRenderItems() {
+		size_t count = m_renderItems.size();
+		// Submission order barely changes between frames, so try an insertion
+		// sort first and give up once it has moved too many items
+		size_t moves = 0;
+		size_t moveBudget = 4 * count;
+		size_t i = 1;
+		for (; i < count && moves <= moveBudget; i++) {
+			if (m_renderItems.at(i - 1).key <= m_renderItems.at(i).key) {
+				continue;
+			}
+			RenderItem item = m_renderItems.at(i);
+			size_t j = i;
+			while (j > 0 && m_renderItems.at(j - 1).key > item.key) {
+				m_renderItems[j] = m_renderItems.at(j - 1);
+				j--;
+			}
+			m_renderItems[j] = item;
+			moves += i - j;
+		}
+		if (i >= count) {
+			return;
+		}
+		size_t histograms[8][256] = {};
+		for (const RenderItem& item : m_renderItems) {
+			for (unsigned int b = 0; b < 8; b++) {
+				histograms[b][(item.key >> (8 * b)) & 0xFF]++;
+			}
+		}
+		m_sortBuffer.resize(count);
+		for (unsigned int b = 0; b < 8; b++) {
+			size_t* histogram = histograms[b];
+			if (histogram[(m_renderItems.front().key >> (8 * b)) & 0xFF]
+				== count) {
+				continue;
+			}
+			size_t offset = 0;
+			for (unsigned int d = 0; d < 256; d++) {
+				size_t c = histogram[d];
+				histogram[d] = offset;
+				offset += c;
+			}
+			for (const RenderItem& item : m_renderItems) {
+				m_sortBuffer[histogram[(item.key >> (8 * b)) & 0xFF]++] = item;
+			}
+			m_renderItems.swap(m_sortBuffer);
+		}
+	}
+
+	void GraphicsManager::draw(size_t first, size_t last,
+		unsigned int stride) {
+		if (stride == 0) {
+			return;
+		}
+		while (first < last) {
+			// Particle systems stream their own quads, often more than fit
+			// in one draw call
+			if (m_renderItems.at(first).particles != 0) {
+				drawParticles(m_renderItems.at(first), stride);
+				first++;
+				continue;
+			}
+			GLsizeiptr vertexBytes = 0;
+			GLsizeiptr indexBytes = 0;
+			size_t end = first;
+			while (end < last) {
+				const RenderItem& item = m_renderItems.at(end);
+				GLsizeiptr v = 0;
+				GLsizeiptr i = 0;
+				if (item.particles != 0) {
+					break;
+				}
+				if (item.text != 0) {
+					v = item.text->m_vertices.size() * sizeof(float);
+					i = item.text->m_indices.size() * sizeof(unsigned int);
+				}
+				else if (item.commands != 0) {
+					const Mesh& mesh = item.commands->meshes.at(item.mesh);
+					v = (GLsizeiptr)mesh.vertexBytes;
+					i = (GLsizeiptr)(mesh.indexCount * sizeof(unsigned int));
+				}
+				else {
+					v = item.sprite->getVertices().size() * sizeof(float);
+					i = item.sprite->getIndices().size() * sizeof(unsigned int);
+				}
+				if (end > first && (vertexBytes + v
+					> m_vertexStream.getCapacity() - stride
+					|| indexBytes + i > m_indexStream.getCapacity()
+					- (GLsizeiptr)sizeof(unsigned int))) {
+					break;
+				}
+				vertexBytes += v;
+				indexBytes += i;
+				end++;
+			}
+			GLintptr vertexOffset = 0;
+			GLintptr indexOffset = 0;
+			unsigned char* vertices = (unsigned char*)m_vertexStream.map(
+				vertexBytes, stride, vertexOffset);
+			unsigned int* indices = (unsigned int*)m_indexStream.map(
+				indexBytes, sizeof(unsigned int), indexOffset);
+			if (vertices == 0 || indices == 0) {
+				ACTIASFW_LOG(Graphics, Warning, "Sprite or mesh is too large ",
+					"for the stream buffer");
+				m_vertexStream.unmap();
+				m_indexStream.unmap();
+				first = end;
+				continue;
+			}
+			unsigned int base = 0;
+			for (size_t s = first; s < end; s++) {
+				const RenderItem& item = m_renderItems.at(s);
+				size_t bytes = 0;
+				if (item.text != 0) {
+					for (unsigned int index : item.text->m_indices) {
+						*(indices++) = index + base;
+					}
+					copyVertices(item.text->m_vertices, *item.texture,
+						item.unit, (float*)vertices);
+					bytes = item.text->m_vertices.size() * sizeof(float);
+				}
+				else if (item.commands != 0) {
+					const Mesh& mesh = item.commands->meshes.at(item.mesh);
+					const unsigned int* meshIndices
+						= item.commands->indexData.data() + mesh.indexOffset;
+					for (size_t i = 0; i < mesh.indexCount; i++) {
+						*(indices++) = meshIndices[i] + base;
+					}
+					bytes = mesh.vertexBytes;
+					std::memcpy(vertices, item.commands->vertexData.data()
+						+ mesh.vertexOffset, bytes);
+				}
+				else {
+					for (unsigned int index : item.sprite->getIndices()) {
+						*(indices++) = index + base;
+					}
+					copyVertices(item.sprite->getVertices(), *item.texture,
+						item.unit, (float*)vertices);
+					bytes = item.sprite->getVertices().size() * sizeof(float);
+				}
+				vertices += bytes;
+				base += (unsigned int)(bytes / stride);
+			}
+			m_vertexStream.unmap();
+			m_indexStream.unmap();
+			glDrawElementsBaseVertex(GL_TRIANGLES,
+				(GLsizei)(indexBytes / sizeof(unsigned int)), GL_UNSIGNED_INT,
+				(void*)indexOffset, (GLint)(vertexOffset / stride));
+			m_statistics.sprites += (unsigned int)(end - first);
+			m_statistics.drawCalls++;
+			m_statistics.vertexBytes += (size_t)vertexBytes;
+			m_statistics.indexBytes += (size_t)indexBytes;
+			first = end;
+		}
+	}
+
+	void GraphicsManager::drawParticles(const RenderItem& item,
+		unsigned int stride) {
+		if (stride != Sprite::VertexSize * sizeof(float)) {
+			return;
+		}
+		if (item.particles->getSimulation() == ParticleSystem::SIMULATION_GPU) {
+			drawSimulatedParticles(item);
+			return;
+		}
+		const QuadBatch& particles = item.particles->getParticles();
+		const GLsizeiptr quadBytes = QuadKernel::FloatsPerSprite
+			* sizeof(float);
+		const GLsizeiptr quadIndexBytes = 6 * sizeof(unsigned int);
+		size_t capacity = (size_t)std::min(
+			(m_vertexStream.getCapacity() - stride) / quadBytes,
+			(m_indexStream.getCapacity() - (GLsizeiptr)sizeof(unsigned int))
+			/ quadIndexBytes);
+		size_t first = 0;
+		while (first < particles.size()) {
+			size_t end = std::min(particles.size(), first + capacity);
+			size_t count = end - first;
+			GLintptr vertexOffset = 0;
+			GLintptr indexOffset = 0;
+			float* vertices = (float*)m_vertexStream.map(
+				(GLsizeiptr)count * quadBytes, stride, vertexOffset);
+			unsigned int* indices = (unsigned int*)m_indexStream.map(
+				(GLsizeiptr)count * quadIndexBytes, sizeof(unsigned int),
+				indexOffset);
+			if (vertices == 0 || indices == 0) {
+				m_vertexStream.unmap();
+				m_indexStream.unmap();
+				return;
+			}
+			if (!item.texture->atlased && item.unit == 0) {
+				QuadKernel::Expand(particles, first, end, vertices);
+			}
+			else {
+				// Expand the particles into memory which can be read back, as
+				// the vertex stream is only mapped for writing
+				m_particleVertices.resize(count * QuadKernel::FloatsPerSprite);
+				QuadKernel::Expand(particles, first, end,
+					m_particleVertices.data());
+				copyVertices(m_particleVertices, *item.texture, item.unit,
+					vertices);
+			}
+			for (unsigned int q = 0; q < (unsigned int)count; q++) {
+				for (unsigned int index : QuadKernel::Indices) {
+					*(indices++) = index + 4 * q;
+				}
+			}
+			m_vertexStream.unmap();
+			m_indexStream.unmap();
+			glDrawElementsBaseVertex(GL_TRIANGLES, (GLsizei)(count * 6),
+				GL_UNSIGNED_INT, (void*)indexOffset,
+				(GLint)(vertexOffset / stride));
+			m_statistics.sprites += (unsigned int)count;
+			m_statistics.drawCalls++;
+			m_statistics.vertexBytes += (size_t)(count * quadBytes);
+			m_statistics.indexBytes += (size_t)(count * quadIndexBytes);
+			first = end;
+		}
+	}
+
+	void GraphicsManager::drawSimulatedParticles(const RenderItem& item) {
+		const ParticleSystem& particles = *item.particles;
+		GLuint programID = m_state.getProgram();
+		GLuint vertexArrayID = m_state.getVertexArray();
+		glm::vec4 box = item.texture->atlased ? item.texture->box
+			: glm::vec4(0.0f, 0.0f, 1.0f, 1.0f);
+		m_state.useProgram(m_particleExpansionProgram);
+		glUniform1ui(0, particles.m_source);
+		glUniform1f(1, particles.m_depth);
+		glUniform1f(2, (float)particles.m_frameCount);
+		glUniform4fv(3, 1, &particles.m_startColor[0]);
+		glUniform4fv(4, 1, &particles.m_endColor[0]);
+		glUniform4fv(5, 1, &box[0]);
+		glUniform1f(6, (float)particles.m_textureFileName.empty()
+			+ (float)(item.unit * ModesPerTextureUnit));
+		glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 0,
+			particles.m_stateBufferIDs[particles.m_source]);
+		glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 2,
+			particles.m_countBufferID);
+		glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 4,
+			particles.m_vertexBufferID);
+		glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 5,
+			particles.m_commandBufferID);
+		glDispatchCompute((GLuint)((particles.m_count
+			+ ParticleSystem::WorkGroupSize - 1)
+			/ ParticleSystem::WorkGroupSize), 1, 1);
+		glMemoryBarrier(GL_VERTEX_ATTRIB_ARRAY_BARRIER_BIT
+			| GL_COMMAND_BARRIER_BIT);
+		// The number of vertices drawn is read from the command buffer, so
+		// the particles are never counted on the CPU
+		m_state.useProgram(programID);
+		m_state.bindVertexArray(particles.m_VAOID);
+		m_state.bindBuffer(GL_DRAW_INDIRECT_BUFFER,
+			particles.m_commandBufferID);
+		glDrawArraysIndirect(GL_TRIANGLES, 0);
+		m_state.bindVertexArray(vertexArrayID);
+		m_statistics.drawCalls++;
+	}
+
+	void GraphicsManager::bindTextures(const std::vector<GLuint>& textures) {
+		for (unsigned int u = 0; u < textures.size(); u++) {
+			m_state.bindTexture(u, textures.at(u));
+		}
+	}
+
+	void GraphicsManager::bindVertexArray(const GLSLShader& shader) {
+		GLuint vertexArrayID = m_VAOID;
+		if (!shader.isInstanced()) {
+			std::map<VertexLayout, GLuint>::iterator it
+				= m_vertexArrays.find(shader.getVertexLayout());
+			if (it == m_vertexArrays.end()) {
+				GLuint ID = 0;
+				glGenVertexArrays(1, &ID);
+				m_state.bindVertexArray(ID);
+				m_state.bindBuffer(GL_ARRAY_BUFFER,
+					m_vertexStream.getBufferID());
+				m_state.bindBuffer(GL_ELEMENT_ARRAY_BUFFER,
+					m_indexStream.getBufferID());
+				shader.getVertexLayout().bind();
+				it = m_vertexArrays.insert(std::pair<const VertexLayout,
+					GLuint>(shader.getVertexLayout(), ID)).first;
+			}
+			vertexArrayID = it->second;
+		}
+		m_state.bindVertexArray(vertexArrayID);
+	}
+
+	void GraphicsManager::drawStaticGroups(size_t first, size_t last) {
+		const StaticBatch& batch = *m_renderItems.at(first).batch;
+		GLsizei count = (GLsizei)(last - first);
+		GLuint vertexArrayID = m_state.getVertexArray();
+		m_state.bindVertexArray(batch.m_VAOID);
+		GLintptr offset = 0;
+		DrawCommand* commands = m_indirectStream.getBufferID() == 0 ? 0
+			: (DrawCommand*)m_indirectStream.map(count * sizeof(DrawCommand),
+				sizeof(GLuint), offset);
+		if (commands != 0) {
+			for (size_t i = first; i < last; i++) {
+				const StaticBatch::Group& group
+					= batch.m_groups.at(m_renderItems.at(i).group);
+				DrawCommand& command = *(commands++);
+				command = DrawCommand();
+				command.count = group.indexCount;
+				command.firstIndex = group.firstIndex;
+				m_statistics.sprites += group.spriteCount;
+			}
+			m_indirectStream.unmap();
+			m_state.bindBuffer(GL_DRAW_INDIRECT_BUFFER,
+				m_indirectStream.getBufferID());
+			glMultiDrawElementsIndirect(GL_TRIANGLES, GL_UNSIGNED_INT,
+				(void*)offset, count, 0);
+		}
+		else {
+			m_multiDrawCounts.clear();
+			m_multiDrawOffsets.clear();
+			for (size_t i = first; i < last; i++) {
+				const StaticBatch::Group& group
+					= batch.m_groups.at(m_renderItems.at(i).group);
+				m_multiDrawCounts.push_back((GLsizei)group.indexCount);
+				m_multiDrawOffsets.push_back(
+					(void*)(group.firstIndex * sizeof(unsigned int)));
+				m_statistics.sprites += group.spriteCount;
+			}
+			glMultiDrawElements(GL_TRIANGLES, m_multiDrawCounts.data(),
+				GL_UNSIGNED_INT, m_multiDrawOffsets.data(), count);
+		}
+		m_state.bindVertexArray(vertexArrayID);
+		m_statistics.drawCalls++;
+	}
+
+	void GraphicsManager::drawInstances(size_t first, size_t last,
+		GLSLShader& shader) {
+		const GLsizeiptr stride = sizeof(SpriteInstance);
+		size_t capacity = (size_t)((m_vertexStream.getCapacity() - stride)
+			/ stride);
+		while (first < last) {
+			size_t end = std::min(last, first + capacity);
+			GLintptr offset = 0;
+			SpriteInstance* instances = (SpriteInstance*)m_vertexStream.map(
+				(GLsizeiptr)(end - first) * stride, stride, offset);
+			if (instances == 0) {
+				return;
+			}
+			for (size_t s = first; s < end; s++) {
+				const Sprite& sprite = *m_renderItems.at(s).sprite;
+				SpriteInstance& instance = *(instances++);
+				instance.position[0] = sprite.m_position.x;
+				instance.position[1] = sprite.m_position.y;
+				instance.position[2] = sprite.m_position.z;
+				instance.dimensions[0] = sprite.m_dimensions.x;
+				instance.dimensions[1] = sprite.m_dimensions.y;
+				instance.rotation = (int)sprite.m_rotation % 360 != 0
+					? sprite.m_rotation : 0.0f;
+				glm::vec4 box = sprite.m_textureBox;
+				const Texture& texture = *m_renderItems.at(s).texture;
+				if (texture.atlased) {
+					box = glm::vec4(texture.box.x + box.x * texture.box.z,
+						texture.box.y + box.y * texture.box.w,
+						box.z * texture.box.z, box.w * texture.box.w);
+				}
+				if (sprite.m_reflectedHorizontally) {
+					box.x += box.z;
+					box.z = -box.z;
+				}
+				if (sprite.m_reflectedVertically) {
+					box.y += box.w;
+					box.w = -box.w;
+				}
+				std::memcpy(instance.textureBox, &box[0], sizeof(box));
+				for (unsigned int c = 0; c < 4; c++) {
+					instance.color[c] = (unsigned char)(std::clamp(
+						sprite.m_color[c], 0.0f, 1.0f) * 255.0f + 0.5f);
+				}
+				instance.mode = sprite.getDrawMode() + (float)(
+					m_renderItems.at(s).unit * ModesPerTextureUnit);
+			}
+			m_vertexStream.unmap();
+			m_state.bindBuffer(GL_ARRAY_BUFFER, m_vertexStream.getBufferID());
+			shader.bindInstanceAttributes(offset);
+			glDrawArraysInstanced(GL_TRIANGLE_STRIP, 0, 4,
+				(GLsizei)(end - first));
+			m_statistics.sprites += (unsigned int)(end - first);
+			m_statistics.drawCalls++;
+			m_statistics.vertexBytes += (end - first) * stride;
+			first = end;
+		}
 	}
 }
\ No newline at end of file
@@ -7,6 +7,8 @@ Purpose:	Defines variables and implements functions found in Input.h
 
 #include "ActiasFW.h"
 
+#include <algorithm>
+
 namespace ActiasFW {
 	// Implement InputListener class functions
 
@@ -18,7 +20,7 @@ namespace ActiasFW {
 
 	}
 
-	void InputListener::characterTyped(char) {
+	void InputListener::characterTyped(char32_t) {
 
 	}
 
@@ -400,9 +402,9 @@ namespace ActiasFW {
 		}
 	}
 
-	void InputManager::typeCharacter(char character) {
+	void InputManager::typeCharacter(char32_t codepoint) {
 		for (InputListener* listener : m_listeners) {
-			listener->characterTyped(character);
+			listener->characterTyped(codepoint);
 		}
 	}
 
@@ -418,7 +420,7 @@ namespace ActiasFW {
 
 	void InputManager::CharacterEvent(GLFWwindow* window,
 		unsigned int codepoint) {
-		Application::Input.typeCharacter((char)codepoint);
+		Application::Input.typeCharacter((char32_t)codepoint);
 	}
 
 	bool InputManager::wasMouseButtonDown(MouseButtonCode button) const {
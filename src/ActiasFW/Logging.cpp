@@ -7,6 +7,8 @@ Purpose:	Defines variables and implements functions found in Logging.h
 
 #include "ActiasFW.h"
 
+#include <ctime>
+
 namespace ActiasFW {
 	// Implement LogManager class functions
 
@@ -31,14 +33,17 @@ namespace ActiasFW {
 
 	const std::string LogManager::getTimestamp() const {
 		struct tm t;
-		__time64_t lt;
 		char buffer[64];
-		errno_t err;
-		_time64(&lt);
-		err = _localtime64_s(&t, &lt);
-		if (err) {
+		std::time_t lt = std::time(0);
+#ifdef _WIN32
+		if (localtime_s(&t, &lt) != 0) {
+			return "";
+		}
+#else
+		if (localtime_r(&lt, &t) == 0) {
 			return "";
 		}
+#endif
 		strftime(buffer, sizeof(buffer), m_timestampFormat.c_str(), &t);
 		return std::string(buffer);
 	}
@@ -0,0 +1,68 @@
+/*
+File:		OpenGL.cpp
+Author:		Keegan MacDonald (keeganm742@gmail.com)
+Created:	2026.10.17@21:10
+Purpose:	Implement functions found in OpenGL.h
+*/
+
+#include "OpenGL.h"
+
+#include <GLFW/glfw3.h>
+#include <cstring>
+
+namespace ActiasFW {
+	// Implement OpenGL class functions
+
+	bool OpenGL::Load() {
+		if (glfwGetCurrentContext() == 0) {
+			return false;
+		}
+#ifdef _WIN32
+		return glewInit() == GLEW_OK;
+#else
+		return glGetString(GL_VERSION) != 0;
+#endif
+	}
+
+	bool OpenGL::IsVersionSupported(int major, int minor) {
+		GLint contextMajor = 0, contextMinor = 0;
+		glGetIntegerv(GL_MAJOR_VERSION, &contextMajor);
+		glGetIntegerv(GL_MINOR_VERSION, &contextMinor);
+		return contextMajor > major
+			|| (contextMajor == major && contextMinor >= minor);
+	}
+
+	bool OpenGL::IsExtensionSupported(const char* extension) {
+		GLint extensionCount = 0;
+		glGetIntegerv(GL_NUM_EXTENSIONS, &extensionCount);
+		for (GLint i = 0; i < extensionCount; i++) {
+			const GLubyte* name = glGetStringi(GL_EXTENSIONS, (GLuint)i);
+			if (name != 0 && std::strcmp((const char*)name, extension) == 0) {
+				return true;
+			}
+		}
+		return false;
+	}
+
+	bool OpenGL::EnableParallelShaderCompilation() {
+		// The KHR and ARB extensions share a signature, so whichever the
+		// driver provides is loaded through GLFW
+		const char* functions[] = { "glMaxShaderCompilerThreadsKHR",
+			"glMaxShaderCompilerThreadsARB", };
+		const char* extensions[] = { "GL_KHR_parallel_shader_compile",
+			"GL_ARB_parallel_shader_compile", };
+		for (unsigned int i = 0; i < 2; i++) {
+			if (!IsExtensionSupported(extensions[i])) {
+				continue;
+			}
+			PFNGLMAXSHADERCOMPILERTHREADSKHRPROC maxShaderCompilerThreads
+				= (PFNGLMAXSHADERCOMPILERTHREADSKHRPROC)glfwGetProcAddress(
+					functions[i]);
+			if (maxShaderCompilerThreads != 0) {
+				maxShaderCompilerThreads(0xFFFFFFFF);
+				return true;
+			}
+		}
+		return false;
+	}
+}
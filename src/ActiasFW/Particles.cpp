@@ -0,0 +1,562 @@
+/*
+File:		Particles.cpp
+Author:		Keegan MacDonald (keeganm742@gmail.com)
+Created:	2026.10.17@18:40
+Purpose:	Implement functions found in Particles.h
+*/
+
+#include "ActiasFW.h"
+
+#include <algorithm>
+#include <limits>
+
+namespace ActiasFW {
+	// Implement ParticleSystem class functions
+
+	bool ParticleSystem::initialize(size_t capacity, float depth,
+		const std::string& textureFileName, unsigned int frameCount,
+		GLSLShader& shader, Simulation simulation) {
+		if (shader.isInstanced()) {
+			ACTIASFW_LOG(Graphics, Error, "Particle systems cannot be drawn ",
+				"with an instanced shader");
+			return false;
+		}
+		if (simulation == SIMULATION_GPU
+			&& !Application::Graphics.isComputeAvailable()) {
+			ACTIASFW_LOG(Graphics, Warning, "Compute shaders unavailable, ",
+				"simulating particles on the CPU");
+			simulation = SIMULATION_CPU;
+		}
+		if (simulation == SIMULATION_GPU && shader.getVertexAttributeStride()
+			!= Sprite::VertexSize * sizeof(float)) {
+			ACTIASFW_LOG(Graphics, Error, "Particles simulated on the GPU ",
+				"must be drawn with the default vertex layout");
+			return false;
+		}
+		clear();
+		m_simulation = simulation;
+		m_capacity = capacity;
+		m_depth = depth;
+		m_textureFileName = textureFileName;
+		m_frameCount = std::max(frameCount, 1u);
+		m_shader = &shader;
+		if (m_simulation == SIMULATION_GPU) {
+			destroyBuffers();
+			m_spawns.reserve(capacity * StateSize);
+			initializeBuffers();
+			return true;
+		}
+		// Every array is allocated once so spawning never reallocates
+		m_particles.reserve(capacity);
+		m_velocityX.reserve(capacity);
+		m_velocityY.reserve(capacity);
+		m_age.reserve(capacity);
+		m_lifeTime.reserve(capacity);
+		m_swayTimer.reserve(capacity);
+		return true;
+	}
+
+	unsigned int ParticleSystem::addEmitter(const ParticleEmitter& emitter) {
+		m_emitters.push_back(emitter);
+		m_spawnRemainders.push_back(0.0f);
+		return (unsigned int)(m_emitters.size() - 1);
+	}
+
+	ParticleEmitter& ParticleSystem::getEmitter(unsigned int index) {
+		return m_emitters.at(index);
+	}
+
+	void ParticleSystem::emit(unsigned int index, size_t count) {
+		for (size_t p = 0; p < count; p++) {
+			spawn(m_emitters.at(index));
+		}
+	}
+
+	void ParticleSystem::update(float timeStep) {
+		if (m_simulation == SIMULATION_CPU) {
+			simulateCPU(timeStep);
+		}
+		for (size_t e = 0; e < m_emitters.size(); e++) {
+			if (!m_emitters.at(e).enabled) {
+				continue;
+			}
+			m_spawnRemainders[e] += m_emitters.at(e).rate * timeStep;
+			while (m_spawnRemainders.at(e) >= 1.0f) {
+				m_spawnRemainders[e] -= 1.0f;
+				spawn(m_emitters.at(e));
+			}
+		}
+		// The particles spawned for the GPU are appended after the live
+		// particles are moved, as they are on the CPU
+		if (m_simulation == SIMULATION_GPU) {
+			simulateGPU(timeStep);
+		}
+	}
+
+	void ParticleSystem::clear() {
+		m_particles.clear();
+		m_velocityX.clear();
+		m_velocityY.clear();
+		m_age.clear();
+		m_lifeTime.clear();
+		m_swayTimer.clear();
+		std::fill(m_spawnRemainders.begin(), m_spawnRemainders.end(), 0.0f);
+		m_spawns.clear();
+		m_count = 0;
+		if (m_countBufferID != 0) {
+			const GLuint counts[2] = { 0, 0, };
+			glBindBuffer(GL_SHADER_STORAGE_BUFFER, m_countBufferID);
+			glBufferSubData(GL_SHADER_STORAGE_BUFFER, 0, sizeof(counts),
+				counts);
+		}
+	}
+
+	bool ParticleSystem::destroy() {
+		if (m_shader == 0) {
+			return false;
+		}
+		clear();
+		destroyBuffers();
+		m_simulation = SIMULATION_CPU;
+		m_capacity = 0;
+		m_depth = 0.0f;
+		m_textureFileName = "";
+		m_frameCount = 1;
+		m_shader = 0;
+		m_emitters.clear();
+		m_spawnRemainders.clear();
+		m_acceleration = glm::vec2();
+		m_swayTime = 0.0f;
+		m_startColor = glm::vec4(1.0f, 1.0f, 1.0f, 1.0f);
+		m_endColor = glm::vec4(1.0f, 1.0f, 1.0f, 1.0f);
+		return true;
+	}
+
+	const glm::vec2& ParticleSystem::getAcceleration() const {
+		return m_acceleration;
+	}
+
+	void ParticleSystem::setAcceleration(const glm::vec2& acceleration) {
+		m_acceleration = acceleration;
+	}
+
+	float ParticleSystem::getSwayTime() const {
+		return m_swayTime;
+	}
+
+	void ParticleSystem::setSwayTime(float swayTime) {
+		m_swayTime = swayTime;
+	}
+
+	void ParticleSystem::setColors(const glm::vec4& startColor,
+		const glm::vec4& endColor) {
+		m_startColor = startColor;
+		m_endColor = endColor;
+	}
+
+	void ParticleSystem::setSeed(std::uint32_t seed) {
+		m_random = seed != 0 ? seed : 2463534242u;
+	}
+
+	ParticleSystem::Simulation ParticleSystem::getSimulation() const {
+		return m_simulation;
+	}
+
+	const QuadBatch& ParticleSystem::getParticles() const {
+		return m_particles;
+	}
+
+	size_t ParticleSystem::getCount() const {
+		if (m_simulation == SIMULATION_GPU) {
+			return m_count;
+		}
+		return m_particles.size();
+	}
+
+	size_t ParticleSystem::getCapacity() const {
+		return m_capacity;
+	}
+
+	float ParticleSystem::getDepth() const {
+		return m_depth;
+	}
+
+	const std::string& ParticleSystem::getTextureFileName() const {
+		return m_textureFileName;
+	}
+
+	GLSLShader& ParticleSystem::getShader() {
+		return *m_shader;
+	}
+
+	std::string ParticleSystem::GetSimulationShaderSource() {
+		return
+			"#version 430 core\n"
+			"layout (local_size_x = " + std::to_string(WorkGroupSize)
+			+ ") in;\n"
+			"struct Particle {\n"
+			"	vec2 position;\n"
+			"	vec2 velocity;\n"
+			"	float age;\n"
+			"	float lifeTime;\n"
+			"	float swayTimer;\n"
+			"	float size;\n"
+			"};\n"
+			"layout (std430, binding = 0) readonly buffer Source {\n"
+			"	Particle source[];\n"
+			"};\n"
+			"layout (std430, binding = 1) writeonly buffer Destination {\n"
+			"	Particle destination[];\n"
+			"};\n"
+			"layout (std430, binding = 2) buffer Counts {\n"
+			"	uint counts[2];\n"
+			"};\n"
+			"layout (location = 0) uniform uint sourceIndex;\n"
+			"layout (location = 1) uniform float timeStep;\n"
+			"layout (location = 2) uniform vec2 acceleration;\n"
+			"layout (location = 3) uniform float swayTime;\n"
+			"void main() {\n"
+			"	uint i = gl_GlobalInvocationID.x;\n"
+			"	if (i >= counts[sourceIndex]) {\n"
+			"		return;\n"
+			"	}\n"
+			"	Particle p = source[i];\n"
+			"	p.position += p.velocity * timeStep;\n"
+			"	p.velocity += acceleration * timeStep;\n"
+			"	p.age += timeStep;\n"
+			"	p.swayTimer += timeStep;\n"
+			"	if (p.swayTimer > swayTime) {\n"
+			"		p.velocity.x = -p.velocity.x;\n"
+			"		p.swayTimer = 0.0;\n"
+			"	}\n"
+			"	if (p.age < p.lifeTime) {\n"
+			"		uint index = atomicAdd(counts[1u - sourceIndex], 1u);\n"
+			"		destination[index] = p;\n"
+			"	}\n"
+			"}\n";
+	}
+
+	std::string ParticleSystem::GetEmissionShaderSource() {
+		return
+			"#version 430 core\n"
+			"layout (local_size_x = " + std::to_string(WorkGroupSize)
+			+ ") in;\n"
+			"struct Particle {\n"
+			"	vec2 position;\n"
+			"	vec2 velocity;\n"
+			"	float age;\n"
+			"	float lifeTime;\n"
+			"	float swayTimer;\n"
+			"	float size;\n"
+			"};\n"
+			"layout (std430, binding = 1) writeonly buffer Destination {\n"
+			"	Particle destination[];\n"
+			"};\n"
+			"layout (std430, binding = 2) buffer Counts {\n"
+			"	uint counts[2];\n"
+			"};\n"
+			"layout (std430, binding = 3) readonly buffer Spawns {\n"
+			"	Particle spawns[];\n"
+			"};\n"
+			"layout (location = 0) uniform uint destinationIndex;\n"
+			"layout (location = 1) uniform uint spawnCount;\n"
+			"layout (location = 2) uniform uint capacity;\n"
+			"void main() {\n"
+			"	uint i = gl_GlobalInvocationID.x;\n"
+			"	if (i >= spawnCount) {\n"
+			"		return;\n"
+			"	}\n"
+			// Every invocation past the capacity clamps the count after its
+			// increment, so the last operation leaves it at the capacity
+			"	uint index = atomicAdd(counts[destinationIndex], 1u);\n"
+			"	if (index >= capacity) {\n"
+			"		atomicMin(counts[destinationIndex], capacity);\n"
+			"		return;\n"
+			"	}\n"
+			"	destination[index] = spawns[i];\n"
+			"}\n";
+	}
+
+	std::string ParticleSystem::GetExpansionShaderSource() {
+		return
+			"#version 430 core\n"
+			"layout (local_size_x = " + std::to_string(WorkGroupSize)
+			+ ") in;\n"
+			"struct Particle {\n"
+			"	vec2 position;\n"
+			"	vec2 velocity;\n"
+			"	float age;\n"
+			"	float lifeTime;\n"
+			"	float swayTimer;\n"
+			"	float size;\n"
+			"};\n"
+			"layout (std430, binding = 0) readonly buffer Source {\n"
+			"	Particle source[];\n"
+			"};\n"
+			"layout (std430, binding = 2) readonly buffer Counts {\n"
+			"	uint counts[2];\n"
+			"};\n"
+			"layout (std430, binding = 4) writeonly buffer Vertices {\n"
+			"	float vertices[];\n"
+			"};\n"
+			"layout (std430, binding = 5) writeonly buffer Command {\n"
+			"	uint command[4];\n"
+			"};\n"
+			"layout (location = 0) uniform uint sourceIndex;\n"
+			"layout (location = 1) uniform float depth;\n"
+			"layout (location = 2) uniform float frames;\n"
+			"layout (location = 3) uniform vec4 startColor;\n"
+			"layout (location = 4) uniform vec4 endColor;\n"
+			"layout (location = 5) uniform vec4 textureBox;\n"
+			"layout (location = 6) uniform float mode;\n"
+			"const uint indices[6] = uint[6](0u, 2u, 1u, 1u, 2u, 3u);\n"
+			"void main() {\n"
+			"	uint i = gl_GlobalInvocationID.x;\n"
+			"	uint count = counts[sourceIndex];\n"
+			"	if (i == 0u) {\n"
+			"		command[0] = count * 6u;\n"
+			"	}\n"
+			"	if (i >= count) {\n"
+			"		return;\n"
+			"	}\n"
+			"	Particle p = source[i];\n"
+			"	float life = min(p.age / p.lifeTime, 1.0);\n"
+			"	float frame = min(floor(life * frames), frames - 1.0);\n"
+			"	vec4 color = mix(startColor, endColor, life);\n"
+			// Corners are written in the quad kernel's order, two triangles
+			// of three vertices each since no index buffer is used
+			"	for (uint v = 0u; v < 6u; v++) {\n"
+			"		uint c = indices[v];\n"
+			"		vec2 corner = vec2(float(c & 1u), float(c >> 1u));\n"
+			"		uint o = (i * 6u + v) * 10u;\n"
+			"		vertices[o] = p.position.x + corner.x * p.size;\n"
+			"		vertices[o + 1u] = p.position.y + corner.y * p.size;\n"
+			"		vertices[o + 2u] = depth;\n"
+			"		vertices[o + 3u] = textureBox.x\n"
+			"			+ (frame + corner.x) / frames * textureBox.z;\n"
+			"		vertices[o + 4u] = textureBox.y\n"
+			"			+ (1.0 - corner.y) * textureBox.w;\n"
+			"		vertices[o + 5u] = color.r;\n"
+			"		vertices[o + 6u] = color.g;\n"
+			"		vertices[o + 7u] = color.b;\n"
+			"		vertices[o + 8u] = color.a;\n"
+			"		vertices[o + 9u] = mode;\n"
+			"	}\n"
+			"}\n";
+	}
+
+	void ParticleSystem::initializeBuffers() {
+		GLStateCache& state = Application::Graphics.getStateCache();
+		GLsizeiptr stateBytes = (GLsizeiptr)(m_capacity * StateSize
+			* sizeof(float));
+		glGenBuffers(2, m_stateBufferIDs);
+		glGenBuffers(1, &m_countBufferID);
+		glGenBuffers(1, &m_spawnBufferID);
+		glGenBuffers(1, &m_vertexBufferID);
+		glGenBuffers(1, &m_commandBufferID);
+		glGenVertexArrays(1, &m_VAOID);
+		for (GLuint b = 0; b < 2; b++) {
+			glBindBuffer(GL_SHADER_STORAGE_BUFFER, m_stateBufferIDs[b]);
+			glBufferData(GL_SHADER_STORAGE_BUFFER, stateBytes, 0,
+				GL_DYNAMIC_COPY);
+		}
+		const GLuint counts[2] = { 0, 0, };
+		glBindBuffer(GL_SHADER_STORAGE_BUFFER, m_countBufferID);
+		glBufferData(GL_SHADER_STORAGE_BUFFER, sizeof(counts), counts,
+			GL_DYNAMIC_COPY);
+		glBindBuffer(GL_SHADER_STORAGE_BUFFER, m_spawnBufferID);
+		glBufferData(GL_SHADER_STORAGE_BUFFER, stateBytes, 0,
+			GL_STREAM_DRAW);
+		// The vertex count is written by the expansion shader before each
+		// draw
+		const GLuint command[4] = { 0, 1, 0, 0, };
+		state.bindBuffer(GL_DRAW_INDIRECT_BUFFER, m_commandBufferID);
+		glBufferData(GL_DRAW_INDIRECT_BUFFER, sizeof(command), command,
+			GL_DYNAMIC_COPY);
+		state.bindVertexArray(m_VAOID);
+		state.bindBuffer(GL_ARRAY_BUFFER, m_vertexBufferID);
+		glBufferData(GL_ARRAY_BUFFER, (GLsizeiptr)(m_capacity * 6
+			* Sprite::VertexSize * sizeof(float)), 0, GL_DYNAMIC_COPY);
+		m_shader->bindVertexAttributes();
+		m_source = 0;
+	}
+
+	void ParticleSystem::destroyBuffers() {
+		if (m_VAOID == 0) {
+			return;
+		}
+		glDeleteBuffers(2, m_stateBufferIDs);
+		glDeleteBuffers(1, &m_countBufferID);
+		glDeleteBuffers(1, &m_spawnBufferID);
+		glDeleteBuffers(1, &m_vertexBufferID);
+		glDeleteBuffers(1, &m_commandBufferID);
+		glDeleteVertexArrays(1, &m_VAOID);
+		// Deleting bound objects unbinds them
+		Application::Graphics.getStateCache().invalidate();
+		m_stateBufferIDs[0] = 0;
+		m_stateBufferIDs[1] = 0;
+		m_countBufferID = 0;
+		m_spawnBufferID = 0;
+		m_vertexBufferID = 0;
+		m_commandBufferID = 0;
+		m_VAOID = 0;
+		m_spawns.clear();
+		m_count = 0;
+	}
+
+	void ParticleSystem::simulateCPU(float timeStep) {
+		size_t count = m_particles.size();
+		float* x = m_particles.x.data();
+		float* y = m_particles.y.data();
+		float* textureX = m_particles.textureBox[0].data();
+		float* vx = m_velocityX.data();
+		float* vy = m_velocityY.data();
+		float* age = m_age.data();
+		const float* lifeTime = m_lifeTime.data();
+		float* swayTimer = m_swayTimer.data();
+		glm::vec2 dv = m_acceleration * timeStep;
+		float sway = m_swayTime > 0.0f ? m_swayTime
+			: std::numeric_limits<float>::max();
+		float frames = (float)m_frameCount;
+		// Each loop touches only a few arrays with no branches, so they are
+		// vectorized across several particles at once
+		for (size_t i = 0; i < count; i++) {
+			x[i] += vx[i] * timeStep;
+			y[i] += vy[i] * timeStep;
+			vx[i] += dv.x;
+			vy[i] += dv.y;
+			age[i] += timeStep;
+		}
+		for (size_t i = 0; i < count; i++) {
+			swayTimer[i] += timeStep;
+			bool reverse = swayTimer[i] > sway;
+			vx[i] = reverse ? -vx[i] : vx[i];
+			swayTimer[i] = reverse ? 0.0f : swayTimer[i];
+		}
+		for (size_t i = 0; i < count; i++) {
+			float frame = (float)(int)(age[i] / lifeTime[i] * frames);
+			textureX[i] = std::min(frame, frames - 1.0f) / frames;
+		}
+		if (m_startColor != m_endColor) {
+			for (int c = 0; c < 4; c++) {
+				float* color = m_particles.color[c].data();
+				float start = m_startColor[c];
+				float range = m_endColor[c] - m_startColor[c];
+				for (size_t i = 0; i < count; i++) {
+					color[i] = start + range * std::min(age[i] / lifeTime[i],
+						1.0f);
+				}
+			}
+		}
+		size_t i = 0;
+		while (i < m_particles.size()) {
+			if (m_age.at(i) >= m_lifeTime.at(i)) {
+				remove(i);
+			}
+			else {
+				i++;
+			}
+		}
+	}
+
+	void ParticleSystem::simulateGPU(float timeStep) {
+		GraphicsManager& graphics = Application::Graphics;
+		GLuint destination = 1 - m_source;
+		GLuint spawnCount = (GLuint)(m_spawns.size() / StateSize);
+		// Only the count of the buffer receiving the survivors is reset, the
+		// CPU never reads either count back
+		const GLuint zero = 0;
+		glBindBuffer(GL_SHADER_STORAGE_BUFFER, m_countBufferID);
+		glBufferSubData(GL_SHADER_STORAGE_BUFFER,
+			destination * sizeof(GLuint), sizeof(GLuint), &zero);
+		if (spawnCount > 0) {
+			glBindBuffer(GL_SHADER_STORAGE_BUFFER, m_spawnBufferID);
+			glBufferSubData(GL_SHADER_STORAGE_BUFFER, 0,
+				(GLsizeiptr)(m_spawns.size() * sizeof(float)),
+				m_spawns.data());
+		}
+		glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 0,
+			m_stateBufferIDs[m_source]);
+		glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 1,
+			m_stateBufferIDs[destination]);
+		glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 2, m_countBufferID);
+		glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 3, m_spawnBufferID);
+		if (m_count > 0) {
+			graphics.m_state.useProgram(graphics.m_particleSimulationProgram);
+			glUniform1ui(0, m_source);
+			glUniform1f(1, timeStep);
+			glUniform2f(2, m_acceleration.x, m_acceleration.y);
+			glUniform1f(3, m_swayTime > 0.0f ? m_swayTime
+				: std::numeric_limits<float>::max());
+			glDispatchCompute((GLuint)((m_count + WorkGroupSize - 1)
+				/ WorkGroupSize), 1, 1);
+			glMemoryBarrier(GL_SHADER_STORAGE_BARRIER_BIT);
+		}
+		if (spawnCount > 0) {
+			graphics.m_state.useProgram(graphics.m_particleEmissionProgram);
+			glUniform1ui(0, destination);
+			glUniform1ui(1, spawnCount);
+			glUniform1ui(2, (GLuint)m_capacity);
+			glDispatchCompute((spawnCount + (GLuint)WorkGroupSize - 1)
+				/ (GLuint)WorkGroupSize, 1, 1);
+		}
+		glMemoryBarrier(GL_SHADER_STORAGE_BARRIER_BIT
+			| GL_BUFFER_UPDATE_BARRIER_BIT);
+		m_source = destination;
+		m_count = std::min(m_capacity, m_count + spawnCount);
+		m_spawns.clear();
+	}
+
+	void ParticleSystem::spawn(const ParticleEmitter& emitter) {
+		size_t count = m_simulation == SIMULATION_GPU
+			? m_spawns.size() / StateSize : m_particles.size();
+		if (count >= m_capacity) {
+			return;
+		}
+		float size = random(emitter.size.x, emitter.size.y);
+		glm::vec2 position(
+			random(emitter.area.x, emitter.area.x + emitter.area.z),
+			random(emitter.area.y, emitter.area.y + emitter.area.w));
+		glm::vec2 velocity(
+			random(emitter.minimumVelocity.x, emitter.maximumVelocity.x),
+			random(emitter.minimumVelocity.y, emitter.maximumVelocity.y));
+		float lifeTime = std::max(random(emitter.lifeTime.x,
+			emitter.lifeTime.y), 1.0f);
+		if (m_simulation == SIMULATION_GPU) {
+			const float state[StateSize] = { position.x, position.y,
+				velocity.x, velocity.y, 0.0f, lifeTime, 0.0f, size, };
+			m_spawns.insert(m_spawns.end(), state, state + StateSize);
+			return;
+		}
+		m_particles.add(glm::vec3(position, m_depth), glm::vec2(size, size),
+			0.0f, glm::vec4(0.0f, 0.0f, 1.0f / (float)m_frameCount, 1.0f),
+			m_startColor, (float)m_textureFileName.empty(), false, false);
+		m_velocityX.push_back(velocity.x);
+		m_velocityY.push_back(velocity.y);
+		m_age.push_back(0.0f);
+		m_lifeTime.push_back(lifeTime);
+		m_swayTimer.push_back(0.0f);
+	}
+
+	void ParticleSystem::remove(size_t index) {
+		m_particles.remove(index);
+		m_velocityX[index] = m_velocityX.back();
+		m_velocityX.pop_back();
+		m_velocityY[index] = m_velocityY.back();
+		m_velocityY.pop_back();
+		m_age[index] = m_age.back();
+		m_age.pop_back();
+		m_lifeTime[index] = m_lifeTime.back();
+		m_lifeTime.pop_back();
+		m_swayTimer[index] = m_swayTimer.back();
+		m_swayTimer.pop_back();
+	}
+
+	float ParticleSystem::random(float minimum, float maximum) {
+		m_random ^= m_random << 13;
+		m_random ^= m_random >> 17;
+		m_random ^= m_random << 5;
+		return minimum + (maximum - minimum)
+			* ((float)(m_random >> 8) / (float)(1u << 24));
+	}
+}
@@ -0,0 +1,575 @@
+/*
+File:		QuadKernel.cpp
+Author:		Keegan MacDonald (keeganm742@gmail.com)
+Created:	2026.10.17@11:40
+Purpose:	Implement functions found in QuadKernel.h
+*/
+
+#include "QuadKernel.h"
+
+#include <cmath>
+#include <utility>
+
+#if defined(_M_X64) || defined(_M_IX86) || defined(__x86_64__) \
+	|| defined(__i386__)
+#define ACTIASFW_QUAD_KERNEL_X86
+#include <immintrin.h>
+#ifdef _MSC_VER
+#include <intrin.h>
+#define ACTIASFW_TARGET_AVX2
+#else
+#define ACTIASFW_TARGET_AVX2 __attribute__((target("avx2")))
+#endif
+#endif
+
+namespace ActiasFW {
+	// The number of radians in a degree
+	const float RadiansPerDegree = 3.14159265358979f / 180.0f;
+
+#ifdef ACTIASFW_QUAD_KERNEL_X86
+	/*
+	Compute the sine and cosine of four angles within two turns of zero with a
+	polynomial after reducing them to a quarter turn
+	Parameter: __m128 a - The angles in radians
+	Parameter: __m128& s - The sines of the angles
+	Parameter: __m128& c - The cosines of the angles
+	*/
+	inline void SinCos(__m128 a, __m128& s, __m128& c) {
+		__m128i q = _mm_cvtps_epi32(_mm_mul_ps(a,
+			_mm_set1_ps(0.636619772f)));
+		__m128 qf = _mm_cvtepi32_ps(q);
+		__m128 r = _mm_sub_ps(a, _mm_mul_ps(qf, _mm_set1_ps(1.5703125f)));
+		r = _mm_sub_ps(r, _mm_mul_ps(qf, _mm_set1_ps(4.837512969970703e-4f)));
+		r = _mm_sub_ps(r, _mm_mul_ps(qf, _mm_set1_ps(7.549789954891882e-8f)));
+		__m128 r2 = _mm_mul_ps(r, r);
+		__m128 ps = _mm_add_ps(_mm_mul_ps(_mm_set1_ps(-1.9515295891e-4f), r2),
+			_mm_set1_ps(8.3321608736e-3f));
+		ps = _mm_add_ps(_mm_mul_ps(ps, r2), _mm_set1_ps(-1.6666654611e-1f));
+		ps = _mm_add_ps(_mm_mul_ps(_mm_mul_ps(ps, r2), r), r);
+		__m128 pc = _mm_add_ps(_mm_mul_ps(_mm_set1_ps(2.443315711809948e-5f),
+			r2), _mm_set1_ps(-1.388731625493765e-3f));
+		pc = _mm_add_ps(_mm_mul_ps(pc, r2), _mm_set1_ps(4.166664568298827e-2f));
+		pc = _mm_add_ps(_mm_mul_ps(_mm_mul_ps(pc, r2), r2),
+			_mm_sub_ps(_mm_set1_ps(1.0f), _mm_mul_ps(r2, _mm_set1_ps(0.5f))));
+		// Odd quadrants swap sine and cosine, the sign bits follow the quadrant
+		__m128 swap = _mm_castsi128_ps(_mm_cmpeq_epi32(
+			_mm_and_si128(q, _mm_set1_epi32(1)), _mm_set1_epi32(1)));
+		__m128 signS = _mm_castsi128_ps(_mm_slli_epi32(
+			_mm_and_si128(q, _mm_set1_epi32(2)), 30));
+		__m128 signC = _mm_castsi128_ps(_mm_slli_epi32(_mm_and_si128(
+			_mm_add_epi32(q, _mm_set1_epi32(1)), _mm_set1_epi32(2)), 30));
+		s = _mm_or_ps(_mm_and_ps(swap, pc), _mm_andnot_ps(swap, ps));
+		c = _mm_or_ps(_mm_and_ps(swap, ps), _mm_andnot_ps(swap, pc));
+		s = _mm_xor_ps(s, signS);
+		c = _mm_xor_ps(c, signC);
+	}
+
+	/*
+	Choose between two sets of four floats by a mask
+	Parameter: __m128 mask - The mask choosing lanes of b
+	Parameter: __m128 a - The values of lanes outside the mask
+	Parameter: __m128 b - The values of lanes inside the mask
+	Returns: __m128 - The chosen values
+	*/
+	inline __m128 Select(__m128 mask, __m128 a, __m128 b) {
+		return _mm_or_ps(_mm_and_ps(mask, b), _mm_andnot_ps(mask, a));
+	}
+
+	/*
+	Truncate four floats towards zero
+	Parameter: __m128 v - The values to truncate
+	Returns: __m128 - The truncated values
+	*/
+	inline __m128 Truncate(__m128 v) {
+		return _mm_cvtepi32_ps(_mm_cvttps_epi32(v));
+	}
+
+	/*
+	Transpose four floats of four sprites, each given in one set per
+	property, and store them into each sprite's vertices
+	Parameter: float* vertices - The vertices of the first sprite
+	Parameter: size_t offset - The index in each sprite's vertices of the
+	first float to store
+	Parameter: __m128 a - The first float of each sprite
+	Parameter: __m128 b - The second float of each sprite
+	Parameter: __m128 c - The third float of each sprite
+	Parameter: __m128 d - The fourth float of each sprite
+	*/
+	inline void StoreTransposed(float* vertices, size_t offset, __m128 a,
+		__m128 b, __m128 c, __m128 d) {
+		_MM_TRANSPOSE4_PS(a, b, c, d);
+		vertices += offset;
+		_mm_storeu_ps(vertices, a);
+		_mm_storeu_ps(vertices + QuadKernel::FloatsPerSprite, b);
+		_mm_storeu_ps(vertices + 2 * QuadKernel::FloatsPerSprite, c);
+		_mm_storeu_ps(vertices + 3 * QuadKernel::FloatsPerSprite, d);
+	}
+
+	/*
+	Compute the sine and cosine of eight angles within two turns of zero with a
+	polynomial after reducing them to a quarter turn
+	Parameter: __m256 a - The angles in radians
+	Parameter: __m256& s - The sines of the angles
+	Parameter: __m256& c - The cosines of the angles
+	*/
+	ACTIASFW_TARGET_AVX2 inline void SinCos(__m256 a, __m256& s, __m256& c) {
+		__m256i q = _mm256_cvtps_epi32(_mm256_mul_ps(a,
+			_mm256_set1_ps(0.636619772f)));
+		__m256 qf = _mm256_cvtepi32_ps(q);
+		__m256 r = _mm256_sub_ps(a, _mm256_mul_ps(qf,
+			_mm256_set1_ps(1.5703125f)));
+		r = _mm256_sub_ps(r, _mm256_mul_ps(qf,
+			_mm256_set1_ps(4.837512969970703e-4f)));
+		r = _mm256_sub_ps(r, _mm256_mul_ps(qf,
+			_mm256_set1_ps(7.549789954891882e-8f)));
+		__m256 r2 = _mm256_mul_ps(r, r);
+		__m256 ps = _mm256_add_ps(_mm256_mul_ps(
+			_mm256_set1_ps(-1.9515295891e-4f), r2),
+			_mm256_set1_ps(8.3321608736e-3f));
+		ps = _mm256_add_ps(_mm256_mul_ps(ps, r2),
+			_mm256_set1_ps(-1.6666654611e-1f));
+		ps = _mm256_add_ps(_mm256_mul_ps(_mm256_mul_ps(ps, r2), r), r);
+		__m256 pc = _mm256_add_ps(_mm256_mul_ps(
+			_mm256_set1_ps(2.443315711809948e-5f), r2),
+			_mm256_set1_ps(-1.388731625493765e-3f));
+		pc = _mm256_add_ps(_mm256_mul_ps(pc, r2),
+			_mm256_set1_ps(4.166664568298827e-2f));
+		pc = _mm256_add_ps(_mm256_mul_ps(_mm256_mul_ps(pc, r2), r2),
+			_mm256_sub_ps(_mm256_set1_ps(1.0f),
+				_mm256_mul_ps(r2, _mm256_set1_ps(0.5f))));
+		__m256 swap = _mm256_castsi256_ps(_mm256_cmpeq_epi32(
+			_mm256_and_si256(q, _mm256_set1_epi32(1)), _mm256_set1_epi32(1)));
+		__m256 signS = _mm256_castsi256_ps(_mm256_slli_epi32(
+			_mm256_and_si256(q, _mm256_set1_epi32(2)), 30));
+		__m256 signC = _mm256_castsi256_ps(_mm256_slli_epi32(_mm256_and_si256(
+			_mm256_add_epi32(q, _mm256_set1_epi32(1)), _mm256_set1_epi32(2)),
+			30));
+		s = _mm256_xor_ps(_mm256_blendv_ps(ps, pc, swap), signS);
+		c = _mm256_xor_ps(_mm256_blendv_ps(pc, ps, swap), signC);
+	}
+
+	/*
+	Transpose the four floats in each half of four sets of eight floats
+	Parameter: __m256& a - The first set
+	Parameter: __m256& b - The second set
+	Parameter: __m256& c - The third set
+	Parameter: __m256& d - The fourth set
+	*/
+	ACTIASFW_TARGET_AVX2 inline void Transpose(__m256& a, __m256& b,
+		__m256& c, __m256& d) {
+		__m256 ab0 = _mm256_unpacklo_ps(a, b);
+		__m256 cd0 = _mm256_unpacklo_ps(c, d);
+		__m256 ab1 = _mm256_unpackhi_ps(a, b);
+		__m256 cd1 = _mm256_unpackhi_ps(c, d);
+		a = _mm256_shuffle_ps(ab0, cd0, _MM_SHUFFLE(1, 0, 1, 0));
+		b = _mm256_shuffle_ps(ab0, cd0, _MM_SHUFFLE(3, 2, 3, 2));
+		c = _mm256_shuffle_ps(ab1, cd1, _MM_SHUFFLE(1, 0, 1, 0));
+		d = _mm256_shuffle_ps(ab1, cd1, _MM_SHUFFLE(3, 2, 3, 2));
+	}
+
+	/*
+	Transpose eight floats of eight sprites, each given in one set per
+	property, and store them into each sprite's vertices
+	Parameter: float* vertices - The vertices of the first sprite
+	Parameter: size_t offset - The index in each sprite's vertices of the
+	first float to store
+	Parameter: __m256 a - The first float of each sprite
+	Parameter: __m256 b - The second float of each sprite
+	Parameter: __m256 c - The third float of each sprite
+	Parameter: __m256 d - The fourth float of each sprite
+	Parameter: __m256 e - The fifth float of each sprite
+	Parameter: __m256 f - The sixth float of each sprite
+	Parameter: __m256 g - The seventh float of each sprite
+	Parameter: __m256 h - The eighth float of each sprite
+	*/
+	ACTIASFW_TARGET_AVX2 inline void StoreTransposed(float* vertices,
+		size_t offset, __m256 a, __m256 b, __m256 c, __m256 d, __m256 e,
+		__m256 f, __m256 g, __m256 h) {
+		// Each half of the transposed sets holds four floats of one sprite,
+		// the low halves of the first four sprites and the high halves of
+		// the last four
+		Transpose(a, b, c, d);
+		Transpose(e, f, g, h);
+		__m256 first[4] = { a, b, c, d, };
+		__m256 second[4] = { e, f, g, h, };
+		vertices += offset;
+		for (size_t l = 0; l < 4; l++) {
+			_mm256_storeu_ps(vertices + l * QuadKernel::FloatsPerSprite,
+				_mm256_permute2f128_ps(first[l], second[l], 0x20));
+			_mm256_storeu_ps(vertices + (l + 4) * QuadKernel::FloatsPerSprite,
+				_mm256_permute2f128_ps(first[l], second[l], 0x31));
+		}
+	}
+#endif
+
+	// Implement QuadBatch struct functions
+
+	void QuadBatch::add(const glm::vec3& position, const glm::vec2& dimensions,
+		float rotation, const glm::vec4& box, const glm::vec4& rgba,
+		float drawMode, bool horizontal, bool vertical) {
+		x.push_back(position.x);
+		y.push_back(position.y);
+		z.push_back(position.z);
+		width.push_back(dimensions.x);
+		height.push_back(dimensions.y);
+		this->rotation.push_back(rotation);
+		for (int i = 0; i < 4; i++) {
+			textureBox[i].push_back(box[i]);
+			color[i].push_back(rgba[i]);
+		}
+		mode.push_back(drawMode);
+		reflectedHorizontally.push_back(horizontal ? 1.0f : 0.0f);
+		reflectedVertically.push_back(vertical ? 1.0f : 0.0f);
+	}
+
+	void QuadBatch::reserve(size_t count) {
+		x.reserve(count);
+		y.reserve(count);
+		z.reserve(count);
+		width.reserve(count);
+		height.reserve(count);
+		rotation.reserve(count);
+		for (int i = 0; i < 4; i++) {
+			textureBox[i].reserve(count);
+			color[i].reserve(count);
+		}
+		mode.reserve(count);
+		reflectedHorizontally.reserve(count);
+		reflectedVertically.reserve(count);
+	}
+
+	void QuadBatch::remove(size_t index) {
+		std::vector<float>* arrays[] = { &x, &y, &z, &width, &height,
+			&rotation, &textureBox[0], &textureBox[1], &textureBox[2],
+			&textureBox[3], &color[0], &color[1], &color[2], &color[3], &mode,
+			&reflectedHorizontally, &reflectedVertically, };
+		for (std::vector<float>* array : arrays) {
+			(*array)[index] = array->back();
+			array->pop_back();
+		}
+	}
+
+	void QuadBatch::clear() {
+		x.clear();
+		y.clear();
+		z.clear();
+		width.clear();
+		height.clear();
+		rotation.clear();
+		for (int i = 0; i < 4; i++) {
+			textureBox[i].clear();
+			color[i].clear();
+		}
+		mode.clear();
+		reflectedHorizontally.clear();
+		reflectedVertically.clear();
+	}
+
+	size_t QuadBatch::size() const {
+		return x.size();
+	}
+
+	// Implement QuadKernel class functions
+
+	const unsigned int QuadKernel::Indices[6] = { 0, 2, 1, 1, 2, 3, };
+
+	QuadKernel::Path QuadKernel::GetPath() {
+		static const Path path = IsSupported(PATH_AVX2) ? PATH_AVX2
+			: IsSupported(PATH_SSE) ? PATH_SSE : PATH_SCALAR;
+		return path;
+	}
+
+	bool QuadKernel::IsSupported(Path path) {
+		if (path == PATH_SCALAR) {
+			return true;
+		}
+#ifdef ACTIASFW_QUAD_KERNEL_X86
+		static const bool sse2 = IsSupportedByCPU(PATH_SSE);
+		static const bool avx2 = IsSupportedByCPU(PATH_AVX2);
+		return path == PATH_SSE ? sse2 : avx2;
+#else
+		return false;
+#endif
+	}
+
+	bool QuadKernel::IsSupportedByCPU(Path path) {
+#ifdef ACTIASFW_QUAD_KERNEL_X86
+#ifdef _MSC_VER
+		int info[4] = {};
+		__cpuid(info, 1);
+		bool sse2 = (info[3] & (1 << 26)) != 0;
+		bool avx = (info[2] & (1 << 27)) != 0 && (info[2] & (1 << 28)) != 0
+			&& (_xgetbv(0) & 6) == 6;
+		__cpuidex(info, 7, 0);
+		bool avx2 = avx && (info[1] & (1 << 5)) != 0;
+#else
+		__builtin_cpu_init();
+		bool sse2 = __builtin_cpu_supports("sse2");
+		bool avx2 = __builtin_cpu_supports("avx2");
+#endif
+		return path == PATH_SSE ? sse2 : avx2;
+#else
+		return false;
+#endif
+	}
+
+	void QuadKernel::Expand(const QuadBatch& batch, size_t first, size_t last,
+		float* vertices) {
+		Expand(batch, first, last, vertices, GetPath());
+	}
+
+	void QuadKernel::Expand(const QuadBatch& batch, size_t first, size_t last,
+		float* vertices, Path path) {
+		if (!IsSupported(path)) {
+			path = PATH_SCALAR;
+		}
+		if (path == PATH_AVX2) {
+			ExpandAVX2(batch, first, last, vertices);
+		}
+		else if (path == PATH_SSE) {
+			ExpandSSE(batch, first, last, vertices);
+		}
+		else {
+			ExpandScalar(batch, first, last, vertices);
+		}
+	}
+
+	void QuadKernel::ExpandOne(const glm::vec3& position,
+		const glm::vec2& dimensions, float rotation, const glm::vec4& box,
+		const glm::vec4& color, float mode, bool reflectedHorizontally,
+		bool reflectedVertically, float* vertices) {
+		float x[4] = { position.x, position.x + dimensions.x,
+			position.x, position.x + dimensions.x, };
+		float y[4] = { position.y, position.y,
+			position.y + dimensions.y, position.y + dimensions.y, };
+		if ((int)rotation % 360 != 0) {
+			float a = RadiansPerDegree * rotation;
+			float s = std::sin(a);
+			float c = std::cos(a);
+			glm::vec2 h = dimensions / 2.0f;
+			glm::vec2 center = glm::vec2(position.x, position.y) + h;
+			x[0] = center.x - c * h.x + s * h.y;
+			y[0] = center.y - s * h.x - c * h.y;
+			x[1] = center.x + c * h.x + s * h.y;
+			y[1] = center.y + s * h.x - c * h.y;
+			x[2] = center.x - c * h.x - s * h.y;
+			y[2] = center.y - s * h.x + c * h.y;
+			x[3] = center.x + c * h.x - s * h.y;
+			y[3] = center.y + s * h.x + c * h.y;
+		}
+		float uv[4] = { box.x, box.x + box.z, box.y + box.w, box.y, };
+		if (reflectedHorizontally) {
+			std::swap(uv[0], uv[1]);
+		}
+		if (reflectedVertically) {
+			std::swap(uv[2], uv[3]);
+		}
+		WriteQuad(vertices, x, y, position.z, uv, color, mode);
+	}
+
+	void QuadKernel::WriteQuad(float* vertices, const float* x, const float* y,
+		float z, const float* uv, const glm::vec4& color, float mode) {
+		for (int v = 0; v < 4; v++) {
+			float* vertex = vertices + v * 10;
+			vertex[0] = x[v];
+			vertex[1] = y[v];
+			vertex[2] = z;
+			vertex[3] = uv[v & 1];
+			vertex[4] = uv[2 + (v >> 1)];
+			vertex[5] = color.r;
+			vertex[6] = color.g;
+			vertex[7] = color.b;
+			vertex[8] = color.a;
+			vertex[9] = mode;
+		}
+	}
+
+	void QuadKernel::ExpandScalar(const QuadBatch& batch, size_t first,
+		size_t last, float* vertices) {
+		for (size_t i = first; i < last; i++) {
+			ExpandOne(glm::vec3(batch.x[i], batch.y[i], batch.z[i]),
+				glm::vec2(batch.width[i], batch.height[i]), batch.rotation[i],
+				glm::vec4(batch.textureBox[0][i], batch.textureBox[1][i],
+					batch.textureBox[2][i], batch.textureBox[3][i]),
+				glm::vec4(batch.color[0][i], batch.color[1][i],
+					batch.color[2][i], batch.color[3][i]),
+				batch.mode[i], batch.reflectedHorizontally[i] != 0.0f,
+				batch.reflectedVertically[i] != 0.0f, vertices);
+			vertices += FloatsPerSprite;
+		}
+	}
+
+	void QuadKernel::ExpandSSE(const QuadBatch& batch, size_t first,
+		size_t last, float* vertices) {
+#ifdef ACTIASFW_QUAD_KERNEL_X86
+		size_t i = first;
+		for (; i + 4 <= last; i += 4) {
+			__m128 x = _mm_loadu_ps(&batch.x[i]);
+			__m128 y = _mm_loadu_ps(&batch.y[i]);
+			__m128 w = _mm_loadu_ps(&batch.width[i]);
+			__m128 h = _mm_loadu_ps(&batch.height[i]);
+			__m128 rotation = _mm_loadu_ps(&batch.rotation[i]);
+			__m128 turns = _mm_set1_ps(360.0f);
+			__m128 degrees = Truncate(rotation);
+			__m128 rotated = _mm_cmpneq_ps(_mm_sub_ps(degrees, _mm_mul_ps(turns,
+				Truncate(_mm_div_ps(degrees, turns)))), _mm_setzero_ps());
+			__m128 angle = _mm_mul_ps(_mm_sub_ps(rotation, _mm_mul_ps(turns,
+				Truncate(_mm_div_ps(rotation, turns)))),
+				_mm_set1_ps(RadiansPerDegree));
+			__m128 s, c;
+			SinCos(angle, s, c);
+			__m128 hx = _mm_mul_ps(w, _mm_set1_ps(0.5f));
+			__m128 hy = _mm_mul_ps(h, _mm_set1_ps(0.5f));
+			__m128 cx = _mm_add_ps(x, hx);
+			__m128 cy = _mm_add_ps(y, hy);
+			__m128 chx = _mm_mul_ps(c, hx);
+			__m128 shx = _mm_mul_ps(s, hx);
+			__m128 chy = _mm_mul_ps(c, hy);
+			__m128 shy = _mm_mul_ps(s, hy);
+			__m128 right = _mm_add_ps(x, w);
+			__m128 top = _mm_add_ps(y, h);
+			__m128 x0 = Select(rotated, x,
+				_mm_add_ps(_mm_sub_ps(cx, chx), shy));
+			__m128 x1 = Select(rotated, right,
+				_mm_add_ps(_mm_add_ps(cx, chx), shy));
+			__m128 x2 = Select(rotated, x,
+				_mm_sub_ps(_mm_sub_ps(cx, chx), shy));
+			__m128 x3 = Select(rotated, right,
+				_mm_sub_ps(_mm_add_ps(cx, chx), shy));
+			__m128 y0 = Select(rotated, y,
+				_mm_sub_ps(_mm_sub_ps(cy, shx), chy));
+			__m128 y1 = Select(rotated, y,
+				_mm_sub_ps(_mm_add_ps(cy, shx), chy));
+			__m128 y2 = Select(rotated, top,
+				_mm_add_ps(_mm_sub_ps(cy, shx), chy));
+			__m128 y3 = Select(rotated, top,
+				_mm_add_ps(_mm_add_ps(cy, shx), chy));
+			__m128 u0 = _mm_loadu_ps(&batch.textureBox[0][i]);
+			__m128 vTop = _mm_loadu_ps(&batch.textureBox[1][i]);
+			__m128 u1 = _mm_add_ps(u0, _mm_loadu_ps(&batch.textureBox[2][i]));
+			__m128 vBottom = _mm_add_ps(vTop,
+				_mm_loadu_ps(&batch.textureBox[3][i]));
+			__m128 horizontal = _mm_cmpneq_ps(
+				_mm_loadu_ps(&batch.reflectedHorizontally[i]), _mm_setzero_ps());
+			__m128 vertical = _mm_cmpneq_ps(
+				_mm_loadu_ps(&batch.reflectedVertically[i]), _mm_setzero_ps());
+			__m128 left = Select(horizontal, u0, u1);
+			__m128 rightU = Select(horizontal, u1, u0);
+			__m128 bottom = Select(vertical, vBottom, vTop);
+			__m128 topV = Select(vertical, vTop, vBottom);
+			__m128 z = _mm_loadu_ps(&batch.z[i]);
+			__m128 r = _mm_loadu_ps(&batch.color[0][i]);
+			__m128 g = _mm_loadu_ps(&batch.color[1][i]);
+			__m128 b = _mm_loadu_ps(&batch.color[2][i]);
+			__m128 a = _mm_loadu_ps(&batch.color[3][i]);
+			__m128 mode = _mm_loadu_ps(&batch.mode[i]);
+			// Each sprite's four vertices are ten sets of four floats, which
+			// are transposed out of the sprites' properties and stored whole
+			StoreTransposed(vertices, 0, x0, y0, z, left);
+			StoreTransposed(vertices, 4, bottom, r, g, b);
+			StoreTransposed(vertices, 8, a, mode, x1, y1);
+			StoreTransposed(vertices, 12, z, rightU, bottom, r);
+			StoreTransposed(vertices, 16, g, b, a, mode);
+			StoreTransposed(vertices, 20, x2, y2, z, left);
+			StoreTransposed(vertices, 24, topV, r, g, b);
+			StoreTransposed(vertices, 28, a, mode, x3, y3);
+			StoreTransposed(vertices, 32, z, rightU, topV, r);
+			StoreTransposed(vertices, 36, g, b, a, mode);
+			vertices += 4 * FloatsPerSprite;
+		}
+		ExpandScalar(batch, i, last, vertices);
+#else
+		ExpandScalar(batch, first, last, vertices);
+#endif
+	}
+
+#ifdef ACTIASFW_QUAD_KERNEL_X86
+	ACTIASFW_TARGET_AVX2
+#endif
+	void QuadKernel::ExpandAVX2(const QuadBatch& batch, size_t first,
+		size_t last, float* vertices) {
+#ifdef ACTIASFW_QUAD_KERNEL_X86
+		size_t i = first;
+		for (; i + 8 <= last; i += 8) {
+			__m256 x = _mm256_loadu_ps(&batch.x[i]);
+			__m256 y = _mm256_loadu_ps(&batch.y[i]);
+			__m256 w = _mm256_loadu_ps(&batch.width[i]);
+			__m256 h = _mm256_loadu_ps(&batch.height[i]);
+			__m256 rotation = _mm256_loadu_ps(&batch.rotation[i]);
+			__m256 turns = _mm256_set1_ps(360.0f);
+			__m256 degrees = _mm256_round_ps(rotation,
+				_MM_FROUND_TO_ZERO | _MM_FROUND_NO_EXC);
+			__m256 rotated = _mm256_cmp_ps(_mm256_sub_ps(degrees,
+				_mm256_mul_ps(turns, _mm256_round_ps(_mm256_div_ps(degrees,
+					turns), _MM_FROUND_TO_ZERO | _MM_FROUND_NO_EXC))),
+				_mm256_setzero_ps(), _CMP_NEQ_UQ);
+			__m256 angle = _mm256_mul_ps(_mm256_sub_ps(rotation,
+				_mm256_mul_ps(turns, _mm256_round_ps(_mm256_div_ps(rotation,
+					turns), _MM_FROUND_TO_ZERO | _MM_FROUND_NO_EXC))),
+				_mm256_set1_ps(RadiansPerDegree));
+			__m256 s, c;
+			SinCos(angle, s, c);
+			__m256 hx = _mm256_mul_ps(w, _mm256_set1_ps(0.5f));
+			__m256 hy = _mm256_mul_ps(h, _mm256_set1_ps(0.5f));
+			__m256 cx = _mm256_add_ps(x, hx);
+			__m256 cy = _mm256_add_ps(y, hy);
+			__m256 chx = _mm256_mul_ps(c, hx);
+			__m256 shx = _mm256_mul_ps(s, hx);
+			__m256 chy = _mm256_mul_ps(c, hy);
+			__m256 shy = _mm256_mul_ps(s, hy);
+			__m256 right = _mm256_add_ps(x, w);
+			__m256 top = _mm256_add_ps(y, h);
+			__m256 x0 = _mm256_blendv_ps(x,
+				_mm256_add_ps(_mm256_sub_ps(cx, chx), shy), rotated);
+			__m256 x1 = _mm256_blendv_ps(right,
+				_mm256_add_ps(_mm256_add_ps(cx, chx), shy), rotated);
+			__m256 x2 = _mm256_blendv_ps(x,
+				_mm256_sub_ps(_mm256_sub_ps(cx, chx), shy), rotated);
+			__m256 x3 = _mm256_blendv_ps(right,
+				_mm256_sub_ps(_mm256_add_ps(cx, chx), shy), rotated);
+			__m256 y0 = _mm256_blendv_ps(y,
+				_mm256_sub_ps(_mm256_sub_ps(cy, shx), chy), rotated);
+			__m256 y1 = _mm256_blendv_ps(y,
+				_mm256_sub_ps(_mm256_add_ps(cy, shx), chy), rotated);
+			__m256 y2 = _mm256_blendv_ps(top,
+				_mm256_add_ps(_mm256_sub_ps(cy, shx), chy), rotated);
+			__m256 y3 = _mm256_blendv_ps(top,
+				_mm256_add_ps(_mm256_add_ps(cy, shx), chy), rotated);
+			__m256 u0 = _mm256_loadu_ps(&batch.textureBox[0][i]);
+			__m256 vTop = _mm256_loadu_ps(&batch.textureBox[1][i]);
+			__m256 u1 = _mm256_add_ps(u0,
+				_mm256_loadu_ps(&batch.textureBox[2][i]));
+			__m256 vBottom = _mm256_add_ps(vTop,
+				_mm256_loadu_ps(&batch.textureBox[3][i]));
+			__m256 horizontal = _mm256_cmp_ps(
+				_mm256_loadu_ps(&batch.reflectedHorizontally[i]),
+				_mm256_setzero_ps(), _CMP_NEQ_UQ);
+			__m256 vertical = _mm256_cmp_ps(
+				_mm256_loadu_ps(&batch.reflectedVertically[i]),
+				_mm256_setzero_ps(), _CMP_NEQ_UQ);
+			__m256 left = _mm256_blendv_ps(u0, u1, horizontal);
+			__m256 rightU = _mm256_blendv_ps(u1, u0, horizontal);
+			__m256 bottom = _mm256_blendv_ps(vBottom, vTop, vertical);
+			__m256 topV = _mm256_blendv_ps(vTop, vBottom, vertical);
+			__m256 z = _mm256_loadu_ps(&batch.z[i]);
+			__m256 r = _mm256_loadu_ps(&batch.color[0][i]);
+			__m256 g = _mm256_loadu_ps(&batch.color[1][i]);
+			__m256 b = _mm256_loadu_ps(&batch.color[2][i]);
+			__m256 a = _mm256_loadu_ps(&batch.color[3][i]);
+			__m256 mode = _mm256_loadu_ps(&batch.mode[i]);
+			// Each sprite's four vertices are five sets of eight floats, which
+			// are transposed out of the sprites' properties and stored whole
+			StoreTransposed(vertices, 0, x0, y0, z, left, bottom, r, g, b);
+			StoreTransposed(vertices, 8, a, mode, x1, y1, z, rightU, bottom,
+				r);
+			StoreTransposed(vertices, 16, g, b, a, mode, x2, y2, z, left);
+			StoreTransposed(vertices, 24, topV, r, g, b, a, mode, x3, y3);
+			StoreTransposed(vertices, 32, z, rightU, topV, r, g, b, a, mode);
+			vertices += 8 * FloatsPerSprite;
+		}
+		ExpandScalar(batch, i, last, vertices);
+#else
+		ExpandScalar(batch, first, last, vertices);
+#endif
+	}
+}
@@ -0,0 +1,131 @@
+/*
+File:		Threading.cpp
+Author:		Keegan MacDonald (keeganm742@gmail.com)
+Created:	2026.10.17@10:12
+Purpose:	Implement functions found in Threading.h
+*/
+
+#include "ActiasFW.h"
+
+#include <algorithm>
+
+namespace ActiasFW {
+	// Implement WorkerPool class functions
+
+	bool WorkerPool::initialize(unsigned int workerCount) {
+		ACTIASFW_LOG(Threading, Info, "Starting ", workerCount,
+			" worker threads");
+		if (!m_workers.empty()) {
+			ACTIASFW_LOG(Threading, Error, "The worker pool has already been ",
+				"initialized");
+			return false;
+		}
+		m_task = 0;
+		m_generation = 0;
+		m_activeWorkers = 0;
+		m_stopping = false;
+		for (unsigned int w = 0; w < workerCount; w++) {
+			m_workers.push_back(std::thread(&WorkerPool::work, this));
+		}
+		return true;
+	}
+
+	void WorkerPool::run(ParallelTask& task, size_t count, size_t grainSize) {
+		grainSize = std::max(grainSize, (size_t)1);
+		if (m_workers.empty() || count <= grainSize) {
+			task.execute(0, count);
+			return;
+		}
+		std::unique_lock<std::mutex> lock(m_mutex);
+		m_task = &task;
+		m_count = count;
+		m_grainSize = grainSize;
+		m_next = 0;
+		m_generation++;
+		lock.unlock();
+		m_taskReady.notify_all();
+		executeChunks();
+		lock.lock();
+		while (m_activeWorkers > 0) {
+			m_taskDone.wait(lock);
+		}
+		m_task = 0;
+	}
+
+	void WorkerPool::enqueue(AsyncTask& task) {
+		if (m_workers.empty()) {
+			task.execute();
+			return;
+		}
+		{
+			std::lock_guard<std::mutex> lock(m_mutex);
+			m_queue.push_back(&task);
+		}
+		m_taskReady.notify_one();
+	}
+
+	unsigned int WorkerPool::getWorkerCount() const {
+		return (unsigned int)m_workers.size();
+	}
+
+	bool WorkerPool::destroy() {
+		if (m_workers.empty()) {
+			return false;
+		}
+		ACTIASFW_LOG(Threading, Info, "Stopping ", m_workers.size(),
+			" worker threads");
+		{
+			std::lock_guard<std::mutex> lock(m_mutex);
+			m_stopping = true;
+		}
+		m_taskReady.notify_all();
+		for (std::thread& worker : m_workers) {
+			worker.join();
+		}
+		m_workers.clear();
+		m_queue.clear();
+		m_task = 0;
+		m_stopping = false;
+		return true;
+	}
+
+	void WorkerPool::work() {
+		unsigned int generation = 0;
+		std::unique_lock<std::mutex> lock(m_mutex);
+		while (true) {
+			while (!m_stopping && m_generation == generation
+				&& m_queue.empty()) {
+				m_taskReady.wait(lock);
+			}
+			if (m_stopping) {
+				return;
+			}
+			if (m_generation != generation) {
+				generation = m_generation;
+				if (m_task != 0) {
+					m_activeWorkers++;
+					lock.unlock();
+					executeChunks();
+					lock.lock();
+					if (--m_activeWorkers == 0) {
+						m_taskDone.notify_one();
+					}
+				}
+				continue;
+			}
+			AsyncTask* task = m_queue.front();
+			m_queue.pop_front();
+			lock.unlock();
+			task->execute();
+			lock.lock();
+		}
+	}
+
+	void WorkerPool::executeChunks() {
+		size_t first = m_next.fetch_add(m_grainSize);
+		while (first < m_count) {
+			m_task->execute(first, std::min(first + m_grainSize, m_count));
+			first = m_next.fetch_add(m_grainSize);
+		}
+	}
+}
@@ -7,6 +7,8 @@ Purpose:	Defines variables and implements functions found in UIComponents.h
 
 #include "ActiasFW.h"
 
+#include <algorithm>
+
 namespace ActiasFW {
 	// Implement UIComponents module functions
 
@@ -63,6 +65,7 @@ namespace ActiasFW {
 			(float)Application::Window.getDimensions().y);
 		m_backgroundSprite.setPosition(glm::vec3(position.x * wd.x,
 			position.y * wd.y, position.z));
+		markParentDirty();
 	}
 
 	glm::vec2 UILabel::getDimensions() const {
@@ -77,6 +80,7 @@ namespace ActiasFW {
 			(float)Application::Window.getDimensions().y);
 		m_backgroundSprite.setDimensions(glm::vec2(dimensions.x * wd.x,
 			dimensions.y * wd.y));
+		markParentDirty();
 	}
 
 	Sprite& UILabel::getBackgroundSprite() {
@@ -85,6 +89,7 @@ namespace ActiasFW {
 
 	void UILabel::setBackgroundSprite(const Sprite& backgroundSprite) {
 		m_backgroundSprite = backgroundSprite;
+		markParentDirty();
 	}
 
 	const std::string& UILabel::getLabelText() const {
@@ -93,6 +98,7 @@ namespace ActiasFW {
 
 	void UILabel::setLabelText(const std::string& labelText) {
 		m_labelText = labelText;
+		markParentDirty();
 	}
 
 	Alignment UILabel::getLabelAlignment() const {
@@ -101,6 +107,7 @@ namespace ActiasFW {
 
 	void UILabel::setLabelAlignment(Alignment labelAlignment) {
 		m_labelAlignment = labelAlignment;
+		markParentDirty();
 	}
 
 	Alignment UILabel::getHorizontalLabelAlignment() const {
@@ -110,6 +117,7 @@ namespace ActiasFW {
 	void UILabel::setHorizontalLabelAlignment(
 		Alignment horizontalLabelAlignment) {
 		m_horizontalLabelAlignment = horizontalLabelAlignment;
+		markParentDirty();
 	}
 
 	Alignment UILabel::getVerticalLabelAlignment() const {
@@ -119,6 +127,7 @@ namespace ActiasFW {
 	void UILabel::setVerticalLabelAlignment(
 		Alignment verticalLabelAlignment) {
 		m_verticalLabelAlignment = verticalLabelAlignment;
+		markParentDirty();
 	}
 
 	void UILabel::draw() {
@@ -194,6 +203,9 @@ namespace ActiasFW {
 	}
 
 	void UIButton::setSelected(bool selected) {
+		if (m_selected != selected) {
+			markParentDirty();
+		}
 		if (selected) {
 			m_backgroundSprite.setTextureBox(SelectedTextureBox);
 		}
@@ -208,6 +220,9 @@ namespace ActiasFW {
 	}
 
 	void UIButton::setClicked(bool clicked) {
+		if (m_clicked != clicked) {
+			markParentDirty();
+		}
 		if (clicked) {
 			m_backgroundSprite.setTextureBox(ClickedTextureBox);
 		}
@@ -223,6 +238,9 @@ namespace ActiasFW {
 	}
 
 	void UIButton::setEnabled(bool enabled) {
+		if (m_enabled != enabled) {
+			markParentDirty();
+		}
 		m_enabled = enabled;
 		if (!m_enabled) {
 			setSelected(false);
@@ -299,6 +317,9 @@ namespace ActiasFW {
 	}
 
 	void UISwitch::setOn(bool on) {
+		if (m_on != on) {
+			markParentDirty();
+		}
 		if (!on) {
 			m_backgroundSprite.setTextureBox(OffTextureBox);
 		}
@@ -371,6 +392,9 @@ namespace ActiasFW {
 	}
 
 	void UISlider::setSelected(bool selected) {
+		if (m_selected != selected) {
+			markParentDirty();
+		}
 		if (!selected) {
 			m_backgroundSprite.setTextureBox(UnselectedTextureBox);
 		}
@@ -394,6 +418,7 @@ namespace ActiasFW {
 		else {
 			m_value = value;
 		}
+		markParentDirty();
 	}
 
 	Sprite& UISlider::getCursor() {
@@ -402,6 +427,7 @@ namespace ActiasFW {
 
 	void UISlider::setCursor(const Sprite& cursor) {
 		m_cursor = cursor;
+		markParentDirty();
 	}
 
 	Alignment UISlider::getVerticalCursorAlignment() const {
@@ -411,9 +437,13 @@ namespace ActiasFW {
 	void UISlider::setVerticalCursorAlignment(
 		Alignment verticalCursorAlignment) {
 		m_verticalCursorAlignment = verticalCursorAlignment;
+		markParentDirty();
 	}
 
 	void UISlider::setEnabled(bool enabled) {
+		if (m_enabled != enabled) {
+			markParentDirty();
+		}
 		m_enabled = enabled;
 		if (!m_enabled) {
 			setSelected(false);
@@ -503,8 +533,13 @@ namespace ActiasFW {
 				+ (m_backgroundSprite.getDimensions().y
 					- m_cursor.getDimensions().y) / 2.0f;
 		}
-		m_cursor.setPosition(glm::vec3(cx, cy,
-			m_backgroundSprite.getPosition().z + 0.1f));
+		// The value is set directly while the cursor is dragged
+		glm::vec3 cursorPosition(cx, cy,
+			m_backgroundSprite.getPosition().z + 0.1f);
+		if (m_cursor.getPosition() != cursorPosition) {
+			markParentDirty();
+		}
+		m_cursor.setPosition(cursorPosition);
 	}
 
 	void UISlider::destroy() {
@@ -550,6 +585,9 @@ namespace ActiasFW {
 	}
 
 	void UITextBox::setSelected(bool selected) {
+		if (m_selected != selected) {
+			markParentDirty();
+		}
 		if (!selected) {
 			m_backgroundSprite.setTextureBox(UnselectedTextureBox);
 		}
@@ -571,6 +609,7 @@ namespace ActiasFW {
 		m_horizontalTextPosition = m_backgroundSprite.getPosition().x;
 		m_cursorPosition = 0;
 		m_text = text;
+		markParentDirty();
 	}
 
 	const std::string& UITextBox::getAllowedCharacters() const {
@@ -599,6 +638,7 @@ namespace ActiasFW {
 
 	void UITextBox::setVerticalTextAlignment(Alignment verticalTextAlignment) {
 		m_verticalTextAlignment = verticalTextAlignment;
+		markParentDirty();
 	}
 
 	Sprite& UITextBox::getCursor() {
@@ -607,6 +647,7 @@ namespace ActiasFW {
 
 	void UITextBox::setCursor(const Sprite& cursor) {
 		m_cursor = cursor;
+		markParentDirty();
 	}
 
 	unsigned int UITextBox::getCursorPosition() const {
@@ -618,6 +659,7 @@ namespace ActiasFW {
 			return;
 		}
 		m_cursorPosition = cursorPosition;
+		markParentDirty();
 	}
 
 	Alignment UITextBox::getVerticalCursorAlignment() const {
@@ -627,6 +669,7 @@ namespace ActiasFW {
 	void UITextBox::setVerticalCursorAlignment(
 		Alignment verticalCursorAlignment) {
 		m_verticalCursorAlignment = verticalCursorAlignment;
+		markParentDirty();
 	}
 
 	void UITextBox::setPosition(const glm::vec3& position) {
@@ -683,7 +726,7 @@ namespace ActiasFW {
 				glm::vec2 mp = Application::Input.getMouseCursorPosition(
 					m_parent->getShader().getCamera());
 				for (unsigned int i = 0; i < m_text.length(); i++) {
-					float d = font->getGlyphs().at(m_text[i]).getOffset()
+					float d = font->getGlyph(m_text[i]).offset
 						* m_parent->getTextScale();
 					if (x + d / 2.0f > mp.x) {
 						s = true;
@@ -790,9 +833,9 @@ namespace ActiasFW {
 		const Font* font = Application::Graphics.getFont(
 			m_parent->getFontFileName());
 		for (unsigned int cp = 0; cp < m_cursorPosition; cp++) {
-			cursorPosition.x += (font->getGlyphs().at(m_text[cp]).getOffset()
+			cursorPosition.x += (font->getGlyph(m_text[cp]).offset
 				- (cp == 0
-					? font->getGlyphs().at(m_text[cp]).getBearing().x : 0))
+					? font->getGlyph(m_text[cp]).bearing.x : 0))
 				* m_parent->getTextScale();
 		}
 		if (m_verticalCursorAlignment == ALIGN_BOTTOM) {
@@ -831,6 +874,7 @@ namespace ActiasFW {
 		if (m_timer > (float)Application::Window.getTargetUpdatesPerSecond()) {
 			m_timer = 0.0f;
 		}
+		markEditsDirty();
 	}
 
 	void UITextBox::destroy() {
@@ -845,12 +889,28 @@ namespace ActiasFW {
 		m_cursorPosition = 0;
 		m_verticalCursorAlignment = NO_ALIGNMENT;
 		m_timer = 0.0f;
+		m_drawnText = "";
+		m_drawnCursorPosition = glm::vec3();
+		m_drawnTextPosition = 0.0f;
+	}
+
+	void UITextBox::markEditsDirty() {
+		if (m_text == m_drawnText
+			&& m_cursor.getPosition() == m_drawnCursorPosition
+			&& m_horizontalTextPosition == m_drawnTextPosition) {
+			return;
+		}
+		m_drawnText = m_text;
+		m_drawnCursorPosition = m_cursor.getPosition();
+		m_drawnTextPosition = m_horizontalTextPosition;
+		markParentDirty();
 	}
 
-	void UITextBox::characterTyped(char character) {
-		if (!m_selected) {
+	void UITextBox::characterTyped(char32_t codepoint) {
+		if (!m_selected || codepoint >= 128) {
 			return;
 		}
+		char character = (char)codepoint;
 		if (m_text.length() >= m_maximumCharacters && m_maximumCharacters > 0) {
 			m_text.resize(m_maximumCharacters);
 			return;
@@ -923,7 +983,7 @@ namespace ActiasFW {
 				glm::vec2 mp = Application::Input.getMouseCursorPosition(
 					m_parent->getShader().getCamera());
 				for (unsigned int i = 0; i < m_text.length(); i++) {
-					float d = font->getGlyphs().at('*').getOffset()
+					float d = font->getGlyph('*').offset
 						* m_parent->getTextScale();
 					if (x + d / 2.0f > mp.x) {
 						s = true;
@@ -1030,8 +1090,8 @@ namespace ActiasFW {
 		const Font* font = Application::Graphics.getFont(
 			m_parent->getFontFileName());
 		for (unsigned int cp = 0; cp < m_cursorPosition; cp++) {
-			cursorPosition.x += (font->getGlyphs().at('*').getOffset()
-				- (cp == 0 ? font->getGlyphs().at('*').getBearing().x : 0))
+			cursorPosition.x += (font->getGlyph('*').offset
+				- (cp == 0 ? font->getGlyph('*').bearing.x : 0))
 				* m_parent->getTextScale();
 		}
 		if (m_verticalCursorAlignment == ALIGN_BOTTOM) {
@@ -1070,6 +1130,7 @@ namespace ActiasFW {
 		if (m_timer > (float)Application::Window.getTargetUpdatesPerSecond()) {
 			m_timer = 0.0f;
 		}
+		markEditsDirty();
 	}
 
 	void UIPasswordBox::destroy() {
@@ -1119,6 +1180,7 @@ namespace ActiasFW {
 
 	void UITextArea::setLineCount(unsigned int lineCount) {
 		m_lineCount = lineCount;
+		markParentDirty();
 	}
 
 	int UITextArea::getTopLineIndex() const {
@@ -1137,6 +1199,7 @@ namespace ActiasFW {
 			return;
 		}
 		m_topLineIndex = topLineIndex;
+		markParentDirty();
 	}
 
 	void UITextArea::draw() {
@@ -1200,8 +1263,8 @@ namespace ActiasFW {
 					float xd = 0.0f;
 					for (unsigned int i = 0; i < contentLines[line].length();
 						i++) {
-						xd = font->getGlyphs().at(contentLines[line][i])
-							.getOffset() * m_parent->getTextScale();
+						xd = font->getGlyph(contentLines[line][i])
+							.offset * m_parent->getTextScale();
 						if (x + xd / 2.0f > mp.x) {
 							break;
 						}
@@ -1360,8 +1423,8 @@ namespace ActiasFW {
 			}
 			else {
 				glm::vec3 cpos = m_cursor.getPosition();
-				cpos.x += (font->getGlyphs().at(m_text[cp]).getOffset()
-					- (cp == 0 ? font->getGlyphs().at(m_text[cp]).getBearing().x
+				cpos.x += (font->getGlyph(m_text[cp]).offset
+					- (cp == 0 ? font->getGlyph(m_text[cp]).bearing.x
 						: 0)) * m_parent->getTextScale();
 				m_cursor.setPosition(cpos);
 			}
@@ -1384,6 +1447,7 @@ namespace ActiasFW {
 		if (m_timer > (float)Application::Window.getTargetUpdatesPerSecond()) {
 			m_timer = 0.0f;
 		}
+		markEditsDirty();
 	}
 
 	void UITextArea::destroy() {
@@ -1392,8 +1456,8 @@ namespace ActiasFW {
 		m_topLineIndex = 0;
 	}
 
-	void UITextArea::characterTyped(char character) {
-		UITextBox::characterTyped(character);
+	void UITextArea::characterTyped(char32_t codepoint) {
+		UITextBox::characterTyped(codepoint);
 		putCursorInView();
 	}
 
@@ -1418,11 +1482,11 @@ namespace ActiasFW {
 				m_parent->getFontFileName());
 			for (unsigned int i = 0;
 				i < contentLines[cLine + 1].length(); i++) {
-				x += font->getGlyphs().at(contentLines[cLine + 1][i])
-					.getOffset() * m_parent->getTextScale();
+				x += font->getGlyph(contentLines[cLine + 1][i])
+					.offset * m_parent->getTextScale();
 				ncp++;
-				if (x + font->getGlyphs().at(contentLines[cLine + 1][i])
-					.getOffset() * m_parent->getTextScale()
+				if (x + font->getGlyph(contentLines[cLine + 1][i])
+					.offset * m_parent->getTextScale()
 				> m_cursor.getPosition().x) {
 					break;
 				}
@@ -1453,11 +1517,11 @@ namespace ActiasFW {
 				m_parent->getFontFileName());
 			for (unsigned int i = 0;
 				i < contentLines[cLine - 1].length(); i++) {
-				x += font->getGlyphs().at(contentLines[cLine - 1][i])
-					.getOffset() * m_parent->getTextScale();
+				x += font->getGlyph(contentLines[cLine - 1][i])
+					.offset * m_parent->getTextScale();
 				ncp++;
-				if (x + font->getGlyphs().at(
-					contentLines[cLine - 1][i]).getOffset()
+				if (x + font->getGlyph(
+					contentLines[cLine - 1][i]).offset
 					* m_parent->getTextScale()
 				> m_cursor.getPosition().x) {
 					break;
@@ -1615,10 +1679,12 @@ namespace ActiasFW {
 		}
 		if (index < 0) {
 			m_values.push_back(value);
+			markParentDirty();
 			return true;
 		}
 		std::vector<std::string>::iterator it = m_values.begin() + index;
 		m_values.insert(it, value);
+		markParentDirty();
 		return true;
 	}
 
@@ -1646,6 +1712,7 @@ namespace ActiasFW {
 	void UICarousel::clear() {
 		m_values.clear();
 		m_currentValueIndex = 0;
+		markParentDirty();
 	}
 
 	const std::string& UICarousel::getCurrentValue() const {
@@ -1671,6 +1738,7 @@ namespace ActiasFW {
 		else {
 			m_currentValueIndex = index;
 		}
+		markParentDirty();
 	}
 
 	UIButton& UICarousel::getLastButton() {
@@ -1679,6 +1747,7 @@ namespace ActiasFW {
 
 	void UICarousel::setLastButton(const UIButton& lastButton) {
 		m_lastButton = lastButton;
+		markParentDirty();
 	}
 
 	UIButton& UICarousel::getNextButton() {
@@ -1687,6 +1756,7 @@ namespace ActiasFW {
 
 	void UICarousel::setNextButton(const UIButton& nextButton) {
 		m_nextButton = nextButton;
+		markParentDirty();
 	}
 
 	Alignment UICarousel::getHorizontalTextAlignment() const {
@@ -1696,6 +1766,7 @@ namespace ActiasFW {
 	void UICarousel::setHorizontalTextAlignment(
 		Alignment horizontalTextAlignment) {
 		m_horizontalTextAlignment = horizontalTextAlignment;
+		markParentDirty();
 	}
 
 	Alignment UICarousel::getVerticalTextAlignment() const {
@@ -1705,6 +1776,7 @@ namespace ActiasFW {
 	void UICarousel::setVerticalTextAlignment(
 		Alignment verticalTextAlignment) {
 		m_verticalTextAlignment = verticalTextAlignment;
+		markParentDirty();
 	}
 
 	Alignment UICarousel::getHorizontalButtonAlignment() const {
@@ -1880,6 +1952,10 @@ namespace ActiasFW {
 
 	}
 
+	void UICarousel::markDirty() {
+		markParentDirty();
+	}
+
 	void UICarousel::draw() {
 		UILabel::draw();
 		if (m_values.size() > 0) {
@@ -2283,6 +2359,10 @@ namespace ActiasFW {
 	void UIListBox::setController(Controller) {
 
 	}
+
+	void UIListBox::markDirty() {
+		markParentDirty();
+	}
 	
 	void UIListBox::draw() {
 		UILabel::draw();
@@ -7,6 +7,8 @@ Purpose:	Defines variables and implements functions found in UISystem.h
 
 #include "ActiasFW.h"
 
+#include <algorithm>
+
 namespace ActiasFW {
 	// Implement UIComponent class functions
 
@@ -37,6 +39,9 @@ namespace ActiasFW {
 		else if (!m_enabled && enabled) {
 			Application::Input.addListener(*this);
 		}
+		if (m_enabled != enabled) {
+			markParentDirty();
+		}
 		m_enabled = enabled;
 	}
 
@@ -48,6 +53,9 @@ namespace ActiasFW {
 		if (m_visible && !visible) {
 			setEnabled(false);
 		}
+		if (m_visible != visible) {
+			markParentDirty();
+		}
 		m_visible = visible;
 	}
 
@@ -100,9 +108,18 @@ namespace ActiasFW {
 	}
 
 	void UIComponent::setHighlighted(bool highlighted) {
+		if (m_highlighted != highlighted) {
+			markParentDirty();
+		}
 		m_highlighted = highlighted;
 	}
 
+	void UIComponent::markParentDirty() {
+		if (m_parent != 0) {
+			m_parent->markDirty();
+		}
+	}
+
 	// Implement UIGroup class functions
 
 	bool UIGroup::initialize(Scene& parent, unsigned int ID,
@@ -137,11 +154,47 @@ namespace ActiasFW {
 		if (!m_visible) {
 			return;
 		}
-		for (UIComponent* component : m_components) {
-			if (!component->isVisible()) {
-				continue;
+		if (!m_cached) {
+			for (UIComponent* component : m_components) {
+				if (!component->isVisible()) {
+					continue;
+				}
+				component->draw();
+			}
+		}
+		else {
+			// The components are drawn into the render target only when they
+			// have changed, their camera has moved, or textures they were
+			// last drawn with had not finished loading
+			const glm::vec4& box = m_shader.getCamera().getVisibleBox();
+			if (box != m_targetBox || !m_target.isComplete()) {
+				m_targetBox = box;
+				m_dirty = true;
+			}
+			float depth = std::numeric_limits<float>::max();
+			if (m_dirty) {
+				Application::Graphics.beginTarget(m_target);
+			}
+			for (UIComponent* component : m_components) {
+				if (!component->isVisible()) {
+					continue;
+				}
+				depth = std::min(depth, component->getPosition().z);
+				if (m_dirty) {
+					component->draw();
+				}
+			}
+			if (m_dirty) {
+				Application::Graphics.endTarget();
+				m_dirty = false;
+			}
+			// Draw the target at the depth of the lowest component, covering
+			// exactly what the camera sees
+			if (depth != std::numeric_limits<float>::max()) {
+				m_targetSprite.setPosition(glm::vec3(box.x, box.y, depth));
+				m_targetSprite.setDimensions(glm::vec2(box.z, box.w));
+				Application::Graphics.submit(m_targetSprite, m_shader);
 			}
-			component->draw();
 		}
 		if (!Application::Input.getControllers().empty()) {
 			Application::Graphics.submit(m_highlightSprite, m_shader);
@@ -253,6 +306,10 @@ namespace ActiasFW {
 			glm::vec2 scale(wd.x / (float)m_lastWindowDimensions.x,
 				wd.y / (float)m_lastWindowDimensions.y);
 			m_lastWindowDimensions = wd;
+			if (m_cached) {
+				m_target.setDimensions(m_lastWindowDimensions);
+				m_dirty = true;
+			}
 			for (UIComponent* component : m_components) {
 				glm::vec2 dimensions = component->getDimensions();
 				dimensions.x *= scale.x;
@@ -274,10 +331,12 @@ namespace ActiasFW {
 		}
 		m_parent = 0;
 		m_ID = 0;
+		setCached(false);
 		for (UIComponent* component : m_components) {
 			component->destroy();
 		}
 		m_components.clear();
+		m_shader.destroy();
 		m_nextID = 0;
 		m_fontFileName = "";
 		m_textScale = 0.0f;
@@ -314,6 +373,7 @@ namespace ActiasFW {
 			return false;
 		}
 		component.setParent(*this);
+		markDirty();
 		component.setID(m_nextID++);
 		component.setEnabled(m_enabled);
 		component.setVisible(m_visible);
@@ -334,6 +394,7 @@ namespace ActiasFW {
 			return false;
 		}
 		m_components.erase(it);
+		markDirty();
 		return true;
 	}
 
@@ -343,6 +404,7 @@ namespace ActiasFW {
 
 	void UIGroup::setShader(const GLSLShader& shader) {
 		m_shader = shader;
+		markDirty();
 	}
 
 	const std::string& UIGroup::getFontFileName() const {
@@ -351,6 +413,7 @@ namespace ActiasFW {
 
 	void UIGroup::setFontFileName(const std::string& fontFileName) {
 		m_fontFileName = fontFileName;
+		markDirty();
 	}
 
 	float UIGroup::getTextScale() const {
@@ -359,6 +422,7 @@ namespace ActiasFW {
 
 	void UIGroup::setTextScale(float textScale) {
 		m_textScale = textScale;
+		markDirty();
 	}
 
 	const glm::vec4& UIGroup::getTextColor() const {
@@ -367,6 +431,7 @@ namespace ActiasFW {
 
 	void UIGroup::setTextColor(const glm::vec4& textColor) {
 		m_textColor = textColor;
+		markDirty();
 	}
 
 	bool UIGroup::isEnabled() const {
@@ -386,6 +451,7 @@ namespace ActiasFW {
 
 	void UIGroup::setVisible(bool visible) {
 		m_visible = visible;
+		markDirty();
 		for (UIComponent* component : m_components) {
 			component->setVisible(visible);
 		}
@@ -422,4 +488,34 @@ namespace ActiasFW {
 	void UIGroup::setHighlightMargins(const glm::vec2& highlightMargins) {
 		m_highlightMargins = highlightMargins;
 	}
+
+	bool UIGroup::isCached() const {
+		return m_cached;
+	}
+
+	bool UIGroup::setCached(bool cached) {
+		if (m_cached == cached) {
+			return true;
+		}
+		if (cached) {
+			ACTIASFW_LOG(UIGroup, Info, "Caching UI group ", m_ID);
+			if (!m_target.initialize(Application::Window.getDimensions(),
+				"ActiasFW::UIGroup@" + std::to_string((std::uintptr_t)this))) {
+				ACTIASFW_LOG(UIGroup, Error, "Failed to create render target ",
+					"for UI group ", m_ID);
+				return false;
+			}
+			m_targetSprite.initialize(glm::vec3(), glm::vec2(), m_target);
+		}
+		else {
+			m_target.destroy();
+		}
+		m_cached = cached;
+		m_dirty = true;
+		return true;
+	}
+
+	void UIGroup::markDirty() {
+		m_dirty = true;
+	}
 }
\ No newline at end of file
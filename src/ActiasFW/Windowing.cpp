@@ -7,27 +7,58 @@ Purpose:	Defines variables and implements functions found in Windowing.h
 
 #include "ActiasFW.h"
 
+#include <lodepng.h>
+
+#include <cstring>
+#include <filesystem>
+#include <iomanip>
+#include <sstream>
+
 namespace ActiasFW {
 	// Implement WindowManager class functions
 
 	bool WindowManager::initialize(const glm::ivec2& dimensions,
 		const std::string& title, bool fullscreen,
 		unsigned int targetUpdatesPerSecond,
-		unsigned int maximumUpdatesPerFrame) {
+		unsigned int maximumUpdatesPerFrame, bool headless,
+		unsigned int frameLimit, const std::string& frameDumpDirectory) {
 		ACTIASFW_LOG(Window, Info, "Initializing Actias application window");
 		if (m_initialized) {
 			ACTIASFW_LOG(Window, Error, "Window already initialized");
 			return false;
 		}
+		m_headless = headless;
+		m_frameLimit = frameLimit;
+		m_frameCount = 0;
+		m_frameDumpDirectory = frameDumpDirectory;
 		ACTIASFW_LOG(Window, Info, "Initializing GLFW library");
+		if (m_headless) {
+			glfwInitHint(GLFW_PLATFORM, GLFW_PLATFORM_NULL);
+		}
 		if (!glfwInit()) {
 			ACTIASFW_LOG(Window, Error, "Failed to initialize GLFW library");
 			return false;
 		}
 		glfwWindowHint(GLFW_RESIZABLE, GLFW_FALSE);
-		setHandle(glfwCreateWindow(1, 1, "", 0, 0));
-		glfwMakeContextCurrent(m_handle);
-		setMonitor(glfwGetPrimaryMonitor());
+		if (m_headless) {
+			if (!createHeadlessContext(dimensions)) {
+				ACTIASFW_LOG(Window, Error, "Failed to create headless ",
+					"context");
+				glfwTerminate();
+				return false;
+			}
+		}
+		else {
+			setHandle(glfwCreateWindow(1, 1, "", 0, 0));
+			glfwMakeContextCurrent(m_handle);
+			setMonitor(glfwGetPrimaryMonitor());
+		}
+		if (!m_frameDumpDirectory.empty()) {
+			ACTIASFW_LOG(Window, Info, "Saving frames to ",
+				m_frameDumpDirectory);
+			std::error_code error;
+			std::filesystem::create_directories(m_frameDumpDirectory, error);
+		}
 		setDimensions(dimensions);
 		setTitle(title);
 		setFullscreen(fullscreen);
@@ -39,7 +70,18 @@ namespace ActiasFW {
 	}
 
 	bool WindowManager::update() {
-		glfwSwapBuffers(m_handle);
+		if (m_frameCount > 0 && !m_frameDumpDirectory.empty()) {
+			dumpFrame();
+		}
+		// A headless window's frames stay in its framebuffer, so there is
+		// nothing to present
+		if (!m_headless) {
+			glfwSwapBuffers(m_handle);
+		}
+		if (m_frameLimit > 0 && m_frameCount >= m_frameLimit) {
+			return false;
+		}
+		m_frameCount++;
 		return !glfwWindowShouldClose(m_handle);
 	}
 
@@ -49,6 +91,11 @@ namespace ActiasFW {
 			ACTIASFW_LOG(Window, Warning, "The window was already destroyed");
 			return false;
 		}
+		if (m_framebuffer != 0) {
+			ACTIASFW_LOG(Window, Info, "Deleting offscreen framebuffer");
+			glDeleteFramebuffers(1, &m_framebuffer);
+			glDeleteRenderbuffers(1, &m_colorBuffer);
+		}
 		ACTIASFW_LOG(Window, Info, "Destroying GLFW window");
 		glfwDestroyWindow(m_handle);
 		ACTIASFW_LOG(Window, Info, "Terminating GLFW library");
@@ -61,6 +108,14 @@ namespace ActiasFW {
 		m_fullscreen = false;
 		m_monitor = 0;
 		m_handle = 0;
+		m_headless = false;
+		m_framebuffer = 0;
+		m_colorBuffer = 0;
+		m_frameLimit = 0;
+		m_frameCount = 0;
+		m_frameDumpDirectory = "";
+		m_framePixels.clear();
+		m_frameImage.clear();
 		return true;
 	}
 
@@ -78,6 +133,11 @@ namespace ActiasFW {
 		}
 		m_dimensions = dimensions;
 		glfwSetWindowSize(m_handle, dimensions.x, dimensions.y);
+		if (m_colorBuffer != 0) {
+			glBindRenderbuffer(GL_RENDERBUFFER, m_colorBuffer);
+			glRenderbufferStorage(GL_RENDERBUFFER, GL_RGBA8, dimensions.x,
+				dimensions.y);
+		}
 		glViewport(0, 0, dimensions.x, dimensions.y);
 		center();
 	}
@@ -97,6 +157,13 @@ namespace ActiasFW {
 	}
 
 	void WindowManager::setFullscreen(bool fullscreen) {
+		if (m_headless) {
+			if (fullscreen) {
+				ACTIASFW_LOG(Window, Warning, "Headless windows cannot be ",
+					"fullscreen");
+			}
+			return;
+		}
 		if (fullscreen && !m_fullscreen) {
 			ACTIASFW_LOG(Window, Info, "Setting window to fullscreen mode");
 			const GLFWvidmode* vm = glfwGetVideoMode(m_monitor);
@@ -161,9 +228,95 @@ namespace ActiasFW {
 		m_maximumUpdatesPerFrame = maximumUpdatesPerFrame;
 	}
 
+	bool WindowManager::isHeadless() const {
+		return m_headless;
+	}
+
+	GLuint WindowManager::getFramebuffer() const {
+		return m_framebuffer;
+	}
+
+	unsigned int WindowManager::getFrameCount() const {
+		return m_frameCount;
+	}
+
 	void WindowManager::center() {
+		if (m_headless || m_monitor == 0) {
+			return;
+		}
 		const GLFWvidmode* vm = glfwGetVideoMode(m_monitor);
 		glfwSetWindowPos(m_handle, (vm->width - m_dimensions.x) / 2,
 			(vm->height - m_dimensions.y) / 2);
 	}
+
+	bool WindowManager::createHeadlessContext(const glm::ivec2& dimensions) {
+		ACTIASFW_LOG(Window, Info, "Creating surfaceless OpenGL context");
+		glfwWindowHint(GLFW_VISIBLE, GLFW_FALSE);
+		// Prefer EGL's surfaceless platform, falling back to OSMesa for Mesa
+		// builds without it
+		const int contextAPIs[] = { GLFW_EGL_CONTEXT_API,
+			GLFW_OSMESA_CONTEXT_API, };
+		for (int contextAPI : contextAPIs) {
+			glfwWindowHint(GLFW_CONTEXT_CREATION_API, contextAPI);
+			setHandle(glfwCreateWindow(dimensions.x, dimensions.y, "", 0, 0));
+			if (m_handle != 0) {
+				break;
+			}
+		}
+		if (m_handle == 0) {
+			ACTIASFW_LOG(Window, Error, "Neither EGL nor OSMesa could create ",
+				"a context");
+			return false;
+		}
+		glfwMakeContextCurrent(m_handle);
+		// The framebuffer functions are needed before the graphics manager
+		// loads OpenGL
+		if (!OpenGL::Load()) {
+			ACTIASFW_LOG(Window, Error, "Failed to load OpenGL functions");
+			return false;
+		}
+		ACTIASFW_LOG(Window, Info, "Creating offscreen framebuffer");
+		glGenRenderbuffers(1, &m_colorBuffer);
+		glBindRenderbuffer(GL_RENDERBUFFER, m_colorBuffer);
+		glRenderbufferStorage(GL_RENDERBUFFER, GL_RGBA8, dimensions.x,
+			dimensions.y);
+		glGenFramebuffers(1, &m_framebuffer);
+		glBindFramebuffer(GL_FRAMEBUFFER, m_framebuffer);
+		glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0,
+			GL_RENDERBUFFER, m_colorBuffer);
+		if (glCheckFramebufferStatus(GL_FRAMEBUFFER)
+			!= GL_FRAMEBUFFER_COMPLETE) {
+			ACTIASFW_LOG(Window, Error, "Offscreen framebuffer is incomplete");
+			return false;
+		}
+		return true;
+	}
+
+	void WindowManager::dumpFrame() {
+		size_t rowSize = (size_t)m_dimensions.x * 4;
+		size_t rows = (size_t)m_dimensions.y;
+		m_framePixels.resize(rowSize * rows);
+		m_frameImage.resize(rowSize * rows);
+		glPixelStorei(GL_PACK_ALIGNMENT, 1);
+		glReadPixels(0, 0, m_dimensions.x, m_dimensions.y, GL_RGBA,
+			GL_UNSIGNED_BYTE, m_framePixels.data());
+		// OpenGL's rows start at the bottom of the frame and PNG's at the top,
+		// and the window is opaque whatever alpha was drawn
+		for (size_t y = 0; y < rows; y++) {
+			unsigned char* row = m_frameImage.data() + y * rowSize;
+			std::memcpy(row, m_framePixels.data() + (rows - 1 - y) * rowSize,
+				rowSize);
+			for (size_t a = 3; a < rowSize; a += 4) {
+				row[a] = 255;
+			}
+		}
+		std::ostringstream fileName;
+		fileName << m_frameDumpDirectory << "/frame" << std::setw(6)
+			<< std::setfill('0') << m_frameCount << ".png";
+		if (lodepng::encode(fileName.str(), m_frameImage,
+			(unsigned int)m_dimensions.x, (unsigned int)m_dimensions.y)) {
+			ACTIASFW_LOG(Window, Warning, "Failed to save frame to ",
+				fileName.str());
+		}
+	}
 }
\ No newline at end of file
@@ -0,0 +1,324 @@
+/*
+File:		Replay.cpp
+Author:		Keegan MacDonald (keeganm742@gmail.com)
+Created:	2026.10.17@17:55
+Purpose:	Implement functions found in Replay.h and the main entry point of
+			the Replay program
+*/
+
+#include "Replay.h"
+
+#include <algorithm>
+#include <iomanip>
+
+void ReplaySprite::initialize(const FrameTrace& trace,
+	const FrameTrace::SpriteRecord& record) {
+	Sprite::initialize(record.position, record.dimensions,
+		trace.getString(record.texture));
+	setRotation(record.rotation);
+	setTextureBox(record.textureBox);
+	setColor(record.color);
+	setReflectedHorizontally(record.reflectedHorizontally);
+	setReflectedVertically(record.reflectedVertically);
+	m_drawMode = record.mode;
+}
+
+float ReplaySprite::getDrawMode() const {
+	return m_drawMode;
+}
+
+bool TraceReplay::initialize(const FrameTrace& trace) {
+	m_trace = &trace;
+	for (const FrameTrace::FontRecord& font : trace.getFonts()) {
+		Application::Graphics.setFontRendering(trace.getString(font.fileName),
+			font.rendering);
+	}
+	// Cameras and shaders are referred to by address once drawn, so their
+	// arrays are sized once before any is initialized
+	m_ownCameras.resize(trace.getCameras().size());
+	for (size_t c = 0; c < trace.getCameras().size(); c++) {
+		if (trace.getCameras().at(c).defaultCamera) {
+			m_cameras.push_back(&Application::Graphics.getDefaultCamera());
+		}
+		else {
+			m_ownCameras[c].initialize();
+			m_cameras.push_back(&m_ownCameras[c]);
+		}
+	}
+	m_ownShaders.resize(trace.getShaders().size());
+	for (size_t s = 0; s < trace.getShaders().size(); s++) {
+		const FrameTrace::ShaderRecord& record = trace.getShaders().at(s);
+		if (record.builtIn == FrameTrace::BUILT_IN_DEFAULT) {
+			m_shaders.push_back(&Application::Graphics.getDefaultShader());
+			continue;
+		}
+		if (record.builtIn == FrameTrace::BUILT_IN_DEFAULT_INSTANCED) {
+			m_shaders.push_back(
+				&Application::Graphics.getDefaultInstancedShader());
+			continue;
+		}
+		GLSLShader& shader = m_ownShaders[s];
+		shader.setInstanced(record.instanced);
+		shader.setTextureUnits(record.textureUnitCount,
+			trace.getString(record.textureSamplerUniformName));
+		if (!shader.initialize(trace.getString(record.vertexShaderSource),
+			trace.getString(record.fragmentShaderSource), {},
+			*m_cameras.at(record.camera),
+			trace.getString(record.cameraUniformName))) {
+			std::cout << "Failed to compile shader " << s << std::endl;
+			return false;
+		}
+		shader.setVertexLayout(record.vertexLayout);
+		m_shaders.push_back(&shader);
+	}
+	m_frameSprites.resize(trace.getFrames().size());
+	for (size_t f = 0; f < trace.getFrames().size(); f++) {
+		const FrameTrace::Frame& frame = trace.getFrames().at(f);
+		m_frameSprites[f].resize(frame.sprites.size());
+		for (size_t s = 0; s < frame.sprites.size(); s++) {
+			m_frameSprites[f][s].initialize(trace, frame.sprites.at(s));
+		}
+	}
+	m_textMeshes.resize(trace.getTextMeshes().size());
+	for (size_t t = 0; t < trace.getTextMeshes().size(); t++) {
+		layoutTextMesh(t);
+	}
+	m_batches.resize(trace.getBatches().size());
+	for (size_t b = 0; b < trace.getBatches().size(); b++) {
+		const FrameTrace::BatchRecord& record = trace.getBatches().at(b);
+		ReplayBatch& batch = m_batches[b];
+		batch.sprites.resize(record.sprites.size());
+		for (size_t s = 0; s < record.sprites.size(); s++) {
+			batch.sprites[s].initialize(trace, record.sprites.at(s));
+			batch.spritePointers.push_back(&batch.sprites[s]);
+		}
+		if (!batch.batch.initialize(batch.spritePointers,
+			*m_shaders.at(record.shader))) {
+			std::cout << "Failed to initialize static batch " << b
+				<< std::endl;
+			return false;
+		}
+	}
+	// Each recorded layout and bake is redone in the frame it was recorded
+	// in on every pass through the trace
+	for (size_t f = trace.getFrames().size(); f-- > 0;) {
+		const FrameTrace::Frame& frame = trace.getFrames().at(f);
+		for (unsigned int t : frame.textMeshes) {
+			m_textMeshes[t].firstFrame = f;
+		}
+		for (unsigned int b : frame.batches) {
+			m_batches[b].firstFrame = f;
+		}
+	}
+	return true;
+}
+
+void TraceReplay::layoutTextMesh(size_t t) {
+	const FrameTrace::TextRecord& record = m_trace->getTextMeshes().at(t);
+	m_textMeshes[t].mesh.initialize(m_trace->getString(record.text),
+		record.position, record.box, record.scale, record.color,
+		m_trace->getString(record.font), record.horizontalAlignment,
+		record.verticalAlignment);
+}
+
+std::vector<std::string> TraceReplay::getTextureFileNames() const {
+	std::vector<std::string> fileNames;
+	for (const std::vector<ReplaySprite>& sprites : m_frameSprites) {
+		for (const ReplaySprite& sprite : sprites) {
+			fileNames.push_back(sprite.getTextureFileName());
+		}
+	}
+	for (const ReplayBatch& batch : m_batches) {
+		for (const ReplaySprite& sprite : batch.sprites) {
+			fileNames.push_back(sprite.getTextureFileName());
+		}
+	}
+	for (const FrameTrace::Frame& frame : m_trace->getFrames()) {
+		for (const FrameTrace::MeshRecord& mesh : frame.meshes) {
+			fileNames.push_back(m_trace->getString(mesh.texture));
+		}
+	}
+	std::sort(fileNames.begin(), fileNames.end());
+	fileNames.erase(std::unique(fileNames.begin(), fileNames.end()),
+		fileNames.end());
+	fileNames.erase(std::remove(fileNames.begin(), fileNames.end(), ""),
+		fileNames.end());
+	return fileNames;
+}
+
+void TraceReplay::submitFrame(size_t f) {
+	const FrameTrace::Frame& frame = m_trace->getFrames().at(f);
+	for (const FrameTrace::CameraState& state : frame.cameras) {
+		Camera& camera = *m_cameras.at(state.camera);
+		camera.setPosition(state.position);
+		camera.setScale(state.scale);
+		camera.update(0.0f);
+	}
+	for (size_t s = 0; s < frame.sprites.size(); s++) {
+		Application::Graphics.submit(m_frameSprites[f][s],
+			*m_shaders.at(frame.sprites.at(s).shader));
+	}
+	for (const FrameTrace::TextRecord& text : frame.text) {
+		Application::Graphics.submit(m_trace->getString(text.text),
+			text.position, text.box, text.scale, text.color,
+			m_trace->getString(text.font), text.horizontalAlignment,
+			text.verticalAlignment, *m_shaders.at(text.shader));
+	}
+	for (unsigned int t : frame.textMeshes) {
+		ReplayTextMesh& text = m_textMeshes[t];
+		if (text.firstFrame == f) {
+			layoutTextMesh(t);
+		}
+		Application::Graphics.submit(text.mesh,
+			*m_shaders.at(m_trace->getTextMeshes().at(t).shader));
+	}
+	for (unsigned int b : frame.batches) {
+		if (m_batches[b].firstFrame == f) {
+			m_batches[b].batch.markDirty();
+		}
+		Application::Graphics.submit(m_batches[b].batch);
+	}
+	for (const FrameTrace::MeshRecord& mesh : frame.meshes) {
+		Application::Graphics.submitVertices(mesh.vertices.data(),
+			mesh.vertices.size(), mesh.indices, mesh.depth,
+			m_trace->getString(mesh.texture), *m_shaders.at(mesh.shader));
+	}
+}
+
+void TraceReplay::destroy() {
+	for (ReplayBatch& batch : m_batches) {
+		batch.batch.destroy();
+	}
+	m_batches.clear();
+	for (ReplayTextMesh& text : m_textMeshes) {
+		text.mesh.destroy();
+	}
+	m_textMeshes.clear();
+	m_frameSprites.clear();
+	for (size_t s = 0; s < m_ownShaders.size(); s++) {
+		if (m_shaders.at(s) == &m_ownShaders[s]) {
+			m_ownShaders[s].destroy();
+		}
+	}
+	m_ownShaders.clear();
+	m_shaders.clear();
+	for (size_t c = 0; c < m_ownCameras.size(); c++) {
+		if (m_cameras.at(c) == &m_ownCameras[c]) {
+			m_ownCameras[c].destroy();
+		}
+	}
+	m_ownCameras.clear();
+	m_cameras.clear();
+	m_trace = 0;
+}
+
+void PrintPhase(const std::string& name, std::vector<double>& times) {
+	double total = 0.0;
+	for (double time : times) {
+		total += time;
+	}
+	std::sort(times.begin(), times.end());
+	std::cout << std::left << std::setw(12) << name << std::right
+		<< std::fixed << std::setprecision(3)
+		<< std::setw(10) << total / (double)times.size()
+		<< std::setw(10) << times.front()
+		<< std::setw(10) << times.at(times.size() / 2)
+		<< std::setw(10) << times.at((times.size() * 99) / 100)
+		<< std::setw(10) << times.back() << std::endl;
+}
+
+int main(int argc, char** argv) {
+	if (argc < 2) {
+		std::cout << "Usage: Replay <trace file> [passes] "
+			<< "[frame dump directory]" << std::endl;
+		return EXIT_FAILURE;
+	}
+	FrameTrace trace;
+	if (!trace.load(argv[1]) || trace.getFrames().empty()) {
+		std::cout << "Failed to load trace " << argv[1] << std::endl;
+		return EXIT_FAILURE;
+	}
+	unsigned int passes = argc > 2 ? (unsigned int)atoi(argv[2]) : 10;
+	passes = std::max(passes, 1u);
+	Application::Configuration::Graphics graphics;
+	if (!Application::Log.initialize(false, {}, "%Y.%m.%d@%H:%M:%S")
+		|| !Application::Window.initialize(trace.getWindowDimensions(),
+			"Replay", false, 60, 1, true, 0, argc > 3 ? argv[3] : "")
+		|| !Application::Graphics.initialize(graphics.backgroundColor,
+			graphics.streamBufferSize, graphics.atlasPageSize,
+			graphics.textureUploadBudget, graphics.shaderCacheDirectory,
+			graphics.textCacheSize)) {
+		std::cout << "Failed to initialize headless graphics" << std::endl;
+		return EXIT_FAILURE;
+	}
+	TraceReplay replay;
+	if (!replay.initialize(trace)) {
+		return EXIT_FAILURE;
+	}
+	// Load every texture, compile every program, and rasterize every glyph
+	// before timing, since the trace's application had already done so
+	std::vector<std::string> textures = replay.getTextureFileNames();
+	Application::Graphics.prefetchTextures(textures);
+	for (size_t f = 0; f < trace.getFrames().size(); f++) {
+		Application::Graphics.begin();
+		replay.submitFrame(f);
+		Application::Graphics.end();
+	}
+	for (size_t t = 0; t < textures.size();) {
+		if (Application::Graphics.isTextureReady(textures[t])) {
+			t++;
+			continue;
+		}
+		Application::Graphics.begin();
+		Application::Graphics.end();
+	}
+	glFinish();
+	const char* phaseNames[] = { "submit", "upload", "merge", "prepare",
+		"sort", "draw calls", "end", "gpu", "frame", };
+	std::vector<double> phases[9];
+	unsigned int sprites = 0;
+	unsigned int drawCalls = 0;
+	for (unsigned int p = 0; p < passes; p++) {
+		for (size_t f = 0; f < trace.getFrames().size(); f++) {
+			Application::Window.update();
+			double start = glfwGetTime();
+			Application::Graphics.begin();
+			replay.submitFrame(f);
+			double submitted = glfwGetTime();
+			Application::Graphics.end();
+			double ended = glfwGetTime();
+			glFinish();
+			double finished = glfwGetTime();
+			const GraphicsManager::FrameStatistics& statistics
+				= Application::Graphics.getFrameStatistics();
+			phases[0].push_back((submitted - start) * 1000.0);
+			phases[1].push_back(statistics.uploadTime);
+			phases[2].push_back(statistics.mergeTime);
+			phases[3].push_back(statistics.prepareTime);
+			phases[4].push_back(statistics.sortTime);
+			phases[5].push_back(statistics.submitTime);
+			phases[6].push_back((ended - submitted) * 1000.0);
+			phases[7].push_back((finished - ended) * 1000.0);
+			phases[8].push_back((finished - start) * 1000.0);
+			sprites = std::max(sprites, statistics.sprites);
+			drawCalls = std::max(drawCalls, statistics.drawCalls);
+		}
+	}
+	Application::Window.update();
+	std::cout << "Replayed " << trace.getFrames().size() << " frames "
+		<< passes << " times from " << argv[1] << " (at most " << sprites
+		<< " sprites and " << drawCalls << " draw calls per frame)"
+		<< std::endl;
+	std::cout << std::left << std::setw(12) << "phase (ms)" << std::right
+		<< std::setw(10) << "mean" << std::setw(10) << "min"
+		<< std::setw(10) << "median" << std::setw(10) << "p99"
+		<< std::setw(10) << "max" << std::endl;
+	for (unsigned int p = 0; p < 9; p++) {
+		PrintPhase(phaseNames[p], phases[p]);
+	}
+	replay.destroy();
+	Application::Graphics.destroy();
+	Application::Window.destroy();
+	Application::Log.destroy();
+	return EXIT_SUCCESS;
+}
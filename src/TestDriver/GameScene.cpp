@@ -37,6 +37,12 @@ void GameScene::die() {
 
 bool GameScene::initialize() {
 	ACTIASFW_LOG(GameScene, Info, "Initializing");
+	// Load the pause menu's textures before it is first opened
+	Application::Graphics.prefetchTextures({
+		"Assets/textures/game-highlight.png",
+		"Assets/textures/game-label.png",
+		"Assets/textures/game-button.png",
+		});
 	m_usernameUI.initialize(*this, 0,
 		"Assets/fonts/open-sans/OpenSans-regular.ttf", 0.15f,
 		glm::vec4(0.0f, 1.0f, 1.0f, 1.0f), CONTROLLER_UNKNOWN, "", glm::vec2());
@@ -90,6 +96,7 @@ bool GameScene::initialize() {
 	m_pauseUI.setInitialComponent(m_resumeButton);
 	m_pauseUI.setEnabled(false);
 	m_pauseUI.setVisible(false);
+	m_pauseUI.setCached(true);
 	m_dead = false;
 	return loadMap();
 }
@@ -102,8 +109,7 @@ void GameScene::enter(Scene& lastScene) {
 }
 
 void GameScene::draw() {
-	Application::Graphics.submit(m_floors);
-	Application::Graphics.submit(m_walls);
+	Application::Graphics.submit(m_map);
 	Application::Graphics.submit(m_coins);
 	Application::Graphics.submit(m_enemies);
 	Application::Graphics.submit(m_player);
@@ -139,10 +145,7 @@ void GameScene::UIEvent(unsigned int groupID, unsigned int componentID,
 		else if (componentID == m_restartButton.getID()) {
 			if (eventID == UIButton::ClickedEventID) {
 				Application::Audio.playEffect("Assets/audio/effects/click.wav");
-				for (Floor& floor : m_floors) {
-					floor.destroy();
-				}
-				m_floors.clear();
+				m_map.destroy();
 				for (Wall& wall : m_walls) {
 					wall.destroy();
 				}
@@ -230,10 +233,7 @@ void GameScene::leave(Scene& nextScene) {
 
 bool GameScene::destroy() {
 	ACTIASFW_LOG(GameScene, Info, "Destroying");
-	for (Floor& floor : m_floors) {
-		floor.destroy();
-	}
-	m_floors.clear();
+	m_map.destroy();
 	for (Wall& wall : m_walls) {
 		wall.destroy();
 	}
@@ -268,13 +268,23 @@ bool GameScene::loadMap() {
 		lines.push_back(line);
 	}
 	mapFile.close();
+	size_t columns = 0;
+	for (const std::string& l : lines) {
+		columns = std::max(columns, l.length());
+	}
+	if (!m_map.initialize(glm::ivec2((int)columns, (int)lines.size()),
+		glm::vec3(0.0f, 0.0f, 0.0f), glm::vec2(128.0f, 128.0f),
+		{ "Assets/textures/floor.png", "Assets/textures/wall.png", },
+		Application::Graphics.getDefaultShader())) {
+		return false;
+	}
 	for (size_t ly = 0; ly < lines.size(); ly++) {
 		for (size_t lx = 0; lx < lines[ly].length(); lx++) {
 			float ty = (float)(lines.size() - 1 - ly) * 128.0f;
 			float tx = (float)lx * 128.0f;
 			char tc = lines[ly][lx];
-			m_floors.push_back(Floor());
-			m_floors.back().initialize(glm::vec3(tx, ty, 0.0f));
+			glm::ivec2 cell((int)lx, (int)(lines.size() - 1 - ly));
+			m_map.setTile(cell, tc == '#' ? WallTile : FloorTile);
 			if (tc == '#') {
 				m_walls.push_back(Wall());
 				m_walls.back().initialize(glm::vec3(tx, ty, 0.1f));
@@ -90,7 +90,8 @@ bool OptionsScene::initialize() {
 	m_usernameBox.setNeighbourBelow(m_applyButton);
 	m_usernameBox.setNeighbourAbove(m_applyButton);
 	m_UI.addComponent(m_usernameBox);
-	return true;
+	m_UI.setCached(true);
+	return m_sparks.initialize();
 }
 
 void OptionsScene::enter(Scene& lastScene) {
@@ -117,17 +118,13 @@ void OptionsScene::enter(Scene& lastScene) {
 	Application::Graphics.getDefaultCamera().setPosition(glm::vec3(
 		(float)Application::Window.getDimensions().x / 2.0f,
 		(float)Application::Window.getDimensions().y / 2.0f, 0.0f));
-	for (Spark& s : m_sparks) {
-		s.destroy();
-	}
-	m_sparks.clear();
-	m_timer = 0.0f;
+	m_sparks.reset();
 	m_lastScene = &lastScene;
 }
 
 void OptionsScene::draw() {
 	m_UI.draw();
-	Application::Graphics.submit(m_sparks);
+	Application::Graphics.submit((ParticleSystem&)m_sparks);
 }
 
 bool OptionsScene::processInput() {
@@ -206,26 +203,7 @@ void OptionsScene::UIEvent(unsigned int groupID, unsigned int componentID,
 
 void OptionsScene::update(float timeStep) {
 	m_UI.update(timeStep);
-	for (Spark& s : m_sparks) {
-		s.update(timeStep);
-	}
-	m_timer += timeStep;
-	if (m_timer > (float)Application::Window
-		.getTargetUpdatesPerSecond() / 50.0f) {
-		m_sparks.push_back(Spark());
-		m_sparks.back().initialize();
-		m_timer = 0.0f;
-	}
-	std::vector<Spark>::iterator it = m_sparks.begin();
-	while (it != m_sparks.end()) {
-		if (!it->isAlive()) {
-			it->destroy();
-			it = m_sparks.erase(it);
-		}
-		else {
-			it++;
-		}
-	}
+	m_sparks.update(timeStep);
 }
 
 void OptionsScene::leave(Scene& nextScene) {
@@ -235,10 +213,6 @@ void OptionsScene::leave(Scene& nextScene) {
 bool OptionsScene::destroy() {
 	ACTIASFW_LOG(OptionsScene, Info, "Destroying");
 	m_UI.destroy();
-	for (Spark& s : m_sparks) {
-		s.destroy();
-	}
-	m_sparks.clear();
-	m_timer = 0.0f;
+	m_sparks.destroy();
 	return true;
 }
\ No newline at end of file
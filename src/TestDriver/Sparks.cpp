@@ -0,0 +1,36 @@
+/*
+File:		Sparks.cpp
+Author:		Keegan MacDonald (keeganm742@gmail.com)
+Created:	2024.09.18@22:03
+Purpose:	Implement functions found in the Sparks class of Sprites.h
+*/
+
+#include "Sprites.h"
+
+ParticleSystem::Simulation Sparks::SparkSimulation
+	= ParticleSystem::SIMULATION_CPU;
+
+bool Sparks::initialize() {
+	float ups = (float)Application::Window.getTargetUpdatesPerSecond();
+	if (!ParticleSystem::initialize(512, 0.0f, "Assets/textures/spark.png", 5,
+		Application::Graphics.getDefaultShader(), SparkSimulation)) {
+		return false;
+	}
+	ParticleEmitter emitter;
+	emitter.rate = 50.0f / ups;
+	emitter.lifeTime = glm::vec2(3.0f * ups, 3.0f * ups + 160.0f);
+	emitter.size = glm::vec2(5.0f, 11.0f);
+	emitter.minimumVelocity = glm::vec2(-1.5f, 4.0f);
+	emitter.maximumVelocity = glm::vec2(1.5f, 9.0f);
+	addEmitter(emitter);
+	setSwayTime(ups);
+	setSeed((std::uint32_t)rand() + 1);
+	reset();
+	return true;
+}
+
+void Sparks::reset() {
+	clear();
+	getEmitter(0).area = glm::vec4(0.0f, -10.0f,
+		(float)Application::Window.getDimensions().x - 10.0f, 0.0f);
+}
@@ -8,23 +8,249 @@ Purpose:	Implement functions found in the TestDriver class of TestDriver.h
 
 #include "TestDriver.h"
 
+#include <chrono>
+
 TitleScene TestDriver::Title;
 OptionsScene TestDriver::Options;
 GameScene TestDriver::Game;
 
+class BenchmarkSprite : public Sprite {
+public:
+	void expand() {
+		draw();
+	}
+
+	// The per-sprite expansion Sprite::draw used before QuadKernel, which
+	// rotates each corner separately and swaps texture coordinates to reflect
+	void expandPrevious() {
+		glm::vec3 bbl(m_position.x, m_position.y, m_position.z);
+		glm::vec3 bbr(m_position.x + m_dimensions.x, m_position.y,
+			m_position.z);
+		glm::vec3 btl(m_position.x, m_position.y + m_dimensions.y,
+			m_position.z);
+		glm::vec3 btr(m_position.x + m_dimensions.x,
+			m_position.y + m_dimensions.y, m_position.z);
+		if ((int)m_rotation % 360 != 0) {
+			bbl = rotatePrevious(bbl);
+			bbr = rotatePrevious(bbr);
+			btl = rotatePrevious(btl);
+			btr = rotatePrevious(btr);
+		}
+		glm::vec2 tbl(m_textureBox.x, m_textureBox.y + m_textureBox.w);
+		glm::vec2 tbr(m_textureBox.x + m_textureBox.z,
+			m_textureBox.y + m_textureBox.w);
+		glm::vec2 ttl(m_textureBox.x, m_textureBox.y);
+		glm::vec2 ttr(m_textureBox.x + m_textureBox.z, m_textureBox.y);
+		float mode = getDrawMode();
+		m_indices = { 0, 2, 1, 1, 2, 3, };
+		m_vertices = {
+			bbl.x, bbl.y, bbl.z,
+			tbl.x, tbl.y,
+			m_color.r, m_color.g, m_color.b, m_color.a,
+			mode,
+			bbr.x, bbr.y, bbr.z,
+			tbr.x, tbr.y,
+			m_color.r, m_color.g, m_color.b, m_color.a,
+			mode,
+			btl.x, btl.y, btl.z,
+			ttl.x, ttl.y,
+			m_color.r, m_color.g, m_color.b, m_color.a,
+			mode,
+			btr.x, btr.y, btr.z,
+			ttr.x, ttr.y,
+			m_color.r, m_color.g, m_color.b, m_color.a,
+			mode,
+		};
+		if (m_reflectedHorizontally) {
+			transposePrevious(3, 13);
+			transposePrevious(4, 14);
+			transposePrevious(23, 33);
+			transposePrevious(24, 34);
+		}
+		if (m_reflectedVertically) {
+			transposePrevious(3, 23);
+			transposePrevious(4, 24);
+			transposePrevious(13, 33);
+			transposePrevious(14, 34);
+		}
+	}
+
+private:
+	glm::vec3 rotatePrevious(const glm::vec3& p) const {
+		float a = (3.1415926f / 180.0f) * m_rotation;
+		glm::vec2 c = glm::vec2(m_position.x, m_position.y)
+			+ (m_dimensions / 2.0f);
+		float rx = cos(a) * (p.x - c.x) - sin(a) * (p.y - c.y) + c.x;
+		float ry = sin(a) * (p.x - c.x) + cos(a) * (p.y - c.y) + c.y;
+		return glm::vec3(rx, ry, p.z);
+	}
+
+	void transposePrevious(size_t a, size_t b) {
+		float v = m_vertices.at(a);
+		m_vertices[a] = m_vertices.at(b);
+		m_vertices[b] = v;
+	}
+};
+
+void BenchmarkQuads() {
+	const size_t spriteCount = 100000;
+	const unsigned int iterations = 50;
+	std::vector<BenchmarkSprite> sprites(spriteCount);
+	QuadBatch batch;
+	batch.reserve(spriteCount);
+	for (size_t i = 0; i < spriteCount; i++) {
+		BenchmarkSprite& sprite = sprites[i];
+		sprite.initialize(glm::vec3((float)(rand() % 4096),
+			(float)(rand() % 4096), 0.5f), glm::vec2(64.0f, 64.0f),
+			"Assets/textures/coin.png");
+		sprite.setRotation(i % 2 == 0 ? (float)(rand() % 3600) / 10.0f : 0.0f);
+		sprite.setReflectedHorizontally(i % 3 == 0);
+		sprite.setColor(glm::vec4(1.0f, 1.0f, 1.0f, 1.0f));
+		batch.add(sprite.getPosition(), sprite.getDimensions(),
+			sprite.getRotation(), sprite.getTextureBox(), sprite.getColor(),
+			0.0f, sprite.isReflectedHorizontally(),
+			sprite.isReflectedVertically());
+	}
+	std::chrono::steady_clock::time_point start
+		= std::chrono::steady_clock::now();
+	for (unsigned int i = 0; i < iterations; i++) {
+		for (BenchmarkSprite& sprite : sprites) {
+			sprite.expandPrevious();
+		}
+	}
+	std::chrono::duration<double> time
+		= std::chrono::steady_clock::now() - start;
+	std::cout << "Sprite::draw before QuadKernel: "
+		<< (spriteCount * iterations) / time.count() << " sprites per second"
+		<< std::endl;
+	start = std::chrono::steady_clock::now();
+	for (unsigned int i = 0; i < iterations; i++) {
+		for (BenchmarkSprite& sprite : sprites) {
+			sprite.expand();
+		}
+	}
+	time = std::chrono::steady_clock::now() - start;
+	std::cout << "Sprite::draw: " << (spriteCount * iterations) / time.count()
+		<< " sprites per second" << std::endl;
+	std::vector<float> vertices(spriteCount * QuadKernel::FloatsPerSprite);
+	const char* pathNames[] = { "scalar", "SSE", "AVX2", };
+	for (int p = QuadKernel::PATH_SCALAR; p <= QuadKernel::PATH_AVX2; p++) {
+		QuadKernel::Path path = (QuadKernel::Path)p;
+		if (!QuadKernel::IsSupported(path)) {
+			std::cout << "QuadKernel " << pathNames[p] << ": unsupported"
+				<< std::endl;
+			continue;
+		}
+		start = std::chrono::steady_clock::now();
+		for (unsigned int i = 0; i < iterations; i++) {
+			QuadKernel::Expand(batch, 0, spriteCount, vertices.data(), path);
+		}
+		time = std::chrono::steady_clock::now() - start;
+		std::cout << "QuadKernel " << pathNames[p] << ": "
+			<< (spriteCount * iterations) / time.count()
+			<< " sprites per second" << std::endl;
+	}
+}
+
+bool BenchmarkSprites() {
+	const size_t spriteCounts[] = { 10000, 50000, 100000, };
+	const unsigned int warmUpFrames = 10;
+	const unsigned int frames = 60;
+	Application::Configuration configuration(TestDriver::Title);
+	configuration.window.dimensions = glm::ivec2(960, 540);
+	configuration.window.headless = true;
+	if (!Application::Initialize(configuration)) {
+		std::cout << "Failed to initialize Actias application" << std::endl;
+		return false;
+	}
+	for (size_t spriteCount : spriteCounts) {
+		std::vector<Sprite> sprites(spriteCount);
+		for (Sprite& sprite : sprites) {
+			sprite.initialize(glm::vec3((float)(rand() % 960),
+				(float)(rand() % 540), (float)(rand() % 100) / 100.0f),
+				glm::vec2(16.0f, 16.0f), "Assets/textures/coin.png");
+		}
+		double submitTime = 0.0;
+		std::chrono::steady_clock::time_point start;
+		for (unsigned int i = 0; i < warmUpFrames + frames; i++) {
+			if (i == warmUpFrames) {
+				submitTime = 0.0;
+				start = std::chrono::steady_clock::now();
+			}
+			Application::Graphics.begin();
+			Application::Graphics.submit(sprites);
+			Application::Graphics.end();
+			// Wait for the frame to be drawn so that it is included in its
+			// time
+			glFinish();
+			submitTime += Application::Graphics.getFrameStatistics()
+				.submitTime;
+		}
+		std::chrono::duration<double, std::milli> time
+			= std::chrono::steady_clock::now() - start;
+		const GraphicsManager::FrameStatistics& statistics
+			= Application::Graphics.getFrameStatistics();
+		std::cout << spriteCount << " sprites: " << time.count() / frames
+			<< " ms per frame, " << submitTime / frames << " ms streaming, "
+			<< statistics.drawCalls << " draw calls" << std::endl;
+	}
+	return Application::Destroy();
+}
+
 int main(int argc, char** argv) {
 	srand((unsigned int)time(0));
+	if (argc > 1 && std::string(argv[1]) == "--benchmark-quads") {
+		BenchmarkQuads();
+		return EXIT_SUCCESS;
+	}
+	// Time frames of 10000, 50000, and 100000 sprites drawn offscreen
+	if (argc > 1 && std::string(argv[1]) == "--benchmark-sprites") {
+		return BenchmarkSprites() ? EXIT_SUCCESS : EXIT_FAILURE;
+	}
 	Application::Configuration configuration(TestDriver::Title);
 	configuration.window.dimensions = glm::ivec2(960, 540);
+	configuration.graphics.shaderCacheDirectory = "ShaderCache";
+	// Run a fixed number of frames offscreen, optionally saving them:
+	// --headless <frames> [frame dump directory]
+	// Record the frames submitted after startup to a trace for Replay:
+	// --capture <trace file> <frames>
+	// Simulate the title and options screens' sparks with compute shaders:
+	// --gpu-particles
+	std::string captureFileName = "";
+	unsigned int captureFrames = 0;
+	for (int a = 1; a < argc; a++) {
+		std::string argument = argv[a];
+		if (argument == "--headless" && a + 1 < argc) {
+			configuration.window.headless = true;
+			configuration.window.frameLimit = (unsigned int)atoi(argv[++a]);
+			if (a + 1 < argc && argv[a + 1][0] != '-') {
+				configuration.window.frameDumpDirectory = argv[++a];
+			}
+		}
+		else if (argument == "--capture" && a + 2 < argc) {
+			captureFileName = argv[++a];
+			captureFrames = (unsigned int)atoi(argv[++a]);
+		}
+		else if (argument == "--gpu-particles") {
+			Sparks::SparkSimulation = ParticleSystem::SIMULATION_GPU;
+		}
+	}
 	if (!Application::Initialize(configuration)) {
 		std::cout << "Failed to initialize Actias application" << std::endl;
 		return EXIT_FAILURE;
 	}
 	OptionsManager::Load();
-	Application::Window.setDimensions(OptionsManager::WindowDimensions);
-	Application::Window.setMonitor(OptionsManager::Monitor);
-	Application::Window.setFullscreen(OptionsManager::Fullscreen);
+	if (!configuration.window.headless) {
+		Application::Window.setDimensions(OptionsManager::WindowDimensions);
+		Application::Window.setMonitor(OptionsManager::Monitor);
+		Application::Window.setFullscreen(OptionsManager::Fullscreen);
+	}
 	Application::Audio.setEffectVolume(OptionsManager::EffectVolume);
+	static FrameTrace trace;
+	if (captureFrames > 0) {
+		trace.start(captureFileName, captureFrames);
+		Application::Graphics.setCapture(&trace);
+	}
 	Application::Run();
 	Application::Destroy();
 	return EXIT_SUCCESS;
@@ -10,6 +10,9 @@ Purpose:	Implement the functions found in the TitleScene class of
 
 bool TitleScene::initialize() {
 	ACTIASFW_LOG(TitleScene, Info, "Initializing");
+	// Draw the UI font sharply at every text scale from one small texture
+	Application::Graphics.setFontRendering(
+		"Assets/fonts/open-sans/OpenSans-Regular.ttf", Font::RENDERING_SDF);
 	m_UI.initialize(*this, 0, "Assets/fonts/open-sans/OpenSans-Regular.ttf",
 		0.5f, glm::vec4(1.0f, 1.0f, 1.0f, 1.0f), CONTROLLER_0,
 		"Assets/textures/title-highlight.png", glm::vec2(2.0f, 2.0f));
@@ -34,7 +37,7 @@ bool TitleScene::initialize() {
 	m_UI.addComponent(m_quitButton);
 	m_UI.setInitialComponent(m_startButton);
 	m_running = true;
-	return true;
+	return m_sparks.initialize();
 }
 
 void TitleScene::enter(Scene& lastScene) {
@@ -44,16 +47,12 @@ void TitleScene::enter(Scene& lastScene) {
 		(float)Application::Window.getDimensions().x / 2.0f,
 		(float)Application::Window.getDimensions().y / 2.0f, 0.0f));
 	Application::Graphics.getDefaultCamera().setScale(1.0f);
-	for (Spark& s : m_sparks) {
-		s.destroy();
-	}
-	m_sparks.clear();
-	m_timer = 0.0f;
+	m_sparks.reset();
 }
 
 void TitleScene::draw() {
 	m_UI.draw();
-	Application::Graphics.submit(m_sparks);
+	Application::Graphics.submit((ParticleSystem&)m_sparks);
 }
 
 bool TitleScene::processInput() {
@@ -87,26 +86,7 @@ void TitleScene::UIEvent(unsigned int groupID, unsigned int componentID,
 
 void TitleScene::update(float timeStep) {
 	m_UI.update(timeStep);
-	for (Spark& s : m_sparks) {
-		s.update(timeStep);
-	}
-	m_timer += timeStep;
-	if (m_timer > (float)Application::Window
-		.getTargetUpdatesPerSecond() / 50.0f) {
-		m_sparks.push_back(Spark());
-		m_sparks.back().initialize();
-		m_timer = 0.0f;
-	}
-	std::vector<Spark>::iterator it = m_sparks.begin();
-	while (it != m_sparks.end()) {
-		if (!it->isAlive()) {
-			it->destroy();
-			it = m_sparks.erase(it);
-		}
-		else {
-			it++;
-		}
-	}
+	m_sparks.update(timeStep);
 }
 
 void TitleScene::leave(Scene& nextScene) {
@@ -117,10 +97,6 @@ bool TitleScene::destroy() {
 	ACTIASFW_LOG(TitleScene, Info, "Destroying");
 	m_UI.destroy();
 	m_running = false;
-	for (Spark& s : m_sparks) {
-		s.destroy();
-	}
-	m_sparks.clear();
-	m_timer = 0.0f;
+	m_sparks.destroy();
 	return true;
 }
\ No newline at end of file